@@ -9,8 +9,10 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <errno.h>
 #include <fcntl.h>
+#include <float.h>
 #include <fstream>
 #include <iostream>
 #include <math.h>
@@ -28,6 +30,7 @@
 #endif //_WIN32
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/norm.hpp>
 #include <glm/gtx/vector_angle.hpp>
 
@@ -36,6 +39,7 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonValue>
+#include <QtCore/QRunnable>
 #include <QtCore/QThread>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
@@ -45,11 +49,13 @@
 #include <NodeList.h>
 #include <Node.h>
 #include <OctreeConstants.h>
+#include <OutboundPacket.h>
 #include <PacketHeaders.h>
 #include <SharedUtil.h>
 #include <StDev.h>
 #include <UUID.h>
 
+#include "AudioMixKernels.h"
 #include "AudioRingBuffer.h"
 #include "AudioMixerClientData.h"
 #include "AudioMixerDatagramProcessor.h"
@@ -61,9 +67,11 @@
 const float LOUDNESS_TO_DISTANCE_RATIO = 0.00001f;
 const float DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE = 0.18f;
 const float DEFAULT_NOISE_MUTING_THRESHOLD = 0.003f;
+const int STEREO_CHANNELS = 2;
 const QString AUDIO_MIXER_LOGGING_TARGET_NAME = "audio-mixer";
 const QString AUDIO_ENV_GROUP_KEY = "audio_env";
 const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
+const QString AUDIO_PERFORMANCE_GROUP_KEY = "audio_performance";
 
 InboundAudioStream::Settings AudioMixer::_streamSettings;
 
@@ -82,9 +90,20 @@ AudioMixer::AudioMixer(const QByteArray& packet) :
     _performanceThrottlingRatio(0.0f),
     _attenuationPerDoublingInDistance(DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE),
     _noiseMutingThreshold(DEFAULT_NOISE_MUTING_THRESHOLD),
+    _maxAudibleDistance(FLT_MAX),
     _numStatFrames(0),
     _sumListeners(0),
     _sumMixes(0),
+    _sumSourcesConsidered(0),
+    _numMixThreads(DEFAULT_NUM_MIX_THREADS),
+    _numReceiveSockets(DEFAULT_NUM_RECEIVE_SOCKETS),
+    _sharedMixPositionTolerance(0.0f),
+    _sharedMixOrientationTolerance(DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE_DEGREES),
+    _sumSharedMixListeners(0),
+    _compressMixedAudio(true),
+    _sumMixedAudioBytes(0),
+    _sumMixedAudioPCMBytes(0),
+    _sumBatchedDatagrams(0),
     _lastPerSecondCallbackTime(usecTimestampNow()),
     _sendAudioStreamStats(false),
     _datagramsReadPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
@@ -96,13 +115,40 @@ AudioMixer::AudioMixer(const QByteArray& packet) :
     // we will soon find a better common home for these audio-related constants
 }
 
+/// mixes listeners for the AudioMixer on a thread from its mix thread pool
+class AudioMixerWorker : public QRunnable {
+public:
+    AudioMixerWorker(AudioMixer& mixer, QAtomicInt& nextJobIndex) : _mixer(mixer), _nextJobIndex(nextJobIndex) {}
+
+    virtual void run() {
+        _mixer.processListenerMixJobs(_nextJobIndex);
+        _mixer._mixWorkersDone.release();
+    }
+
+private:
+    AudioMixer& _mixer;
+    QAtomicInt& _nextJobIndex;
+};
+
+/// the position bucket a listener falls in, only listeners in the same bucket are checked for a mix they can share
+struct SharedMixCell {
+    glm::ivec3 position;
+
+    bool operator==(const SharedMixCell& other) const { return position == other.position; }
+};
+
+inline uint qHash(const SharedMixCell& cell, uint seed = 0) {
+    return qHash(cell.position.x, seed) ^ qHash(cell.position.y, seed) * 31 ^ qHash(cell.position.z, seed) * 961;
+}
+
 const float ATTENUATION_BEGINS_AT_DISTANCE = 1.0f;
 const float RADIUS_OF_HEAD = 0.076f;
 
 int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
                                                          const QUuid& streamUUID,
                                                          PositionalAudioStream* streamToAdd,
-                                                         AvatarAudioStream* listeningNodeStream) {
+                                                         AvatarAudioStream* listeningNodeStream,
+                                                         float* preMixSamples, float* mixSamples) {
     // If repetition with fade is enabled:
     // If streamToAdd could not provide a frame (it was starved), then we'll mix its previously-mixed frame
     // This is preferable to not mixing it at all since that's equivalent to inserting silence.
@@ -156,8 +202,6 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         return 0;
     }
 
-    ++_sumMixes;
-
     if (streamToAdd->getType() == PositionalAudioStream::Injector) {
         attenuationCoefficient *= reinterpret_cast<InjectedAudioStream*>(streamToAdd)->getAttenuationRatio();
         if (showDebug) {
@@ -193,11 +237,15 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         attenuationCoefficient *= offAxisCoefficient;
     }
 
+    // this can run on several mix threads at once, so only touch the zone containers through const access
+    const QHash<QString, AABox>& audioZones = _audioZones;
+
     float attenuationPerDoublingInDistance = _attenuationPerDoublingInDistance;
     for (int i = 0; i < _zonesSettings.length(); ++i) {
-        if (_audioZones[_zonesSettings[i].source].contains(streamToAdd->getPosition()) &&
-            _audioZones[_zonesSettings[i].listener].contains(listeningNodeStream->getPosition())) {
-            attenuationPerDoublingInDistance = _zonesSettings[i].coefficient;
+        const ZonesSettings& zoneSettings = _zonesSettings.at(i);
+        if (audioZones[zoneSettings.source].contains(streamToAdd->getPosition()) &&
+            audioZones[zoneSettings.listener].contains(listeningNodeStream->getPosition())) {
+            attenuationPerDoublingInDistance = zoneSettings.coefficient;
             break;
         }
     }
@@ -252,6 +300,14 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
 
     AudioRingBuffer::ConstIterator streamPopOutput = streamToAdd->getLastPopOutput();
 
+    // the penumbra filter has to see this stream on its own, everything else goes straight onto the listener's bus
+    bool applyPenumbraFilter = !sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter();
+    float* streamMixSamples = mixSamples;
+    if (applyPenumbraFilter) {
+        memset(preMixSamples, 0, MIX_SAMPLES_CAPACITY * sizeof(float));
+        streamMixSamples = preMixSamples;
+    }
+
     if (!streamToAdd->isStereo()) {
         // this is a mono stream, which means it gets full attenuation and spatialization
 
@@ -303,56 +359,45 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
             leftDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
         }
 
+        // the ring buffer can wrap, so pull the historical samples for the delayed channel and the frame itself
+        // into one contiguous run that the mix kernels can stream through
+        // TODO: the historical samples may be inside the last frame written if the ringbuffer is completely full
+        // maybe make AudioRingBuffer have 1 extra frame in its buffer
+        int16_t sourceSamples[SAMPLE_PHASE_DELAY_AT_90 + AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+        (streamPopOutput - numSamplesDelay).readSamples(sourceSamples, numSamplesDelay + inputSampleCount);
+        const int16_t* frameSamples = sourceSamples + numSamplesDelay;
+
         // If there was a sample delay for this stream, we need to pull samples prior to the official start of the input
-        // and stick those samples at the beginning of the output. We only need to loop through this for the weak/delayed
+        // and stick those samples at the beginning of the output. We only need to do this for the weak/delayed
         // side, since the normal side is fully handled below. (item 4 above)
         if (numSamplesDelay > 0) {
-
-            // TODO: delayStreamSourceSamples may be inside the last frame written if the ringbuffer is completely full
-            // maybe make AudioRingBuffer have 1 extra frame in its buffer
-            AudioRingBuffer::ConstIterator delayStreamSourceSamples = streamPopOutput - numSamplesDelay;
-
-            for (int i = 0; i < numSamplesDelay; i++) {
-                int16_t originalHistoricalSample = *delayStreamSourceSamples;
-
-                _preMixSamples[delayedChannelHistoricalAudioOutputIndex] += originalHistoricalSample
-                                                                                 * attenuationAndWeakChannelRatioAndFade;
-                ++delayStreamSourceSamples; // move our input pointer
-                delayedChannelHistoricalAudioOutputIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE; // move our output sample
-            }
-        }
-
-        // Here's where we copy the MONO input to the STEREO output, and account for delay and weak side attenuation
-        for (int inputSample = 0; inputSample < inputSampleCount; inputSample++) {
-            int16_t originalSample = streamPopOutput[inputSample];
-            int16_t leftSideSample = originalSample * leftSideAttenuation;
-            int16_t rightSideSample = originalSample * rightSideAttenuation;
-
-            // since we might be delayed, don't write beyond our maxOutputIndex
-            if (leftDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[leftDestinationIndex] += leftSideSample;
-            }
-            if (rightDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[rightDestinationIndex] += rightSideSample;
-            }
-
-            leftDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-            rightDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
+            AudioMixKernels::accumulateMonoToStereoChannel(streamMixSamples + delayedChannelHistoricalAudioOutputIndex,
+                                                           sourceSamples, numSamplesDelay,
+                                                           attenuationAndWeakChannelRatioAndFade);
         }
 
+        // Here's where we copy the MONO input to the STEREO output, and account for delay and weak side attenuation.
+        // Since we might be delayed, don't write beyond our maxOutputIndex.
+        int leftSampleCount = std::min(inputSampleCount,
+                                       (maxOutputIndex - leftDestinationIndex) / OUTPUT_SAMPLES_PER_INPUT_SAMPLE + 1);
+        int rightSampleCount = std::min(inputSampleCount,
+                                        (maxOutputIndex - rightDestinationIndex) / OUTPUT_SAMPLES_PER_INPUT_SAMPLE + 1);
+
+        AudioMixKernels::accumulateMonoToStereoChannel(streamMixSamples + leftDestinationIndex, frameSamples,
+                                                       leftSampleCount, leftSideAttenuation);
+        AudioMixKernels::accumulateMonoToStereoChannel(streamMixSamples + rightDestinationIndex, frameSamples,
+                                                       rightSampleCount, rightSideAttenuation);
     } else {
-        int stereoDivider = streamToAdd->isStereo() ? 1 : 2;
+        float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
 
-       float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
+        int16_t sourceSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+        streamPopOutput.readSamples(sourceSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
 
-        for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-            _preMixSamples[s] = glm::clamp(_preMixSamples[s] + (int)(streamPopOutput[s / stereoDivider] * attenuationAndFade),
-                                            AudioConstants::MIN_SAMPLE_VALUE,
-                                           AudioConstants::MAX_SAMPLE_VALUE);
-        }
+        AudioMixKernels::accumulateWithGain(streamMixSamples, sourceSamples,
+                                            AudioConstants::NETWORK_FRAME_SAMPLES_STEREO, attenuationAndFade);
     }
 
-    if (!sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter()) {
+    if (applyPenumbraFilter) {
 
         const float TWO_OVER_PI = 2.0f / PI;
 
@@ -412,54 +457,142 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         // set the gain on both filter channels
         penumbraFilter.setParameters(0, 0, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainL, penumbraFilterSlope);
         penumbraFilter.setParameters(0, 1, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainR, penumbraFilterSlope);
-        penumbraFilter.render(_preMixSamples, _preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
-    }
+        penumbraFilter.render(preMixSamples, preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
 
-    // Actually mix the _preMixSamples into the _mixSamples here.
-    for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-        _mixSamples[s] = glm::clamp(_mixSamples[s] + _preMixSamples[s], AudioConstants::MIN_SAMPLE_VALUE,
-                                    AudioConstants::MAX_SAMPLE_VALUE);
+        // Actually mix the preMixSamples into the mixSamples here.
+        AudioMixKernels::accumulate(mixSamples, preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
     }
 
     return 1;
 }
 
-int AudioMixer::prepareMixForListeningNode(Node* node) {
+int AudioMixer::prepareMixForListeningNode(ListenerMixJob& job, float* preMixSamples, float* mixSamples,
+                                           QVector<int>& sourceIndices) {
+    Node* node = job.node.data();
     AvatarAudioStream* nodeAudioStream = static_cast<AudioMixerClientData*>(node->getLinkedData())->getAvatarAudioStream();
     AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
 
     // zero out the client mix for this node
-    memset(_preMixSamples, 0, sizeof(_preMixSamples));
-    memset(_mixSamples, 0, sizeof(_mixSamples));
+    memset(mixSamples, 0, MIX_SAMPLES_CAPACITY * sizeof(float));
+
+    // only look at the sources that are close enough for this node to hear
+    _mixSourceGrid.findAudibleSources(nodeAudioStream->getPosition(), sourceIndices);
+    job.sourcesConsidered = sourceIndices.size();
 
-    // loop through all other nodes that have sufficient audio to mix
     int streamsMixed = 0;
 
-    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& otherNode){
-        if (otherNode->getLinkedData()) {
-            AudioMixerClientData* otherNodeClientData = (AudioMixerClientData*) otherNode->getLinkedData();
+    foreach (int sourceIndex, sourceIndices) {
+        const AudioMixSource& source = _mixSources[sourceIndex];
 
-            // enumerate the ARBs attached to the otherNode and add all that should be added to mix
+        if (source.node != node || source.stream->shouldLoopbackForNode()) {
+            streamsMixed += addStreamToMixForListeningNodeWithStream(listenerNodeData, source.streamUUID,
+                                                                     source.stream, nodeAudioStream,
+                                                                     preMixSamples, mixSamples);
+        }
+    }
 
-            const QHash<QUuid, PositionalAudioStream*>& otherNodeAudioStreams = otherNodeClientData->getAudioStreams();
-            QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
-            for (i = otherNodeAudioStreams.constBegin(); i != otherNodeAudioStreams.constEnd(); i++) {
-                PositionalAudioStream* otherNodeStream = i.value();
-                QUuid streamUUID = i.key();
+    return streamsMixed;
+}
 
-                if (otherNodeStream->getType() == PositionalAudioStream::Microphone) {
-                    streamUUID = otherNode->getUUID();
-                }
+float AudioMixer::audibleRadiusForStream(const PositionalAudioStream* stream) const {
+    // silent frames are never mixed
+    if (stream->getLastPopOutputLoudness() == 0.0f) {
+        return 0.0f;
+    }
+
+    // past this distance the stream fails the audibility test in addStreamToMixForListeningNodeWithStream
+    float loudnessRadius = stream->getLastPopOutputTrailingLoudness() / _minAudibilityThreshold;
+
+    return std::min(loudnessRadius, _maxAudibleDistance);
+}
+
+void AudioMixer::processListenerMixJobs(QAtomicInt& nextJobIndex) {
+    // each worker gets its own per stream scratch space and mix bus, only the limited mix goes into the job
+    float preMixSamples[MIX_SAMPLES_CAPACITY];
+    float mixSamples[MIX_SAMPLES_CAPACITY];
+    QVector<int> sourceIndices;
+
+    int numJobs = (int) _listenerMixJobs.size();
+    int jobIndex;
+
+    while ((jobIndex = nextJobIndex.fetchAndAddRelaxed(1)) < numJobs) {
+        ListenerMixJob& job = _listenerMixJobs[jobIndex];
+
+        // listeners sharing another listener's mix are taken care of when it is sent
+        if (job.sharedMixJobIndex == -1) {
+            job.streamsMixed = prepareMixForListeningNode(job, preMixSamples, mixSamples, sourceIndices);
 
-                if (*otherNode != *node || otherNodeStream->shouldLoopbackForNode()) {
-                    streamsMixed += addStreamToMixForListeningNodeWithStream(listenerNodeData, streamUUID,
-                                                                             otherNodeStream, nodeAudioStream);
+            // limit and encode here too so that the send loop is left with nothing but copies
+            if (job.streamsMixed > 0) {
+                AudioMixKernels::limitToSamples(job.mixSamples, mixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+
+                job.encodedMixBytes = AudioCodec::encodeFrame(job.codecID, job.mixSamples,
+                                                              AudioConstants::NETWORK_FRAME_SAMPLES_STEREO,
+                                                              STEREO_CHANNELS, job.encodedMix);
+            }
+        }
+    }
+}
+
+void AudioMixer::assignSharedMixes() {
+    if (_sharedMixPositionTolerance <= 0.0f) {
+        return;
+    }
+
+    // the angle between two orientations is 2 * acos(|dot|), so this is the smallest dot within the tolerance
+    const float minOrientationDot = cosf(glm::radians(_sharedMixOrientationTolerance) / 2.0f);
+
+    // the jobs whose mixes are shared from each cell
+    QHash<SharedMixCell, QVector<int> > sharedMixJobs;
+
+    for (int i = 0; i < (int) _listenerMixJobs.size(); i++) {
+        ListenerMixJob& job = _listenerMixJobs[i];
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(job.node->getLinkedData());
+
+        if (job.canShareMix) {
+            AvatarAudioStream* listeningStream = nodeData->getAvatarAudioStream();
+            glm::quat orientation = listeningStream->getOrientation();
+
+            SharedMixCell cell;
+            cell.position = glm::ivec3(glm::floor(listeningStream->getPosition() / _sharedMixPositionTolerance));
+
+            QVector<int>& cellJobs = sharedMixJobs[cell];
+            foreach (int sharedMixJobIndex, cellJobs) {
+                AvatarAudioStream* sharedMixStream = static_cast<AudioMixerClientData*>(
+                    _listenerMixJobs[sharedMixJobIndex].node->getLinkedData())->getAvatarAudioStream();
+
+                if (fabsf(glm::dot(orientation, sharedMixStream->getOrientation())) >= minOrientationDot) {
+                    job.sharedMixJobIndex = sharedMixJobIndex;
+                    break;
                 }
             }
+
+            if (job.sharedMixJobIndex == -1) {
+                // nobody here faces the same way yet, this listener's mix is the one the rest will get
+                cellJobs.append(i);
+            }
         }
-    });
 
-    return streamsMixed;
+        nodeData->setIsSharingMix(job.sharedMixJobIndex != -1);
+    }
+}
+
+void AudioMixer::mixListeners() {
+    QAtomicInt nextJobIndex(0);
+
+    // don't wake up more workers than we have listeners for, this thread always takes a share of the jobs
+    int numWorkers = std::min(_numMixThreads, (int) _listenerMixJobs.size()) - 1;
+
+    for (int i = 0; i < numWorkers; i++) {
+        _mixThreadPool.start(new AudioMixerWorker(*this, nextJobIndex));
+    }
+
+    processListenerMixJobs(nextJobIndex);
+
+    // block until every worker has finished with the jobs it picked up
+    if (numWorkers > 0) {
+        _mixWorkersDone.acquire(numWorkers);
+    }
 }
 
 void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
@@ -503,11 +636,15 @@ void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
         }
     }
 
-    // Send at change or every so often
-    float CHANCE_OF_SEND = 0.01f;
-    bool sendData = dataChanged || (randFloat() < CHANCE_OF_SEND);
+    // Send at change, and now and then after that in case the packet with the change was lost
+    const int AUDIO_ENVIRONMENT_REFRESH_FRAMES = 5 * AudioConstants::SAMPLE_RATE
+        / AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    bool sendData = dataChanged
+        || nodeData->incrementFramesSinceAudioEnvironmentSent() >= AUDIO_ENVIRONMENT_REFRESH_FRAMES;
 
     if (sendData) {
+        nodeData->resetFramesSinceAudioEnvironmentSent();
+
         auto nodeList = DependencyManager::get<NodeList>();
         int numBytesEnvPacketHeader = nodeList->populatePacketHeader(clientEnvBuffer, PacketTypeAudioEnvironment);
         char* envDataAt = clientEnvBuffer + numBytesEnvPacketHeader;
@@ -569,17 +706,34 @@ void AudioMixer::sendStatsPacket() {
     statsObject["useDynamicJitterBuffers"] = _streamSettings._dynamicJitterBuffers;
     statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100.0f;
     statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
+    statsObject["mix_threads"] = _numMixThreads;
+    statsObject["receive_sockets"] = _numReceiveSockets;
+    statsObject["mix_kernels"] = AudioMixKernels::getInstructionSetName(AudioMixKernels::getInstructionSet());
 
     statsObject["average_listeners_per_frame"] = (float) _sumListeners / (float) _numStatFrames;
 
     if (_sumListeners > 0) {
         statsObject["average_mixes_per_listener"] = (float) _sumMixes / (float) _sumListeners;
+        statsObject["average_sources_considered_per_listener"] = (float) _sumSourcesConsidered / (float) _sumListeners;
+        statsObject["shared_mix_hit_rate"] = (float) _sumSharedMixListeners / (float) _sumListeners;
     } else {
         statsObject["average_mixes_per_listener"] = 0.0;
+        statsObject["average_sources_considered_per_listener"] = 0.0;
+        statsObject["shared_mix_hit_rate"] = 0.0;
     }
 
+    statsObject["mixed_audio_compression_ratio"] = (_sumMixedAudioBytes > 0)
+        ? (float) _sumMixedAudioPCMBytes / (float) _sumMixedAudioBytes : 1.0f;
+
+    statsObject["average_datagrams_batched_per_frame"] = (float) _sumBatchedDatagrams / (float) _numStatFrames;
+
     _sumListeners = 0;
     _sumMixes = 0;
+    _sumSourcesConsidered = 0;
+    _sumSharedMixListeners = 0;
+    _sumMixedAudioBytes = 0;
+    _sumMixedAudioPCMBytes = 0;
+    _sumBatchedDatagrams = 0;
     _numStatFrames = 0;
 
     QJsonObject readPendingDatagramStats;
@@ -708,12 +862,17 @@ void AudioMixer::run() {
     // check the settings object to see if we have anything we can parse out
     parseSettingsObject(settingsObject);
 
+    // the node socket can only be rebound to share its port from the thread that now owns it
+    if (_numReceiveSockets > 1) {
+        connect(nodeList.data(), &LimitedNodeList::sharedPortPacketReceived, this, &AudioMixer::readPendingDatagram);
+        QMetaObject::invokeMethod(datagramProcessor, "openSharedPortReceivers", Qt::BlockingQueuedConnection,
+                                  Q_ARG(int, _numReceiveSockets));
+    }
+
     int nextFrame = 0;
     QElapsedTimer timer;
     timer.start();
 
-    char clientMixBuffer[MAX_PACKET_SIZE];
-
     int usecToSleep = AudioConstants::NETWORK_FRAME_USECS;
 
     const int TRAILING_AVERAGE_FRAMES = 100;
@@ -778,6 +937,7 @@ void AudioMixer::run() {
             _lastPerSecondCallbackTime = now;
         }
 
+        // pop a frame from every stream before any listener is mixed, so that all mixes see the same frame
         nodeList->eachNode([&](const SharedNodePointer& node) {
 
             if (node->getLinkedData()) {
@@ -795,59 +955,114 @@ void AudioMixer::run() {
                     nodeList->writeDatagram(packet, node);
                 }
 
-                if (node->getType() == NodeType::Agent && node->getActiveSocket()
-                    && nodeData->getAvatarAudioStream()) {
+                _mixSourceNodes.append(node);
 
-                    int streamsMixed = prepareMixForListeningNode(node.data());
-
-                    char* mixDataAt;
-                    if (streamsMixed > 0) {
-                        // pack header
-                        int numBytesMixPacketHeader = nodeList->populatePacketHeader(clientMixBuffer, PacketTypeMixedAudio);
-                        mixDataAt = clientMixBuffer + numBytesMixPacketHeader;
-
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        memcpy(mixDataAt, &sequence, sizeof(quint16));
-                        mixDataAt  += sizeof(quint16);
-
-                        // pack mixed audio samples
-                        memcpy(mixDataAt, _mixSamples, AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                        mixDataAt += AudioConstants::NETWORK_FRAME_BYTES_STEREO;
-                    } else {
-                        // pack header
-                        int numBytesPacketHeader = nodeList->populatePacketHeader(clientMixBuffer, PacketTypeSilentAudioFrame);
-                        mixDataAt = clientMixBuffer + numBytesPacketHeader;
-
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        memcpy(mixDataAt, &sequence, sizeof(quint16));
-                        mixDataAt += sizeof(quint16);
-
-                        // pack number of silent audio samples
-                        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-                        memcpy(mixDataAt, &numSilentSamples, sizeof(quint16));
-                        mixDataAt += sizeof(quint16);
-                    }
+                bool hasAudibleStream = false;
 
-                    // Send audio environment
-                    sendAudioEnvironmentPacket(node);
+                const QHash<QUuid, PositionalAudioStream*>& audioStreams = nodeData->getAudioStreams();
+                QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
+                for (i = audioStreams.constBegin(); i != audioStreams.constEnd(); i++) {
+                    PositionalAudioStream* stream = i.value();
 
-                    // send mixed audio packet
-                    nodeList->writeDatagram(clientMixBuffer, mixDataAt - clientMixBuffer, node);
-                    nodeData->incrementOutgoingMixedAudioSequenceNumber();
+                    AudioMixSource source;
+                    source.stream = stream;
+                    source.streamUUID = (stream->getType() == PositionalAudioStream::Microphone) ? node->getUUID() : i.key();
+                    source.node = node.data();
+                    source.position = stream->getPosition();
+                    source.audibleRadius = audibleRadiusForStream(stream);
+                    _mixSources.push_back(source);
 
-                    // send an audio stream stats packet if it's time
-                    if (_sendAudioStreamStats) {
-                        nodeData->sendAudioStreamStatsPackets(node);
-                        _sendAudioStreamStats = false;
-                    }
+                    hasAudibleStream = hasAudibleStream || source.audibleRadius > 0.0f;
+                }
 
-                    ++_sumListeners;
+                if (node->getType() == NodeType::Agent && node->getActiveSocket()
+                    && nodeData->getAvatarAudioStream()) {
+                    _listenerMixJobs.emplace_back(node);
+                    _listenerMixJobs.back().canShareMix = !hasAudibleStream;
+                    _listenerMixJobs.back().codecID = _compressMixedAudio
+                        ? nodeData->getAvatarAudioStream()->getMixedAudioCodecID()
+                        : (quint8) AudioCodec::PCM;
                 }
             }
         });
 
+        _mixSourceGrid.rebuild(_mixSources);
+
+        assignSharedMixes();
+        mixListeners();
+
+        // send the mixes from this thread, in the same order they were gathered, and have the node list hold
+        // them back so that the whole frame goes out in as few system calls as possible
+        nodeList->beginDatagramBatch();
+
+        for (size_t i = 0; i < _listenerMixJobs.size(); i++) {
+            ListenerMixJob& job = _listenerMixJobs[i];
+            const SharedNodePointer& node = job.node;
+            AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
+
+            // the job that actually holds the mix for this listener
+            const ListenerMixJob& mixJob = (job.sharedMixJobIndex == -1) ? job : _listenerMixJobs[job.sharedMixJobIndex];
+
+            // a shared mix was encoded for the listener that owns it, re-encode it if this one asked for another codec
+            const char* encodedMix = mixJob.encodedMix;
+            int encodedMixBytes = mixJob.encodedMixBytes;
+            if (mixJob.streamsMixed > 0 && mixJob.codecID != job.codecID) {
+                job.encodedMixBytes = AudioCodec::encodeFrame(job.codecID, mixJob.mixSamples,
+                                                              AudioConstants::NETWORK_FRAME_SAMPLES_STEREO,
+                                                              STEREO_CHANNELS, job.encodedMix);
+                encodedMix = job.encodedMix;
+                encodedMixBytes = job.encodedMixBytes;
+            }
+
+            // the packet is built in a pooled buffer and goes out from there, the node list never copies it
+            OutboundPacket mixPacket(mixJob.streamsMixed > 0 ? PacketTypeMixedAudio : PacketTypeSilentAudioFrame,
+                                     nodeList->getSessionUUID());
+
+            // pack sequence number
+            quint16 sequence = nodeData->getOutgoingSequenceNumber();
+            mixPacket.append(reinterpret_cast<const char*>(&sequence), sizeof(quint16));
+
+            if (mixJob.streamsMixed > 0) {
+                // pack the encoded mix
+                mixPacket.append(encodedMix, encodedMixBytes);
+
+                _sumMixedAudioBytes += encodedMixBytes;
+                _sumMixedAudioPCMBytes += AudioConstants::NETWORK_FRAME_BYTES_STEREO;
+            } else {
+                // pack number of silent audio samples
+                quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+                mixPacket.append(reinterpret_cast<const char*>(&numSilentSamples), sizeof(quint16));
+            }
+
+            // Send audio environment
+            sendAudioEnvironmentPacket(node);
+
+            // send mixed audio packet
+            nodeList->writePacket(mixPacket, node);
+            nodeData->incrementOutgoingMixedAudioSequenceNumber();
+
+            // send an audio stream stats packet if it's time
+            if (_sendAudioStreamStats) {
+                nodeData->sendAudioStreamStatsPackets(node);
+                _sendAudioStreamStats = false;
+            }
+
+            if (job.sharedMixJobIndex == -1) {
+                _sumMixes += job.streamsMixed;
+                _sumSourcesConsidered += job.sourcesConsidered;
+            } else {
+                ++_sumSharedMixListeners;
+            }
+            ++_sumListeners;
+        }
+
+        _sumBatchedDatagrams += nodeList->flushDatagramBatch();
+
+        // let go of our references to the nodes, they could be killed before the next frame
+        _mixSourceNodes.clear();
+        _mixSources.clear();
+        _listenerMixJobs.clear();
+
         ++_numStatFrames;
 
         QCoreApplication::processEvents();
@@ -994,6 +1209,60 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
         }
     }
 
+    if (settingsObject.contains(AUDIO_PERFORMANCE_GROUP_KEY)) {
+        QJsonObject audioPerformanceGroupObject = settingsObject[AUDIO_PERFORMANCE_GROUP_KEY].toObject();
+
+        const QString NUM_MIX_THREADS_JSON_KEY = "num_mix_threads";
+        bool ok;
+        int numMixThreads = audioPerformanceGroupObject[NUM_MIX_THREADS_JSON_KEY].toString().toInt(&ok);
+        if (ok && numMixThreads > 0) {
+            _numMixThreads = numMixThreads;
+        }
+
+        const QString NUM_RECEIVE_SOCKETS_JSON_KEY = "num_receive_sockets";
+        int numReceiveSockets = audioPerformanceGroupObject[NUM_RECEIVE_SOCKETS_JSON_KEY].toString().toInt(&ok);
+        if (ok && numReceiveSockets > 0) {
+            _numReceiveSockets = numReceiveSockets;
+        }
+
+        const QString SOURCE_GRID_CELL_SIZE_JSON_KEY = "source_grid_cell_size";
+        float cellSize = audioPerformanceGroupObject[SOURCE_GRID_CELL_SIZE_JSON_KEY].toString().toFloat(&ok);
+        if (ok && cellSize >= 0.0f) {
+            _mixSourceGrid.setCellSize(cellSize);
+        }
+
+        const QString SHARED_MIX_POSITION_TOLERANCE_JSON_KEY = "shared_mix_position_tolerance";
+        float positionTolerance = audioPerformanceGroupObject[SHARED_MIX_POSITION_TOLERANCE_JSON_KEY].toString().toFloat(&ok);
+        if (ok && positionTolerance >= 0.0f) {
+            _sharedMixPositionTolerance = positionTolerance;
+        }
+
+        const QString SHARED_MIX_ORIENTATION_TOLERANCE_JSON_KEY = "shared_mix_orientation_tolerance";
+        float orientationTolerance =
+            audioPerformanceGroupObject[SHARED_MIX_ORIENTATION_TOLERANCE_JSON_KEY].toString().toFloat(&ok);
+        if (ok && orientationTolerance > 0.0f) {
+            _sharedMixOrientationTolerance = orientationTolerance;
+        }
+
+        const QString COMPRESS_MIXED_AUDIO_JSON_KEY = "compress_mixed_audio";
+        if (audioPerformanceGroupObject[COMPRESS_MIXED_AUDIO_JSON_KEY].isBool()) {
+            _compressMixedAudio = audioPerformanceGroupObject[COMPRESS_MIXED_AUDIO_JSON_KEY].toBool();
+        }
+    }
+
+    // the mixer thread always does a share of the mixing, so the pool only needs the extra threads
+    _mixThreadPool.setMaxThreadCount(std::max(_numMixThreads - 1, 1));
+    qDebug() << "Audio source grid cell size is" << _mixSourceGrid.getCellSize() << "meters";
+    if (_sharedMixPositionTolerance > 0.0f) {
+        qDebug() << "Silent listeners within" << _sharedMixPositionTolerance << "meters and"
+            << _sharedMixOrientationTolerance << "degrees of each other will share a mix";
+    }
+    if (!_compressMixedAudio) {
+        qDebug() << "Mixed audio will be sent uncompressed";
+    }
+    qDebug() << "Mixing listeners on" << _numMixThreads << "thread(s) with"
+        << AudioMixKernels::getInstructionSetName(AudioMixKernels::getInstructionSet()) << "mix kernels";
+
     if (settingsObject.contains(AUDIO_ENV_GROUP_KEY)) {
         QJsonObject audioEnvGroupObject = settingsObject[AUDIO_ENV_GROUP_KEY].toObject();
 
@@ -1132,6 +1401,18 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             }
         }
     }
-}
 
+    // past the distance where the gentlest attenuation we could apply reaches zero, nothing can be heard
+    float minAttenuationPerDoublingInDistance = _attenuationPerDoublingInDistance;
+    foreach (const ZonesSettings& zoneSettings, _zonesSettings) {
+        minAttenuationPerDoublingInDistance = std::min(minAttenuationPerDoublingInDistance, zoneSettings.coefficient);
+    }
+
+    if (minAttenuationPerDoublingInDistance > 0.0f) {
+        _maxAudibleDistance = ATTENUATION_BEGINS_AT_DISTANCE * powf(2.0f, 1.0f / minAttenuationPerDoublingInDistance);
+    } else {
+        _maxAudibleDistance = FLT_MAX;
+    }
+    qDebug() << "Max audible distance is" << _maxAudibleDistance << "meters";
+}
 
@@ -12,10 +12,19 @@
 #ifndef hifi_AudioMixer_h
 #define hifi_AudioMixer_h
 
+#include <vector>
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+
 #include <AABox.h>
+#include <AudioCodec.h>
 #include <AudioRingBuffer.h>
 #include <ThreadedAssignment.h>
 
+#include "AudioSourceGrid.h"
+
 class PositionalAudioStream;
 class AvatarAudioStream;
 class AudioMixerClientData;
@@ -24,6 +33,47 @@ const int SAMPLE_PHASE_DELAY_AT_90 = 20;
 
 const int READ_DATAGRAMS_STATS_WINDOW_SECONDS = 30;
 
+// large enough to handle the historical data from a phase delay as well as an entire network buffer,
+// the mix buses are this big so that the mix kernels never have to check where they are writing
+const int MIX_SAMPLES_CAPACITY = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2);
+
+// a mix frame encoded with any codec, which falls back to PCM when it can't do better
+const int MAX_ENCODED_MIX_BYTES = AudioCodec::FRAME_HEADER_BYTES + AudioConstants::NETWORK_FRAME_BYTES_STEREO;
+
+const int DEFAULT_NUM_MIX_THREADS = 1;
+const int DEFAULT_NUM_RECEIVE_SOCKETS = 1;
+
+const float DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE_DEGREES = 10.0f;
+
+/// the mix for a single listening node, produced by whichever mix worker picks up the job
+struct ListenerMixJob {
+    ListenerMixJob(const SharedNodePointer& listeningNode) :
+        node(listeningNode),
+        canShareMix(false),
+        sharedMixJobIndex(-1),
+        streamsMixed(0),
+        sourcesConsidered(0),
+        codecID(AudioCodec::PCM),
+        encodedMixBytes(0) {}
+
+    SharedNodePointer node;
+
+    // a listener whose own streams are silent hears exactly what a listener standing in the same spot would hear
+    bool canShareMix;
+    int sharedMixJobIndex; // when not -1, the job whose mix this listener is sent instead of getting its own
+
+    int streamsMixed;
+    int sourcesConsidered;
+
+    // the mix after it has been through the limiter
+    int16_t mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+    // the mix as it goes out to the listener, encoded with the codec it asked for
+    quint8 codecID;
+    int encodedMixBytes;
+    char encodedMix[MAX_ENCODED_MIX_BYTES];
+};
+
 /// Handles assignments of type AudioMixer - mixing streams of audio and re-distributing to various clients.
 class AudioMixer : public ThreadedAssignment {
     Q_OBJECT
@@ -43,25 +93,35 @@ public slots:
     static const InboundAudioStream::Settings& getStreamSettings() { return _streamSettings; }
 
 private:
+    friend class AudioMixerWorker;
+
     /// adds one stream to the mix for a listening node
     int addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
                                                     const QUuid& streamUUID,
                                                     PositionalAudioStream* streamToAdd,
-                                                    AvatarAudioStream* listeningNodeStream);
+                                                    AvatarAudioStream* listeningNodeStream,
+                                                    float* preMixSamples, float* mixSamples);
 
-    /// prepares and sends a mix to one Node
-    int prepareMixForListeningNode(Node* node);
+    /// prepares a mix for one Node on the mixSamples bus, using preMixSamples as per stream scratch space
+    /// and sourceIndices for the sources the source grid says it could hear
+    int prepareMixForListeningNode(ListenerMixJob& job, float* preMixSamples, float* mixSamples,
+                                   QVector<int>& sourceIndices);
 
-    /// Send Audio Environment packet for a single node
-    void sendAudioEnvironmentPacket(SharedNodePointer node);
+    /// how far away a listener can be from a stream and still have it mixed in this frame
+    float audibleRadiusForStream(const PositionalAudioStream* stream) const;
+
+    /// pulls listener mix jobs off of the current frame's list until there are none left
+    void processListenerMixJobs(QAtomicInt& nextJobIndex);
 
-    // used on a per stream basis to run the filter on before mixing, large enough to handle the historical
-    // data from a phase delay as well as an entire network buffer
-    int16_t _preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+    /// points listeners that are close enough to each other in position and orientation at one shared mix, and
+    /// tells each listener whether it is sharing one
+    void assignSharedMixes();
 
-    // client samples capacity is larger than what will be sent to optimize mixing
-    // we are MMX adding 4 samples at a time so we need client samples to have an extra 4
-    int16_t _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+    /// mixes every listener in _listenerMixJobs, spread across the mix thread pool if we have one
+    void mixListeners();
+
+    /// Send Audio Environment packet for a single node
+    void sendAudioEnvironmentPacket(SharedNodePointer node);
 
     void perSecondActions();
 
@@ -74,9 +134,39 @@ private:
     float _performanceThrottlingRatio;
     float _attenuationPerDoublingInDistance;
     float _noiseMutingThreshold;
+    float _maxAudibleDistance;
     int _numStatFrames;
     int _sumListeners;
     int _sumMixes;
+    int _sumSourcesConsidered;
+
+    // nodes with audio streams, their streams and the listeners to mix for, gathered once per frame after the pop phase
+    QVector<SharedNodePointer> _mixSourceNodes;
+    std::vector<AudioMixSource> _mixSources;
+    AudioSourceGrid _mixSourceGrid;
+    std::vector<ListenerMixJob> _listenerMixJobs;
+
+    int _numMixThreads;
+
+    // sockets sharing the mixer's port, each read on its own thread - one reads everything from the node socket
+    int _numReceiveSockets;
+
+    // listeners in the same position bucket share a mix when their orientations are within the tolerance in degrees,
+    // a position tolerance of zero turns shared mixes off
+    float _sharedMixPositionTolerance;
+    float _sharedMixOrientationTolerance;
+    int _sumSharedMixListeners;
+
+    // when false every listener is sent PCM mixes, whatever codec it asked for
+    bool _compressMixedAudio;
+    qint64 _sumMixedAudioBytes;
+    qint64 _sumMixedAudioPCMBytes;
+
+    // datagrams held back by the node list during each frame's send loop and sent together at the end of it
+    int _sumBatchedDatagrams;
+
+    QThreadPool _mixThreadPool;
+    QSemaphore _mixWorkersDone;
 
     QHash<QString, AABox> _audioZones;
     struct ZonesSettings {
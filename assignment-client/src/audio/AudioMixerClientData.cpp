@@ -24,6 +24,8 @@
 AudioMixerClientData::AudioMixerClientData() :
     _audioStreams(),
     _outgoingMixedAudioSequenceNumber(0),
+    _framesSinceAudioEnvironmentSent(0),
+    _isSharingMix(false),
     _downstreamAudioStreamStats()
 {
 }
@@ -330,3 +332,12 @@ PerListenerSourcePairData* AudioMixerClientData::getListenerSourcePairData(const
     }
     return _listenerSourcePairData[sourceUUID]; 
 }
+
+void AudioMixerClientData::setIsSharingMix(bool isSharingMix) {
+    if (_isSharingMix && !isSharingMix) {
+        foreach(PerListenerSourcePairData* pairData, _listenerSourcePairData) {
+            pairData->getPenumbraFilter().reset();
+        }
+    }
+    _isSharingMix = isSharingMix;
+}
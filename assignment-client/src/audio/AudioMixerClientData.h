@@ -55,9 +55,17 @@ public:
     void incrementOutgoingMixedAudioSequenceNumber() { _outgoingMixedAudioSequenceNumber++; }
     quint16 getOutgoingSequenceNumber() const { return _outgoingMixedAudioSequenceNumber; }
 
+    /// counts the frames this listener has gone without an audio environment packet, returns the new count
+    int incrementFramesSinceAudioEnvironmentSent() { return ++_framesSinceAudioEnvironmentSent; }
+    void resetFramesSinceAudioEnvironmentSent() { _framesSinceAudioEnvironmentSent = 0; }
+
     void printUpstreamDownstreamStats() const;
 
     PerListenerSourcePairData* getListenerSourcePairData(const QUuid& sourceUUID);
+
+    /// the penumbra filters don't run while this listener is sent another listener's mix, so their state is stale
+    /// and gets cleared when it goes back to a mix of its own
+    void setIsSharingMix(bool isSharingMix);
 private:
     void printAudioStreamStats(const AudioStreamStats& streamStats) const;
 
@@ -68,6 +76,8 @@ private:
     QHash<QUuid, PerListenerSourcePairData*> _listenerSourcePairData;
 
     quint16 _outgoingMixedAudioSequenceNumber;
+    int _framesSinceAudioEnvironmentSent;
+    bool _isSharingMix;
 
     AudioStreamStats _downstreamAudioStreamStats;
 };
@@ -45,3 +45,10 @@ void AudioMixerDatagramProcessor::readPendingDatagrams() {
         emit packetRequiresProcessing(incomingPacket, senderSockAddr);
     }
 }
+
+void AudioMixerDatagramProcessor::openSharedPortReceivers(int numReceiveSockets) {
+    // anything still queued on the node socket would be lost when it is rebound
+    readPendingDatagrams();
+
+    DependencyManager::get<NodeList>()->openSharedPortReceivers(numReceiveSockets);
+}
@@ -0,0 +1,121 @@
+//
+//  AudioSourceGrid.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include "AudioSourceGrid.h"
+
+// sources heard from further than this many cells away are cheaper to hand to every listener than to look up
+const int MAX_GRID_RADIUS_IN_CELLS = 2;
+
+// each cell coordinate gets 21 bits of the cell key
+const int CELL_KEY_AXIS_BITS = 21;
+const int CELL_KEY_AXIS_OFFSET = 1 << (CELL_KEY_AXIS_BITS - 1);
+const quint64 CELL_KEY_AXIS_MASK = (1 << CELL_KEY_AXIS_BITS) - 1;
+
+AudioSourceGrid::AudioSourceGrid() :
+    _cellSize(DEFAULT_AUDIO_SOURCE_GRID_CELL_SIZE),
+    _maxGridRadius(0.0f),
+    _sources(NULL)
+{
+}
+
+quint64 AudioSourceGrid::keyForCell(int x, int y, int z) const {
+    return (((quint64) (x + CELL_KEY_AXIS_OFFSET) & CELL_KEY_AXIS_MASK) << (CELL_KEY_AXIS_BITS * 2))
+        | (((quint64) (y + CELL_KEY_AXIS_OFFSET) & CELL_KEY_AXIS_MASK) << CELL_KEY_AXIS_BITS)
+        | ((quint64) (z + CELL_KEY_AXIS_OFFSET) & CELL_KEY_AXIS_MASK);
+}
+
+glm::ivec3 AudioSourceGrid::cellForPosition(const glm::vec3& position) const {
+    return glm::ivec3(glm::floor(position / _cellSize));
+}
+
+void AudioSourceGrid::rebuild(const std::vector<AudioMixSource>& sources) {
+    _sources = &sources;
+    _sortedSources.clear();
+    _cells.clear();
+    _wideSources.clear();
+    _maxGridRadius = 0.0f;
+
+    // a cell size of zero turns the grid off, every source is then handed to every listener
+    float maxGridRadius = _cellSize * MAX_GRID_RADIUS_IN_CELLS;
+
+    for (size_t i = 0; i < sources.size(); i++) {
+        const AudioMixSource& source = sources[i];
+
+        if (source.audibleRadius <= 0.0f) {
+            // nobody can hear this one
+            continue;
+        }
+
+        if (source.audibleRadius > maxGridRadius) {
+            _wideSources.append((int) i);
+        } else {
+            glm::ivec3 cell = cellForPosition(source.position);
+            _sortedSources.push_back(std::make_pair(keyForCell(cell.x, cell.y, cell.z), (int) i));
+            _maxGridRadius = std::max(_maxGridRadius, source.audibleRadius);
+        }
+    }
+
+    std::sort(_sortedSources.begin(), _sortedSources.end());
+
+    int cellBegin = 0;
+    for (int i = 1; i <= (int) _sortedSources.size(); i++) {
+        if (i == (int) _sortedSources.size() || _sortedSources[i].first != _sortedSources[cellBegin].first) {
+            CellRange range = { cellBegin, i };
+            _cells.insert(_sortedSources[cellBegin].first, range);
+            cellBegin = i;
+        }
+    }
+}
+
+void AudioSourceGrid::findAudibleSources(const glm::vec3& position, QVector<int>& sourceIndices) const {
+    sourceIndices.clear();
+
+    if (!_sources) {
+        return;
+    }
+
+    const std::vector<AudioMixSource>& sources = *_sources;
+
+    foreach (int sourceIndex, _wideSources) {
+        const AudioMixSource& source = sources[sourceIndex];
+        if (glm::distance(position, source.position) <= source.audibleRadius) {
+            sourceIndices.append(sourceIndex);
+        }
+    }
+
+    if (!_sortedSources.empty()) {
+        glm::ivec3 minCell = cellForPosition(position - glm::vec3(_maxGridRadius));
+        glm::ivec3 maxCell = cellForPosition(position + glm::vec3(_maxGridRadius));
+
+        for (int x = minCell.x; x <= maxCell.x; x++) {
+            for (int y = minCell.y; y <= maxCell.y; y++) {
+                for (int z = minCell.z; z <= maxCell.z; z++) {
+                    QHash<quint64, CellRange>::const_iterator cell = _cells.constFind(keyForCell(x, y, z));
+                    if (cell == _cells.constEnd()) {
+                        continue;
+                    }
+
+                    for (int i = cell->begin; i < cell->end; i++) {
+                        int sourceIndex = _sortedSources[i].second;
+                        const AudioMixSource& source = sources[sourceIndex];
+                        if (glm::distance(position, source.position) <= source.audibleRadius) {
+                            sourceIndices.append(sourceIndex);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // keep the mix order the same as it would be without the grid
+    std::sort(sourceIndices.begin(), sourceIndices.end());
+}
@@ -0,0 +1,73 @@
+//
+//  AudioSourceGrid.h
+//  assignment-client/src/audio
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSourceGrid_h
+#define hifi_AudioSourceGrid_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <QtCore/QHash>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+class Node;
+class PositionalAudioStream;
+
+/// a stream that has audio to mix this frame, along with how far away from it a listener can still hear it
+struct AudioMixSource {
+    PositionalAudioStream* stream;
+    QUuid streamUUID;
+    Node* node;
+    glm::vec3 position;
+    float audibleRadius;
+};
+
+const float DEFAULT_AUDIO_SOURCE_GRID_CELL_SIZE = 32.0f;
+
+/// Spatial hash of the frame's audio sources, rebuilt once per mix tick so that each listener only has to look at
+/// the sources in the cells around it. Sources that can be heard further away than a few cells skip the grid
+/// and are handed to every listener.
+class AudioSourceGrid {
+public:
+    AudioSourceGrid();
+
+    void setCellSize(float cellSize) { _cellSize = cellSize; }
+    float getCellSize() const { return _cellSize; }
+
+    void rebuild(const std::vector<AudioMixSource>& sources);
+
+    /// fills sourceIndices with the indices of the sources that could be heard from position, in the order they
+    /// were given to rebuild
+    void findAudibleSources(const glm::vec3& position, QVector<int>& sourceIndices) const;
+
+private:
+    struct CellRange {
+        int begin;
+        int end;
+    };
+
+    quint64 keyForCell(int x, int y, int z) const;
+    glm::ivec3 cellForPosition(const glm::vec3& position) const;
+
+    float _cellSize;
+    float _maxGridRadius;
+    const std::vector<AudioMixSource>* _sources;
+
+    // indices of the grid sources sorted by cell, each cell owns a contiguous range of them
+    std::vector<std::pair<quint64, int> > _sortedSources;
+    QHash<quint64, CellRange> _cells;
+
+    // sources heard too far away to be worth putting in the grid
+    QVector<int> _wideSources;
+};
+
+#endif // hifi_AudioSourceGrid_h
@@ -9,12 +9,17 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <AudioCodec.h>
 #include <PacketHeaders.h>
 
 #include "AvatarAudioStream.h"
 
+// the position and orientation PositionalAudioStream::parsePositionalData() reads
+const int NUM_BYTES_POSITIONAL_DATA = sizeof(glm::vec3) + sizeof(glm::quat);
+
 AvatarAudioStream::AvatarAudioStream(bool isStereo, const InboundAudioStream::Settings& settings) :
-    PositionalAudioStream(PositionalAudioStream::Microphone, isStereo, settings)
+    PositionalAudioStream(PositionalAudioStream::Microphone, isStereo, settings),
+    _mixedAudioCodecID(AudioCodec::PCM)
 {
 }
 
@@ -22,6 +27,11 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
     int readBytes = 0;
 
     if (type == PacketTypeSilentAudioFrame) {
+        // the sample count, the positional data and the codec all have to be there before we read any of them
+        if (packetAfterSeqNum.size() < (int)sizeof(quint16) + NUM_BYTES_POSITIONAL_DATA + (int)sizeof(quint8)) {
+            return -1;
+        }
+
         const char* dataAt = packetAfterSeqNum.constData();
         quint16 numSilentSamples = *(reinterpret_cast<const quint16*>(dataAt));
         readBytes += sizeof(quint16);
@@ -30,7 +40,16 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
         // read the positional data
         readBytes += parsePositionalData(packetAfterSeqNum.mid(readBytes));
 
+        // read the codec the client wants its mix in
+        _mixedAudioCodecID = packetAfterSeqNum.at(readBytes);
+        readBytes += sizeof(quint8);
+
     } else {
+        // the channel flag, the positional data and the codec all have to be there before we read any of them
+        if (packetAfterSeqNum.size() < (int)sizeof(quint8) + NUM_BYTES_POSITIONAL_DATA + (int)sizeof(quint8)) {
+            return -1;
+        }
+
         _shouldLoopbackForNode = (type == PacketTypeMicrophoneAudioWithEcho);
 
         // read the channel flag
@@ -49,9 +68,13 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
         // read the positional data
         readBytes += parsePositionalData(packetAfterSeqNum.mid(readBytes));
 
-        // calculate how many samples are in this packet
-        int numAudioBytes = packetAfterSeqNum.size() - readBytes;
-        numAudioSamples = numAudioBytes / sizeof(int16_t);
+        // read the codec the client wants its mix in
+        _mixedAudioCodecID = packetAfterSeqNum.at(readBytes);
+        readBytes += sizeof(quint8);
+
+        // the encoded frame that follows knows how many samples are in this packet
+        numAudioSamples = AudioCodec::samplesInFrame(packetAfterSeqNum.constData() + readBytes,
+                                                     packetAfterSeqNum.size() - readBytes);
     }
     
     return readBytes;
@@ -19,6 +19,9 @@
 class AvatarAudioStream : public PositionalAudioStream {
 public:
     AvatarAudioStream(bool isStereo, const InboundAudioStream::Settings& settings);
+
+    /// the codec this avatar's client wants its mixed audio encoded with
+    quint8 getMixedAudioCodecID() const { return _mixedAudioCodecID; }
     
 private:
     // disallow copying of AvatarAudioStream objects
@@ -26,6 +29,8 @@ private:
     AvatarAudioStream& operator= (const AvatarAudioStream&);
 
     int parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& numAudioSamples);
+
+    quint8 _mixedAudioCodecID;
 };
 
 #endif // hifi_AvatarAudioStream_h
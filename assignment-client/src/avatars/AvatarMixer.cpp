@@ -59,6 +59,21 @@ AvatarMixer::~AvatarMixer() {
 
 const float BILLBOARD_AND_IDENTITY_SEND_PROBABILITY = 1.0f / 300.0f;
 
+/// builds broadcast packets for the AvatarMixer on a thread from its broadcast thread pool
+class AvatarMixerWorker : public QRunnable {
+public:
+    AvatarMixerWorker(AvatarMixer& mixer, QAtomicInt& nextJobIndex) : _mixer(mixer), _nextJobIndex(nextJobIndex) {}
+
+    virtual void run() {
+        _mixer.processBroadcastJobs(_nextJobIndex);
+        _mixer._broadcastWorkersDone.release();
+    }
+
+private:
+    AvatarMixer& _mixer;
+    QAtomicInt& _nextJobIndex;
+};
+
 // NOTE: some additional optimizations to consider.
 //    1) use the view frustum to cull those avatars that are out of view. Since avatar data doesn't need to be present
 //       if the avatar is not in view or in the keyhole.
@@ -120,247 +135,321 @@ void AvatarMixer::broadcastAvatarData() {
         ++framesSinceCutoffEvent;
     }
     
-    static QByteArray mixedAvatarByteArray;
-    
     auto nodeList = DependencyManager::get<NodeList>();
-    int numPacketHeaderBytes = nodeList->populatePacketHeader(mixedAvatarByteArray, PacketTypeBulkAvatarData);
-     
-    // setup for distributed random floating point values 
-    std::random_device randomDevice;
-    std::mt19937 generator(randomDevice());
-    std::uniform_real_distribution<float> distribution;
-    
+
+    takeAvatarSnapshots();
+
+    // build the packets for every listener, spread across the broadcast thread pool if we have one
+    QAtomicInt nextJobIndex(0);
+
+    // don't wake up more workers than we have listeners for, this thread always takes a share of the jobs
+    int numWorkers = std::min(_numBroadcastThreads, (int) _broadcastJobs.size()) - 1;
+
+    for (int i = 0; i < numWorkers; i++) {
+        _broadcastThreadPool.start(new AvatarMixerWorker(*this, nextJobIndex));
+    }
+
+    processBroadcastJobs(nextJobIndex);
+
+    // block until every worker has finished with the jobs it picked up
+    if (numWorkers > 0) {
+        _broadcastWorkersDone.acquire(numWorkers);
+    }
+
+    // send the packets from this thread, in the same order the listeners were found
+    nodeList->beginDatagramBatch();
+
+    for (size_t i = 0; i < _broadcastJobs.size(); i++) {
+        const AvatarBroadcastJob& job = _broadcastJobs[i];
+        const SharedNodePointer& node = _avatarSnapshots[job.snapshotIndex].node;
+
+        foreach (const QByteArray& packet, job.packets) {
+            nodeList->writeDatagram(packet, node);
+        }
+
+        foreach (int snapshotIndex, job.outOfOrderSnapshotIndices) {
+            AvatarMixerClientData* otherNodeData = _avatarSnapshots[snapshotIndex].nodeData;
+            QMutexLocker otherNodeDataLocker(&otherNodeData->getMutex());
+            otherNodeData->incrementNumOutOfOrderSends();
+        }
+
+        ++_sumListeners;
+        _sumBillboardPackets += job.numBillboardPackets;
+        _sumIdentityPackets += job.numIdentityPackets;
+    }
+
+    nodeList->flushDatagramBatch();
+
+    // let go of our references to the nodes, they could be killed before the next frame
+    _broadcastJobs.clear();
+    _avatarSnapshots.clear();
+
+    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+}
+
+void AvatarMixer::takeAvatarSnapshots() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    _bulkAvatarDataPacketHeader = nodeList->byteArrayWithPopulatedHeader(PacketTypeBulkAvatarData);
+
     nodeList->eachMatchingNode(
         [&](const SharedNodePointer& node)->bool {
-            if (!node->getLinkedData()) {
-                return false;
-            }
-            if (node->getType() != NodeType::Agent) {
-                return false;
-            }
-            if (!node->getActiveSocket()) {
-                return false;
-            }
-            return true;
+            return node->getLinkedData() != NULL;
         },
         [&](const SharedNodePointer& node) {
             AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
-            MutexTryLocker lock(nodeData->getMutex());
-            if (!lock.isLocked()) {
-                return;
+
+            AvatarSnapshot snapshot;
+            snapshot.node = node;
+            snapshot.nodeData = nodeData;
+            snapshot.isListener = node->getType() == NodeType::Agent && node->getActiveSocket();
+            snapshot.sequenceNumber = node->getLastSequenceNumberForPacketType(PacketTypeAvatarData);
+
+            {
+                // this is the only place the broadcast looks at the avatar itself, so it is worth waiting for
+                QMutexLocker nodeDataLocker(&nodeData->getMutex());
+                AvatarData& avatar = nodeData->getAvatar();
+
+                snapshot.position = avatar.getPosition();
+                snapshot.billboardChangeTimestamp = nodeData->getBillboardChangeTimestamp();
+                snapshot.identityChangeTimestamp = nodeData->getIdentityChangeTimestamp();
+
+                snapshot.avatarData = node->getUUID().toRfc4122();
+                snapshot.avatarData.append(avatar.toByteArray());
+
+                if (!avatar.wasKeyframeSentLast()) {
+                    snapshot.avatarKeyframe = node->getUUID().toRfc4122();
+                    snapshot.avatarKeyframe.append(avatar.getSentKeyframe());
+                }
+                snapshot.keyframeID = avatar.getSentKeyframeID();
+
+                // the packets are cached with the node data, so this only shares them unless they just changed
+                if (snapshot.billboardChangeTimestamp > 0) {
+                    snapshot.billboardPacket = nodeData->getBillboardPacket(node->getUUID());
+                }
+                if (snapshot.identityChangeTimestamp > 0) {
+                    snapshot.identityPacket = nodeData->getIdentityPacket(node->getUUID());
+                }
             }
-            ++_sumListeners;
-            
-            // reset packet pointers for this node
-            mixedAvatarByteArray.resize(numPacketHeaderBytes);
 
-            AvatarData& avatar = nodeData->getAvatar();
-            glm::vec3 myPosition = avatar.getPosition();
+            if (snapshot.isListener) {
+                _broadcastJobs.push_back(AvatarBroadcastJob(_avatarSnapshots.size()));
+            }
+            _avatarSnapshots.push_back(snapshot);
+        }
+    );
+}
 
-            // reset the internal state for correct random number distribution
-            distribution.reset();
-            
-            // reset the max distance for this frame
-            float maxAvatarDistanceThisFrame = 0.0f;
-            
-            // reset the number of sent avatars
-            nodeData->resetNumAvatarsSentLastFrame();
+void AvatarMixer::processBroadcastJobs(QAtomicInt& nextJobIndex) {
+    // setup for distributed random floating point values
+    std::random_device randomDevice;
+    std::mt19937 generator(randomDevice());
 
-            // keep a counter of the number of considered avatars
-            int numOtherAvatars = 0;
-            
-            // keep track of outbound data rate specifically for avatar data
-            int numAvatarDataBytes = 0;
+    int numJobs = (int) _broadcastJobs.size();
+    int jobIndex;
 
-            // keep track of the number of other avatars held back in this frame
-            int numAvatarsHeldBack = 0;
+    while ((jobIndex = nextJobIndex.fetchAndAddRelaxed(1)) < numJobs) {
+        prepareBroadcastForListener(_broadcastJobs[jobIndex], generator);
+    }
+}
 
-            // keep track of the number of other avatar frames skipped
-            int numAvatarsWithSkippedFrames = 0;
+void AvatarMixer::prepareBroadcastForListener(AvatarBroadcastJob& job, std::mt19937& generator) {
+    const AvatarSnapshot& listener = _avatarSnapshots[job.snapshotIndex];
+    AvatarMixerClientData* nodeData = listener.nodeData;
 
-            // use the data rate specifically for avatar data for FRD adjustment checks
-            float avatarDataRateLastSecond = nodeData->getOutboundAvatarDataKbps();
+    // the rest of this listener's state is only ever touched by the job building its packets
+    QMutexLocker nodeDataLocker(&nodeData->getMutex());
 
-            // Check if it is time to adjust what we send this client based on the observed
-            // bandwidth to this node. We do this once a second, which is also the window for
-            // the bandwidth reported by node->getOutboundBandwidth();
-            if (nodeData->getNumFramesSinceFRDAdjustment() > AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) {
-                
-                const float FRD_ADJUSTMENT_ACCEPTABLE_RATIO = 0.8f;
-                const float HYSTERISIS_GAP = (1 - FRD_ADJUSTMENT_ACCEPTABLE_RATIO);
-                const float HYSTERISIS_MIDDLE_PERCENTAGE =  (1 - (HYSTERISIS_GAP * 0.5f));
+    QByteArray mixedAvatarByteArray = _bulkAvatarDataPacketHeader;
 
-                // get the current full rate distance so we can work with it
-                float currentFullRateDistance = nodeData->getFullRateDistance();
+    glm::vec3 myPosition = listener.position;
 
-                if (avatarDataRateLastSecond > _maxKbpsPerNode) {
+    std::uniform_real_distribution<float> distribution;
 
-                    // is the FRD greater than the farthest avatar? 
-                    // if so, before we calculate anything, set it to that distance
-                    currentFullRateDistance = std::min(currentFullRateDistance, nodeData->getMaxAvatarDistance());
+    // reset the max distance for this frame
+    float maxAvatarDistanceThisFrame = 0.0f;
 
-                    // we're adjusting the full rate distance to target a bandwidth in the middle
-                    // of the hysterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond; 
-                    
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                } else if (currentFullRateDistance < nodeData->getMaxAvatarDistance() 
-                           && avatarDataRateLastSecond < _maxKbpsPerNode * FRD_ADJUSTMENT_ACCEPTABLE_RATIO) {
-                    // we are constrained AND we've recovered to below the acceptable ratio 
-                    // lets adjust the full rate distance to target a bandwidth in the middle of the hyterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
-                     
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                }
-            } else {
-                nodeData->incrementNumFramesSinceFRDAdjustment();
-            }
+    // reset the number of sent avatars
+    nodeData->resetNumAvatarsSentLastFrame();
 
-            // this is an AGENT we have received head data from
-            // send back a packet with other active node data to this node
-            nodeList->eachMatchingNode(
-                [&](const SharedNodePointer& otherNode)->bool {
-                    if (!otherNode->getLinkedData()) {
-                        return false;
-                    }
-                    if (otherNode->getUUID() == node->getUUID()) {
-                        return false;
-                    }
+    // keep a counter of the number of considered avatars
+    int numOtherAvatars = 0;
 
-                    return true;
-                },
-                [&](const SharedNodePointer& otherNode) {
-                    ++numOtherAvatars;
-                    
-                    AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-                    MutexTryLocker lock(otherNodeData->getMutex());
-                    if (!lock.isLocked()) {
-                        return;
-                    }
-                    
-                    AvatarData& otherAvatar = otherNodeData->getAvatar();
-                    //  Decide whether to send this avatar's data based on it's distance from us
-                    
-                    //  The full rate distance is the distance at which EVERY update will be sent for this avatar
-                    //  at twice the full rate distance, there will be a 50% chance of sending this avatar's update
-                    glm::vec3 otherPosition = otherAvatar.getPosition();
-                    float distanceToAvatar = glm::length(myPosition - otherPosition);
+    // keep track of outbound data rate specifically for avatar data
+    int numAvatarDataBytes = 0;
 
-                    // potentially update the max full rate distance for this frame
-                    maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
+    // keep track of the number of other avatars held back in this frame
+    int numAvatarsHeldBack = 0;
 
-                    if (distanceToAvatar != 0.0f 
-                        && distribution(generator) > (nodeData->getFullRateDistance() / distanceToAvatar)) {
-                        return;
-                    }
+    // keep track of the number of other avatar frames skipped
+    int numAvatarsWithSkippedFrames = 0;
 
-                    PacketSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherNode->getUUID());
-                    PacketSequenceNumber lastSeqFromSender = otherNode->getLastSequenceNumberForPacketType(PacketTypeAvatarData);
+    // use the data rate specifically for avatar data for FRD adjustment checks
+    float avatarDataRateLastSecond = nodeData->getOutboundAvatarDataKbps();
 
-                    if (lastSeqToReceiver > lastSeqFromSender) {
-                        // Did we somehow get out of order packets from the sender?
-                        // We don't expect this to happen - in RELEASE we add this to a trackable stat
-                        // and in DEBUG we crash on the assert
-                        
-                        otherNodeData->incrementNumOutOfOrderSends();
+    // Check if it is time to adjust what we send this client based on the observed
+    // bandwidth to this node. We do this once a second, which is also the window for
+    // the bandwidth reported by node->getOutboundBandwidth();
+    if (nodeData->getNumFramesSinceFRDAdjustment() > AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) {
 
-                        assert(false);
-                    }
-                    
-                    // make sure we haven't already sent this data from this sender to this receiver
-                    // or that somehow we haven't sent
-                    if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
-                        ++numAvatarsHeldBack;
-                        return;
-                    } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
-                        // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
-                        ++numAvatarsWithSkippedFrames;
-                    } 
-                    
-                    // we're going to send this avatar
-                    
-                    // increment the number of avatars sent to this reciever
-                    nodeData->incrementNumAvatarsSentLastFrame();
-                    
-                    // set the last sent sequence number for this sender on the receiver
-                    nodeData->setLastBroadcastSequenceNumber(otherNode->getUUID(), 
-                        otherNode->getLastSequenceNumberForPacketType(PacketTypeAvatarData));
+        const float FRD_ADJUSTMENT_ACCEPTABLE_RATIO = 0.8f;
+        const float HYSTERISIS_GAP = (1 - FRD_ADJUSTMENT_ACCEPTABLE_RATIO);
+        const float HYSTERISIS_MIDDLE_PERCENTAGE =  (1 - (HYSTERISIS_GAP * 0.5f));
 
-                    QByteArray avatarByteArray;
-                    avatarByteArray.append(otherNode->getUUID().toRfc4122());
-                    avatarByteArray.append(otherAvatar.toByteArray());
-                    
-                    if (avatarByteArray.size() + mixedAvatarByteArray.size() > MAX_PACKET_SIZE) {
-                        nodeList->writeDatagram(mixedAvatarByteArray, node);
+        // get the current full rate distance so we can work with it
+        float currentFullRateDistance = nodeData->getFullRateDistance();
 
-                        numAvatarDataBytes += mixedAvatarByteArray.size();
-                            
-                        // reset the packet
-                        mixedAvatarByteArray.resize(numPacketHeaderBytes);
-                    }
-                        
-                    // copy the avatar into the mixedAvatarByteArray packet
-                    mixedAvatarByteArray.append(avatarByteArray);
-                        
-                    // if the receiving avatar has just connected make sure we send out the mesh and billboard
-                    // for this avatar (assuming they exist)
-                    bool forceSend = !nodeData->checkAndSetHasReceivedFirstPackets();
-                        
-                    // we will also force a send of billboard or identity packet
-                    // if either has changed in the last frame
-                        
-                    if (otherNodeData->getBillboardChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getBillboardChangeTimestamp() > _lastFrameTimestamp
-                            || randFloat() < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
-                        QByteArray billboardPacket = nodeList->byteArrayWithPopulatedHeader(PacketTypeAvatarBillboard);
-                        billboardPacket.append(otherNode->getUUID().toRfc4122());
-                        billboardPacket.append(otherNodeData->getAvatar().getBillboard());
-
-                        nodeList->writeDatagram(billboardPacket, node);
-                            
-                        ++_sumBillboardPackets;
-                    }
-                        
-                    if (otherNodeData->getIdentityChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getIdentityChangeTimestamp() > _lastFrameTimestamp
-                            || randFloat() < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
-                                
-                        QByteArray identityPacket = nodeList->byteArrayWithPopulatedHeader(PacketTypeAvatarIdentity);
-                            
-                        QByteArray individualData = otherNodeData->getAvatar().identityByteArray();
-                        individualData.replace(0, NUM_BYTES_RFC4122_UUID, otherNode->getUUID().toRfc4122());
-                        identityPacket.append(individualData);
-                        
-                        nodeList->writeDatagram(identityPacket, node);
-                                
-                        ++_sumIdentityPackets;
-                    }
-            });
-            
-            // send the last packet
-            nodeList->writeDatagram(mixedAvatarByteArray, node);
-            
-            // record the bytes sent for other avatar data in the AvatarMixerClientData
-            nodeData->recordSentAvatarData(numAvatarDataBytes + mixedAvatarByteArray.size());
-            
-            // record the number of avatars held back this frame
-            nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
-            nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
-
-            if (numOtherAvatars == 0) {
-                // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
-                nodeData->setMaxAvatarDistance(FLT_MAX);
-            } else {
-                nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
-            }
+        if (avatarDataRateLastSecond > _maxKbpsPerNode) {
+
+            // is the FRD greater than the farthest avatar?
+            // if so, before we calculate anything, set it to that distance
+            currentFullRateDistance = std::min(currentFullRateDistance, nodeData->getMaxAvatarDistance());
+
+            // we're adjusting the full rate distance to target a bandwidth in the middle
+            // of the hysterisis gap
+            currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+
+            nodeData->setFullRateDistance(currentFullRateDistance);
+            nodeData->resetNumFramesSinceFRDAdjustment();
+        } else if (currentFullRateDistance < nodeData->getMaxAvatarDistance()
+                   && avatarDataRateLastSecond < _maxKbpsPerNode * FRD_ADJUSTMENT_ACCEPTABLE_RATIO) {
+            // we are constrained AND we've recovered to below the acceptable ratio
+            // lets adjust the full rate distance to target a bandwidth in the middle of the hyterisis gap
+            currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+
+            nodeData->setFullRateDistance(currentFullRateDistance);
+            nodeData->resetNumFramesSinceFRDAdjustment();
         }
-    );
-    
-    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+    } else {
+        nodeData->incrementNumFramesSinceFRDAdjustment();
+    }
+
+    // if the receiving avatar has just connected make sure we send out the mesh and billboard
+    // for every avatar we send it this frame (assuming they exist)
+    bool hasCheckedFirstPackets = false;
+    bool forceSend = false;
+
+    // this is an AGENT we have received head data from
+    // send back a packet with other active node data to this node
+    for (int otherIndex = 0; otherIndex < (int) _avatarSnapshots.size(); otherIndex++) {
+        if (otherIndex == job.snapshotIndex) {
+            continue;
+        }
+
+        const AvatarSnapshot& other = _avatarSnapshots[otherIndex];
+        const QUuid& otherUUID = other.node->getUUID();
+
+        ++numOtherAvatars;
+
+        //  Decide whether to send this avatar's data based on it's distance from us
+
+        //  The full rate distance is the distance at which EVERY update will be sent for this avatar
+        //  at twice the full rate distance, there will be a 50% chance of sending this avatar's update
+        float distanceToAvatar = glm::length(myPosition - other.position);
+
+        // potentially update the max full rate distance for this frame
+        maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
+
+        if (distanceToAvatar != 0.0f
+            && distribution(generator) > (nodeData->getFullRateDistance() / distanceToAvatar)) {
+            continue;
+        }
+
+        PacketSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherUUID);
+        PacketSequenceNumber lastSeqFromSender = other.sequenceNumber;
+
+        if (lastSeqToReceiver > lastSeqFromSender) {
+            // Did we somehow get out of order packets from the sender?
+            // We don't expect this to happen - in RELEASE we add this to a trackable stat
+            // and in DEBUG we crash on the assert
+
+            job.outOfOrderSnapshotIndices.append(otherIndex);
+
+            assert(false);
+        }
+
+        // make sure we haven't already sent this data from this sender to this receiver
+        // or that somehow we haven't sent
+        if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
+            ++numAvatarsHeldBack;
+            continue;
+        } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
+            // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
+            ++numAvatarsWithSkippedFrames;
+        }
+
+        // we're going to send this avatar
+
+        // increment the number of avatars sent to this reciever
+        nodeData->incrementNumAvatarsSentLastFrame();
+
+        // set the last sent sequence number for this sender on the receiver
+        nodeData->setLastBroadcastSequenceNumber(otherUUID, lastSeqFromSender);
+
+        // a delta is only any use to a receiver that was sent the keyframe it was taken against, so a receiver that
+        // wasn't gets the keyframe and then the delta, in the same packet so that they are parsed in that order
+        bool needsKeyframe = nodeData->getLastSentKeyframeID(otherUUID) != other.keyframeID;
+        int otherAvatarDataSize = other.avatarData.size();
+        if (needsKeyframe) {
+            otherAvatarDataSize += other.avatarKeyframe.size();
+            nodeData->setLastSentKeyframeID(otherUUID, other.keyframeID);
+        }
+
+        if (otherAvatarDataSize + mixedAvatarByteArray.size() > MAX_PACKET_SIZE) {
+            job.packets.append(mixedAvatarByteArray);
+
+            numAvatarDataBytes += mixedAvatarByteArray.size();
+
+            // reset the packet
+            mixedAvatarByteArray = _bulkAvatarDataPacketHeader;
+        }
+
+        // copy the avatar into the mixedAvatarByteArray packet
+        if (needsKeyframe) {
+            mixedAvatarByteArray.append(other.avatarKeyframe);
+        }
+        mixedAvatarByteArray.append(other.avatarData);
+
+        if (!hasCheckedFirstPackets) {
+            forceSend = !nodeData->checkAndSetHasReceivedFirstPackets();
+            hasCheckedFirstPackets = true;
+        }
+
+        // we will also force a send of billboard or identity packet
+        // if either has changed in the last frame
+
+        if (other.billboardChangeTimestamp > 0
+            && (forceSend
+                || other.billboardChangeTimestamp > _lastFrameTimestamp
+                || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+            job.packets.append(other.billboardPacket);
+            ++job.numBillboardPackets;
+        }
+
+        if (other.identityChangeTimestamp > 0
+            && (forceSend
+                || other.identityChangeTimestamp > _lastFrameTimestamp
+                || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+            job.packets.append(other.identityPacket);
+            ++job.numIdentityPackets;
+        }
+    }
+
+    // send the last packet
+    job.packets.append(mixedAvatarByteArray);
+
+    // record the bytes sent for other avatar data in the AvatarMixerClientData
+    nodeData->recordSentAvatarData(numAvatarDataBytes + mixedAvatarByteArray.size());
+
+    // record the number of avatars held back this frame
+    nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
+    nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+
+    if (numOtherAvatars == 0) {
+        // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
+        nodeData->setMaxAvatarDistance(FLT_MAX);
+    } else {
+        nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
+    }
 }
 
 void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
@@ -375,7 +464,7 @@ void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
         
         nodeList->broadcastToNodes(killPacket, NodeSet() << NodeType::Agent);
 
-        // we also want to remove sequence number data for this avatar on our other avatars
+        // we also want to remove sequence number and keyframe data for this avatar on our other avatars
         // so invoke the appropriate method on the AvatarMixerClientData for other avatars
         nodeList->eachMatchingNode(
             [&](const SharedNodePointer& node)->bool {
@@ -391,7 +480,7 @@ void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
             },
             [&](const SharedNodePointer& node) {
                 QMetaObject::invokeMethod(node->getLinkedData(),
-                                          "removeLastBroadcastSequenceNumber",
+                                          "removeBroadcastState",
                                           Qt::AutoConnection,
                                           Q_ARG(const QUuid&, QUuid(killedNode->getUUID())));
             }
@@ -469,6 +558,7 @@ void AvatarMixer::sendStatsPacket() {
     
     statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100;
     statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
+    statsObject["broadcast_threads"] = _numBroadcastThreads;
 
     QJsonObject avatarsObject;
     
@@ -563,4 +653,16 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
 
     _maxKbpsPerNode = nodeBandwidthValue.toDouble(DEFAULT_NODE_SEND_BANDWIDTH) * KILO_PER_MEGA;
     qDebug() << "The maximum send bandwidth per node is" << _maxKbpsPerNode << "kbps."; 
+
+    const QString NUM_BROADCAST_THREADS_KEY = "num_broadcast_threads";
+    bool ok;
+    int numBroadcastThreads = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[NUM_BROADCAST_THREADS_KEY]
+        .toString().toInt(&ok);
+    if (ok && numBroadcastThreads > 0) {
+        _numBroadcastThreads = numBroadcastThreads;
+    }
+
+    // the broadcast thread always builds a share of the packets, so the pool only needs the extra threads
+    _broadcastThreadPool.setMaxThreadCount(std::max(_numBroadcastThreads - 1, 1));
+    qDebug() << "Building avatar broadcasts on" << _numBroadcastThreads << "thread(s)";
 }
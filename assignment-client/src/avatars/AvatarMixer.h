@@ -15,8 +15,68 @@
 #ifndef hifi_AvatarMixer_h
 #define hifi_AvatarMixer_h
 
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+#include <LimitedNodeList.h>
 #include <ThreadedAssignment.h>
 
+class AvatarMixerClientData;
+
+const int DEFAULT_NUM_BROADCAST_THREADS = 1;
+
+/// one avatar as it is broadcast this frame, taken once under the avatar's lock and then shared by every listener
+struct AvatarSnapshot {
+    SharedNodePointer node;
+    AvatarMixerClientData* nodeData;
+    glm::vec3 position;
+
+    PacketSequenceNumber sequenceNumber;
+    quint64 billboardChangeTimestamp;
+    quint64 identityChangeTimestamp;
+
+    // the avatar's UUID followed by its serialized data, ready to be packed into a bulk avatar data packet
+    QByteArray avatarData;
+
+    // the same for the keyframe the data was taken against, for listeners that haven't been sent it,
+    // left empty when the data is that keyframe
+    QByteArray avatarKeyframe;
+    quint8 keyframeID;
+
+    // whole packets, only filled in when the avatar has ever sent a billboard or identity
+    QByteArray billboardPacket;
+    QByteArray identityPacket;
+
+    // whether this node is an agent we broadcast to
+    bool isListener;
+};
+
+/// the packets for a single listener, built by whichever broadcast worker picks up the job
+struct AvatarBroadcastJob {
+    AvatarBroadcastJob(int listenerSnapshotIndex) :
+        snapshotIndex(listenerSnapshotIndex),
+        numBillboardPackets(0),
+        numIdentityPackets(0) {}
+
+    int snapshotIndex;
+
+    // the packets to send, in the order they should go out
+    QVector<QByteArray> packets;
+
+    int numBillboardPackets;
+    int numIdentityPackets;
+
+    // snapshots of the avatars we found we had already sent a newer sequence number for
+    QVector<int> outOfOrderSnapshotIndices;
+};
+
 /// Handles assignments of type AvatarMixer - distribution of avatar data to various clients
 class AvatarMixer : public ThreadedAssignment {
 public:
@@ -34,7 +94,19 @@ public slots:
     void sendStatsPacket();
     
 private:
+    friend class AvatarMixerWorker;
+
     void broadcastAvatarData();
+
+    /// serializes every avatar for this frame into _avatarSnapshots and queues a job for each listener
+    void takeAvatarSnapshots();
+
+    /// builds the packets for one listener out of the avatar snapshots
+    void prepareBroadcastForListener(AvatarBroadcastJob& job, std::mt19937& generator);
+
+    /// pulls broadcast jobs off of the current frame's list until there are none left
+    void processBroadcastJobs(QAtomicInt& nextJobIndex);
+
     void parseDomainServerSettings(const QJsonObject& domainSettings);
     
     QThread _broadcastThread;
@@ -51,6 +123,14 @@ private:
 
     float _maxKbpsPerNode = 0.0f;
 
+    std::vector<AvatarSnapshot> _avatarSnapshots;
+    std::vector<AvatarBroadcastJob> _broadcastJobs;
+    QByteArray _bulkAvatarDataPacketHeader;
+
+    int _numBroadcastThreads = DEFAULT_NUM_BROADCAST_THREADS;
+    QThreadPool _broadcastThreadPool;
+    QSemaphore _broadcastWorkersDone;
+
     QTimer* _broadcastTimer = nullptr;
 };
 
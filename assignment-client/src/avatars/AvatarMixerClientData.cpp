@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <NodeList.h>
 #include <PacketHeaders.h>
 
 #include "AvatarMixerClientData.h"
@@ -35,6 +36,36 @@ PacketSequenceNumber AvatarMixerClientData::getLastBroadcastSequenceNumber(const
     }
 }
 
+int AvatarMixerClientData::getLastSentKeyframeID(const QUuid& nodeUUID) const {
+    auto nodeMatch = _lastSentKeyframeIDs.find(nodeUUID);
+    return (nodeMatch != _lastSentKeyframeIDs.end()) ? nodeMatch->second : -1;
+}
+
+const QByteArray& AvatarMixerClientData::getBillboardPacket(const QUuid& nodeUUID) {
+    if (_billboardPacket.isEmpty()) {
+        _billboardPacket = DependencyManager::get<NodeList>()->byteArrayWithPopulatedHeader(PacketTypeAvatarBillboard);
+        _billboardPacket.append(nodeUUID.toRfc4122());
+        _billboardPacket.append(_avatar.getBillboard());
+    }
+    return _billboardPacket;
+}
+
+const QByteArray& AvatarMixerClientData::getIdentityPacket(const QUuid& nodeUUID) {
+    if (_identityPacket.isEmpty()) {
+        QByteArray individualData = _avatar.identityByteArray();
+        individualData.replace(0, NUM_BYTES_RFC4122_UUID, nodeUUID.toRfc4122());
+
+        _identityPacket = DependencyManager::get<NodeList>()->byteArrayWithPopulatedHeader(PacketTypeAvatarIdentity);
+        _identityPacket.append(individualData);
+    }
+    return _identityPacket;
+}
+
+void AvatarMixerClientData::removeBroadcastState(const QUuid& nodeUUID) {
+    _lastBroadcastSequenceNumbers.erase(nodeUUID);
+    _lastSentKeyframeIDs.erase(nodeUUID);
+}
+
 void AvatarMixerClientData::loadJSONStats(QJsonObject& jsonObject) const {
     jsonObject["display_name"] = _avatar.getDisplayName();
     jsonObject["full_rate_distance"] = _fullRateDistance;
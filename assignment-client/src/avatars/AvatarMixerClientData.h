@@ -39,13 +39,25 @@ public:
     PacketSequenceNumber getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const;
     void setLastBroadcastSequenceNumber(const QUuid& nodeUUID, PacketSequenceNumber sequenceNumber) 
         { _lastBroadcastSequenceNumbers[nodeUUID] = sequenceNumber; }
-    Q_INVOKABLE void removeLastBroadcastSequenceNumber(const QUuid& nodeUUID) { _lastBroadcastSequenceNumbers.erase(nodeUUID); }
+
+    /// \return the ID of the last keyframe of this node's avatar sent to us, or -1 if we haven't been sent one
+    int getLastSentKeyframeID(const QUuid& nodeUUID) const;
+    void setLastSentKeyframeID(const QUuid& nodeUUID, quint8 keyframeID) { _lastSentKeyframeIDs[nodeUUID] = keyframeID; }
+
+    Q_INVOKABLE void removeBroadcastState(const QUuid& nodeUUID);
 
     quint64 getBillboardChangeTimestamp() const { return _billboardChangeTimestamp; }
-    void setBillboardChangeTimestamp(quint64 billboardChangeTimestamp) { _billboardChangeTimestamp = billboardChangeTimestamp; }
+    void setBillboardChangeTimestamp(quint64 billboardChangeTimestamp)
+        { _billboardChangeTimestamp = billboardChangeTimestamp; _billboardPacket.clear(); }
     
     quint64 getIdentityChangeTimestamp() const { return _identityChangeTimestamp; }
-    void setIdentityChangeTimestamp(quint64 identityChangeTimestamp) { _identityChangeTimestamp = identityChangeTimestamp; }
+    void setIdentityChangeTimestamp(quint64 identityChangeTimestamp)
+        { _identityChangeTimestamp = identityChangeTimestamp; _identityPacket.clear(); }
+
+    // the packets we broadcast for this node's avatar, only rebuilt when the billboard or identity changes. Call these
+    // with the mutex held, and only once the avatar has sent a billboard or identity.
+    const QByteArray& getBillboardPacket(const QUuid& nodeUUID);
+    const QByteArray& getIdentityPacket(const QUuid& nodeUUID);
    
     void setFullRateDistance(float fullRateDistance) { _fullRateDistance = fullRateDistance; }
     float getFullRateDistance() const { return _fullRateDistance; }
@@ -79,10 +91,14 @@ private:
     AvatarData _avatar;
 
     std::unordered_map<QUuid, PacketSequenceNumber, UUIDHasher> _lastBroadcastSequenceNumbers;
+    std::unordered_map<QUuid, quint8, UUIDHasher> _lastSentKeyframeIDs;
 
     bool _hasReceivedFirstPackets = false;
     quint64 _billboardChangeTimestamp = 0;
     quint64 _identityChangeTimestamp = 0;
+
+    QByteArray _billboardPacket; // empty until it's needed after a change
+    QByteArray _identityPacket;
     
     float _fullRateDistance = FLT_MAX;
     float _maxAvatarDistance = FLT_MAX;
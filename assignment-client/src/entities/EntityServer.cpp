@@ -16,6 +16,7 @@
 #include "EntityServer.h"
 #include "EntityServerConsts.h"
 #include "EntityNodeData.h"
+#include "ServerPhysicalEntitySimulation.h"
 
 const char* MODEL_SERVER_NAME = "Entity";
 const char* MODEL_SERVER_LOGGING_TARGET_NAME = "entity-server";
@@ -42,6 +43,7 @@ OctreeQueryNode* EntityServer::createOctreeQueryNode() {
 
 Octree* EntityServer::createTree() {
     EntityTree* tree = new EntityTree(true);
+    tree->setWantEncodeCache(true); // every send thread encodes the same entities for its own node
     tree->addNewlyCreatedHook(this);
     if (!_entitySimulation) {
         SimpleEntitySimulation* simpleSimulation = new SimpleEntitySimulation();
@@ -52,6 +54,13 @@ Octree* EntityServer::createTree() {
     return tree;
 }
 
+Octree* EntityServer::createVersionTree() {
+    // a copy is only replayed into and encoded from, it isn't simulated or told about edits
+    EntityTree* tree = new EntityTree(true);
+    tree->setWantEncodeCache(true);
+    return tree;
+}
+
 void EntityServer::beforeRun() {
     _pruneDeletedEntitiesTimer = new QTimer();
     connect(_pruneDeletedEntitiesTimer, SIGNAL(timeout()), this, SLOT(pruneDeletedEntities()));
@@ -72,8 +81,10 @@ bool EntityServer::hasSpecialPacketToSend(const SharedNodePointer& node) {
     if (nodeData) {
         quint64 deletedEntitiesSentAt = nodeData->getLastDeletedEntitiesSentAt();
 
+        // the version this node is being sent still has anything deleted after it was taken
         EntityTree* tree = static_cast<EntityTree*>(_tree);
-        shouldSendDeletedEntities = tree->hasEntitiesDeletedSince(deletedEntitiesSentAt);
+        shouldSendDeletedEntities = tree->hasEntitiesDeletedSince(deletedEntitiesSentAt,
+                                                                  nodeData->getOctreeVersionTakenAt());
     }
 
     return shouldSendDeletedEntities;
@@ -86,7 +97,7 @@ int EntityServer::sendSpecialPacket(const SharedNodePointer& node, OctreeQueryNo
     EntityNodeData* nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
     if (nodeData) {
         quint64 deletedEntitiesSentAt = nodeData->getLastDeletedEntitiesSentAt();
-        quint64 deletePacketSentAt = usecTimestampNow();
+        quint64 deletePacketSentAt = std::min(usecTimestampNow(), nodeData->getOctreeVersionTakenAt());
 
         EntityTree* tree = static_cast<EntityTree*>(_tree);
         bool hasMoreToSend = true;
@@ -95,7 +106,7 @@ int EntityServer::sendSpecialPacket(const SharedNodePointer& node, OctreeQueryNo
         packetsSent = 0;
         while (hasMoreToSend) {
             hasMoreToSend = tree->encodeEntitiesDeletedSince(queryNode->getSequenceNumber(), deletedEntitiesSentAt,
-                                                outputBuffer, MAX_PACKET_SIZE, packetLength);
+                                                deletePacketSentAt, outputBuffer, MAX_PACKET_SIZE, packetLength);
 
             DependencyManager::get<NodeList>()->writeDatagram((char*) outputBuffer, packetLength,
                                                               SharedNodePointer(node));
@@ -136,8 +147,21 @@ void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectio
     qDebug("wantEditLogging=%s", debug::valueOf(wantEditLogging));
 
 
+    bool wantPhysics = false;
+    readOptionBool(QString("wantPhysics"), settingsSectionObject, wantPhysics);
+    qDebug("wantPhysics=%s", debug::valueOf(wantPhysics));
+
     EntityTree* tree = static_cast<EntityTree*>(_tree);
     tree->setWantEditLogging(wantEditLogging);
+
+    if (wantPhysics) {
+        // nothing has been loaded into the tree yet, so the simple simulation has nothing to hand over
+        ServerPhysicalEntitySimulation* physicalSimulation = new ServerPhysicalEntitySimulation();
+        physicalSimulation->init(tree);
+        tree->setSimulation(physicalSimulation);
+        delete _entitySimulation;
+        _entitySimulation = physicalSimulation;
+    }
 }
 
 
@@ -48,6 +48,7 @@ public slots:
 
 protected:
     virtual Octree* createTree();
+    virtual Octree* createVersionTree();
 
 private:
     EntitySimulation* _entitySimulation;
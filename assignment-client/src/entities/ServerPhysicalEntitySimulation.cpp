@@ -0,0 +1,48 @@
+//
+//  ServerPhysicalEntitySimulation.cpp
+//  assignment-client/src/entities
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QThread>
+
+#include <NodeList.h>
+
+#include "ServerPhysicalEntitySimulation.h"
+
+ServerPhysicalEntitySimulation::ServerPhysicalEntitySimulation() :
+    _physicsEngine(glm::vec3(0.0f))
+{
+}
+
+void ServerPhysicalEntitySimulation::init(EntityTree* tree) {
+    _physicsEngine.init();
+
+    // the server has no render loop to share the cores with, so big scenes synchronize their bodies in parallel
+    _physicsEngine.setNumSynchronizeThreads(QThread::idealThreadCount());
+    PhysicalEntitySimulation::init(tree, &_physicsEngine, &_shapeManager, nullptr);
+}
+
+void ServerPhysicalEntitySimulation::updateEntitiesInternal(const quint64& now) {
+    PhysicalEntitySimulation::updateEntitiesInternal(now);
+
+    // EntityTree::update() has the tree locked for write, so our outgoing changes can be applied to it as we go
+    _physicsEngine.setSessionUUID(DependencyManager::get<NodeList>()->getSessionUUID());
+
+    _physicsEngine.deleteObjects(getObjectsToDelete());
+    _physicsEngine.addObjects(getObjectsToAdd());
+    _physicsEngine.changeObjects(getObjectsToChange());
+
+    _physicsEngine.stepSimulation();
+
+    if (_physicsEngine.hasOutgoingChanges()) {
+        handleOutgoingChanges(_physicsEngine.getOutgoingChanges(), _physicsEngine.getSessionID());
+    }
+
+    // nothing on the server runs collision scripts, but collecting the events is what retires finished contacts
+    _physicsEngine.getCollisionEvents();
+}
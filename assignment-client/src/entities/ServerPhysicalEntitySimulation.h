@@ -0,0 +1,36 @@
+//
+//  ServerPhysicalEntitySimulation.h
+//  assignment-client/src/entities
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ServerPhysicalEntitySimulation_h
+#define hifi_ServerPhysicalEntitySimulation_h
+
+#include <PhysicalEntitySimulation.h>
+#include <PhysicsEngine.h>
+#include <ShapeManager.h>
+
+/// Runs the PhysicsEngine headless over the entity server's own tree. The simulation is stepped each time the
+/// tree is updated, and the server bids for and keeps ownership of the entities it simulates like any interface
+/// would. Its outgoing changes are applied straight to the tree as the server's own edits, so they reach every
+/// node with the next entity data packets rather than as edit packets.
+class ServerPhysicalEntitySimulation : public PhysicalEntitySimulation {
+public:
+    ServerPhysicalEntitySimulation();
+
+    void init(EntityTree* tree);
+
+protected:
+    virtual void updateEntitiesInternal(const quint64& now);
+
+private:
+    PhysicsEngine _physicsEngine;
+    ShapeManager _shapeManager;
+};
+
+#endif // hifi_ServerPhysicalEntitySimulation_h
@@ -22,7 +22,10 @@
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
 
+// edits are authoritative, so when they come in faster than we can apply them the threads reading them wait for room
+// rather than have the queue drop any
 OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
+    ReceivedPacketProcessor(NetworkPacketQueue::DEFAULT_CAPACITY, NetworkPacketQueue::Backpressure),
     _myServer(myServer),
     _receivedPacketCount(0),
     _totalTransitTime(0),
@@ -33,6 +33,7 @@ OctreeQueryNode::OctreeQueryNode() :
     _maxSearchLevel(1),
     _maxLevelReachedInLastSearch(1),
     _lastTimeBagEmpty(0),
+    _octreeVersionTakenAt(quint64(-1)),
     _viewFrustumChanging(false),
     _viewFrustumJustStoppedChanging(true),
     _currentPacketIsColor(true),
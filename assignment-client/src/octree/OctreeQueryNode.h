@@ -12,6 +12,7 @@
 #ifndef hifi_OctreeQueryNode_h
 #define hifi_OctreeQueryNode_h
 
+#include <algorithm>
 #include <iostream>
 
 
@@ -79,6 +80,13 @@ public:
     quint64 getLastTimeBagEmpty() const { return _lastTimeBagEmpty; }
     void setLastTimeBagEmpty() { _lastTimeBagEmpty = _sceneSendStartTime; }
 
+    /// makes the next scene include everything changed since time
+    void rewindLastTimeBagEmpty(quint64 time) { _lastTimeBagEmpty = std::min(_lastTimeBagEmpty, time); }
+
+    /// when the live tree looked like the version this node is being sent, anything changed since isn't sent yet
+    quint64 getOctreeVersionTakenAt() const { return _octreeVersionTakenAt; }
+    void setOctreeVersionTakenAt(quint64 takenAt) { _octreeVersionTakenAt = takenAt; }
+
     bool getCurrentPacketIsColor() const { return _currentPacketIsColor; }
     bool getCurrentPacketIsCompressed() const { return _currentPacketIsCompressed; }
     bool getCurrentPacketFormatMatches() {
@@ -138,6 +146,7 @@ private:
     ViewFrustum _currentViewFrustum;
     ViewFrustum _lastKnownViewFrustum;
     quint64 _lastTimeBagEmpty;
+    quint64 _octreeVersionTakenAt;
     bool _viewFrustumChanging;
     bool _viewFrustumJustStoppedChanging;
     bool _currentPacketIsColor;
@@ -26,6 +26,7 @@ OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePoint
     _node(node),
     _nodeUUID(node->getUUID()),
     _packetData(),
+    _octreeVersion(NULL),
     _nodeMissingCount(0),
     _isShuttingDown(false)
 {
@@ -56,6 +57,11 @@ OctreeSendThread::~OctreeSendThread() {
     OctreeServer::clientDisconnected();
     OctreeServer::stopTrackingThread(this);
 
+    if (_octreeVersion) {
+        _myServer->getVersionPublisher()->release(_octreeVersion);
+        _octreeVersion = NULL;
+    }
+
     _node.clear();
 }
 
@@ -280,6 +286,23 @@ int OctreeSendThread::handlePacketSend(OctreeQueryNode* nodeData, int& trueBytes
     return packetsSent;
 }
 
+void OctreeSendThread::moveToLatestVersion(OctreeQueryNode* nodeData) {
+    OctreeVersionPublisher* versionPublisher = _myServer->getVersionPublisher();
+    OctreeVersion* latestVersion = versionPublisher->acquireLatest();
+    if (latestVersion == _octreeVersion) {
+        versionPublisher->release(latestVersion);
+        return;
+    }
+
+    // what changed after the old version was taken was never sent, however recently a scene from it completed
+    nodeData->rewindLastTimeBagEmpty(_octreeVersion->getTakenAt());
+    nodeData->elementBag.deleteAll();
+    versionPublisher->release(_octreeVersion);
+
+    _octreeVersion = latestVersion;
+    nodeData->setOctreeVersionTakenAt(_octreeVersion->getTakenAt());
+}
+
 /// Version of octree element distributor that sends the deepest LOD level at once
 int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrustumChanged) {
         
@@ -289,6 +312,28 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
     if (nodeData->isShuttingDown()) {
         return 0;
     }
+
+    // encode from a published version of the tree when there is one, so edits to the tree never wait on us. We hold
+    // on to a version for the whole scene and only move to the latest one when the next scene starts.
+    OctreeVersionPublisher* versionPublisher = _myServer->getVersionPublisher();
+    bool isEncodingVersions = versionPublisher && versionPublisher->isEnabled();
+    if (isEncodingVersions && !_octreeVersion) {
+        _octreeVersion = versionPublisher->acquireLatest();
+        if (!_octreeVersion) {
+            return 0; // nothing is published yet
+        }
+        nodeData->setOctreeVersionTakenAt(_octreeVersion->getTakenAt());
+
+        // the elements of a version aren't deleted while we hold it, and the bag is emptied before we let it go
+        nodeData->elementBag.unhookNotifications();
+    }
+    Octree* tree = isEncodingVersions ? _octreeVersion->getTree() : _myServer->getOctree();
+
+    // holding on to an outdated version keeps the publisher from reusing its copy, so this scene starts over
+    bool isAbandoningScene = isEncodingVersions && versionPublisher->isOutdated(_octreeVersion);
+    if (isAbandoningScene) {
+        nodeData->elementBag.deleteAll();
+    }
     
     // calculate max number of packets that can be sent during this interval
     int clientMaxPacketsPerInterval = std::max(1, (nodeData->getMaxQueryPacketsPerSecond() / INTERVALS_PER_SECOND));
@@ -329,6 +374,15 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
 
     const ViewFrustum* lastViewFrustum =  wantDelta ? &nodeData->getLastKnownViewFrustum() : NULL;
 
+    // send what looks biggest to the node first, and what changed since its last full pass before what didn't, so
+    // the content that matters most to it shows up first when there's too much to send in one interval
+    tree->lockForRead();
+    nodeData->elementBag.setPriorityView(&nodeData->getCurrentViewFrustum(), nodeData->getLastTimeBagEmpty());
+    if (viewFrustumChanged) {
+        nodeData->elementBag.reprioritize();
+    }
+    tree->unlock();
+
     // If the current view frustum has changed OR we have nothing to send, then search against
     // the current view frustum for things to send.
     if (viewFrustumChanged || nodeData->elementBag.isEmpty()) {
@@ -341,15 +395,15 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
             nodeData->map.erase();
         }
 
-        if (!viewFrustumChanged && !nodeData->getWantDelta()) {
+        if (!viewFrustumChanged && !nodeData->getWantDelta() && !isAbandoningScene) {
             // only set our last sent time if we weren't resetting due to frustum change
             nodeData->setLastTimeBagEmpty();
         }
 
         // track completed scenes and send out the stats packet accordingly
         nodeData->stats.sceneCompleted();
-        nodeData->setLastRootTimestamp(_myServer->getOctree()->getRoot()->getLastChanged());
-        _myServer->getOctree()->releaseSceneEncodeData(&nodeData->extraEncodeData);
+        nodeData->setLastRootTimestamp(tree->getRoot()->getLastChanged());
+        tree->releaseSceneEncodeData(&nodeData->extraEncodeData);
 
         // TODO: add these to stats page
         //::endSceneSleepTime = _usleepTime;
@@ -368,19 +422,24 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         // TODO: add these to stats page
         //::startSceneSleepTime = _usleepTime;
 
+        if (isEncodingVersions) {
+            moveToLatestVersion(nodeData);
+            tree = _octreeVersion->getTree();
+        }
+
         nodeData->sceneStart(usecTimestampNow() - CHANGE_FUDGE);
         // start tracking our stats
         nodeData->stats.sceneStarted(isFullScene, viewFrustumChanged,
-                                     _myServer->getOctree()->getRoot(), _myServer->getJurisdiction());
+                                     tree->getRoot(), _myServer->getJurisdiction());
 
         // This is the start of "resending" the scene.
         bool dontRestartSceneOnMove = false; // this is experimental
         if (dontRestartSceneOnMove) {
             if (nodeData->elementBag.isEmpty()) {
-                nodeData->elementBag.insert(_myServer->getOctree()->getRoot());
+                nodeData->elementBag.insert(tree->getRoot());
             }
         } else {
-            nodeData->elementBag.insert(_myServer->getOctree()->getRoot());
+            nodeData->elementBag.insert(tree->getRoot());
         }
     }
 
@@ -389,6 +448,10 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         int bytesWritten = 0;
         quint64 start = usecTimestampNow();
 
+        if (isEncodingVersions) {
+            OctreeServer::trackVersionAge((float)(start - _octreeVersion->getTakenAt()));
+        }
+
         // TODO: add these to stats page
         //quint64 startCompressTimeMsecs = OctreePacketData::getCompressContentTime() / 1000;
         //quint64 startCompressCalls = OctreePacketData::getCompressContentCalls();
@@ -408,7 +471,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
             if (!nodeData->elementBag.isEmpty()) {
                 
                 quint64 lockWaitStart = usecTimestampNow();
-                _myServer->getOctree()->lockForRead();
+                tree->lockForRead();
                 quint64 lockWaitEnd = usecTimestampNow();
                 lockWaitElapsedUsec = (float)(lockWaitEnd - lockWaitStart);
                 quint64 encodeStart = usecTimestampNow();
@@ -422,7 +485,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                 // and we've already seen at least one duplicate packet, then we probably don't need 
                 // to lock the tree and encode, because the result should be that no bytes will be 
                 // encoded, and this will be a duplicate packet from the  last one we sent...
-                OctreeElement* root = _myServer->getOctree()->getRoot();
+                OctreeElement* root = tree->getRoot();
                 bool skipEncode = false;
                 if (
                         (subTree == root)
@@ -457,7 +520,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                 // are reported to client. Since you can encode without the lock
                 nodeData->stats.encodeStarted();
 
-                bytesWritten = _myServer->getOctree()->encodeTreeBitstream(subTree, &_packetData, nodeData->elementBag, params);
+                bytesWritten = tree->encodeTreeBitstream(subTree, &_packetData, nodeData->elementBag, params);
 
                 quint64 encodeEnd = usecTimestampNow();
                 encodeElapsedUsec = (float)(encodeEnd - encodeStart);
@@ -484,7 +547,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                 }
 
                 nodeData->stats.encodeStopped();
-                _myServer->getOctree()->unlock();
+                tree->unlock();
             } else {
                 // If the bag was empty then we didn't even attempt to encode, and so we know the bytesWritten were 0
                 bytesWritten = 0;
@@ -17,6 +17,7 @@
 #include <GenericThread.h>
 #include <NetworkPacket.h>
 #include <OctreeElementBag.h>
+#include <OctreeVersionPublisher.h>
 
 #include "OctreeQueryNode.h"
 
@@ -49,8 +50,10 @@ private:
 
     int handlePacketSend(OctreeQueryNode* nodeData, int& trueBytesSent, int& truePacketsSent);
     int packetDistributor(OctreeQueryNode* nodeData, bool viewFrustumChanged);
+    void moveToLatestVersion(OctreeQueryNode* nodeData);
 
     OctreePacketData _packetData;
+    OctreeVersion* _octreeVersion; // what we encode from when the server publishes versions of its tree
     
     int _nodeMissingCount;
     bool _isShuttingDown;
@@ -75,6 +75,8 @@ SimpleMovingAverage OctreeServer::_averageProcessWaitTime(MOVING_AVERAGE_SAMPLE_
 SimpleMovingAverage OctreeServer::_averageProcessShortWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
 SimpleMovingAverage OctreeServer::_averageProcessLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
 SimpleMovingAverage OctreeServer::_averageProcessExtraLongWaitTime(MOVING_AVERAGE_SAMPLE_COUNTS);
+
+SimpleMovingAverage OctreeServer::_averageVersionAge(MOVING_AVERAGE_SAMPLE_COUNTS);
 int OctreeServer::_extraLongProcessWait = 0;
 int OctreeServer::_longProcessWait = 0;
 int OctreeServer::_shortProcessWait = 0;
@@ -222,6 +224,8 @@ OctreeServer::OctreeServer(const QByteArray& packet) :
     _statusPort(0),
     _packetsPerClientPerInterval(10),
     _packetsTotalPerInterval(DEFAULT_PACKETS_PER_INTERVAL),
+    _numReceiveSockets(1),
+    _datagramProcessor(NULL),
     _tree(NULL),
     _wantPersist(true),
     _debugSending(false),
@@ -231,6 +235,7 @@ OctreeServer::OctreeServer(const QByteArray& packet) :
     _jurisdictionSender(NULL),
     _octreeInboundPacketProcessor(NULL),
     _persistThread(NULL),
+    _versionPublisher(NULL),
     _started(time(0)),
     _startedUSecs(usecTimestampNow())
 {
@@ -276,6 +281,12 @@ OctreeServer::~OctreeServer() {
         _persistThread->deleteLater();
     }
 
+    if (_versionPublisher) {
+        _versionPublisher->terminating();
+        _versionPublisher->terminate();
+        _versionPublisher->deleteLater();
+    }
+
     delete _jurisdiction;
     _jurisdiction = NULL;
     
@@ -370,6 +381,40 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             statsString += getFileLoadTime();
             statsString += "\r\n";
 
+            // JSON files are written from a snapshot of the tree, so edits only wait while it's being copied
+            if (_tree->getLastSnapshotTakenAt() > 0) {
+                quint64 snapshotAgo = usecTimestampNow() - _tree->getLastSnapshotTakenAt();
+                statsString += "\r\n";
+                statsString += QString("%1 File Last Written From Snapshot:\r\n").arg(getMyServerName());
+                statsString += QString("                Taken: %1 secs ago\r\n")
+                    .arg((double)snapshotAgo / USECS_PER_SECOND, 0, 'f', 1);
+                statsString += QString("                Items: %1\r\n").arg(_tree->getLastSnapshotItemCount());
+                statsString += QString("      Memory overhead: %1 KB\r\n")
+                    .arg((double)_tree->getLastSnapshotMemoryUsage() / BYTES_PER_KILOBYTE, 0, 'f', 1);
+                statsString += QString("       Tree lock held: %1 usecs\r\n").arg(_tree->getLastSnapshotLockTime());
+                statsString += QString("     Age when written: %1 msecs\r\n")
+                    .arg((double)_tree->getLastSnapshotAge() / USECS_PER_MSEC, 0, 'f', 1);
+            }
+
+            // send threads encode from published copies of the tree, so edits never wait on them
+            if (_versionPublisher && _versionPublisher->getLatestVersionNumber() > 0) {
+                quint64 versionAgo = usecTimestampNow() - _versionPublisher->getLatestVersionTakenAt();
+                statsString += "\r\n";
+                statsString += QString("%1 Versions Sent From:\r\n").arg(getMyServerName());
+                statsString += QString("       Latest version: %1 taken %2 msecs ago\r\n")
+                    .arg(_versionPublisher->getLatestVersionNumber())
+                    .arg((double)versionAgo / USECS_PER_MSEC, 0, 'f', 1);
+                statsString += QString("  Average age encoded: %1 msecs\r\n")
+                    .arg((double)getAverageVersionAge() / USECS_PER_MSEC, 0, 'f', 1);
+                statsString += QString("            Published: %1 versions, %2 skipped while every copy was read\r\n")
+                    .arg(_versionPublisher->getPublishCount()).arg(_versionPublisher->getBusySkipCount());
+                statsString += QString("       Tree lock held: %1 usecs\r\n").arg(_versionPublisher->getLastLockTime());
+                statsString += QString("   Copy brought up in: %1 usecs\r\n").arg(_versionPublisher->getLastPublishTime());
+                statsString += QString("      Memory overhead: %1 elements in copies, %2 KB of changes waiting\r\n")
+                    .arg(_versionPublisher->getCopiesElementCount())
+                    .arg((double)_versionPublisher->getPendingChangesSize() / BYTES_PER_KILOBYTE, 0, 'f', 1);
+            }
+
         } else {
             statsString += "Octree file not yet loaded...\r\n";
         }
@@ -638,6 +683,9 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             .arg(locale.toString((uint)totalPacketsProcessed).rightJustified(COLUMN_WIDTH, ' '));
         statsString += QString("          Total Inbound Elements: %1 elements\r\n")
             .arg(locale.toString((uint)totalElementsProcessed).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("   Total Dropped Inbound Packets: %1 packets\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getDroppedPacketCount())
+                .rightJustified(COLUMN_WIDTH, ' '));
         statsString += QString().sprintf(" Average Inbound Elements/Packet: %f elements/packet\r\n", averageElementsPerPacket);
         statsString += QString("     Average Transit Time/Packet: %1 usecs\r\n")
             .arg(locale.toString((uint)averageTransitTimePerPacket).rightJustified(COLUMN_WIDTH, ' '));
@@ -873,7 +921,7 @@ void OctreeServer::setupDatagramProcessingThread() {
     
     // we do not want this event loop to be the handler for UDP datagrams, so disconnect
     disconnect(&nodeList->getNodeSocket(), 0, this, 0);
-    
+
     // setup a QThread with us as parent that will house the OctreeServerDatagramProcessor
     _datagramProcessingThread = new QThread(this);
     _datagramProcessingThread->setObjectName("Octree Datagram Processor");
@@ -881,6 +929,7 @@ void OctreeServer::setupDatagramProcessingThread() {
     // create an OctreeServerDatagramProcessor and move it to that thread
     OctreeServerDatagramProcessor* datagramProcessor = new OctreeServerDatagramProcessor(nodeList->getNodeSocket(), thread());
     datagramProcessor->moveToThread(_datagramProcessingThread);
+    _datagramProcessor = datagramProcessor;
     
     // remove the NodeList as the parent of the node socket
     nodeList->getNodeSocket().setParent(NULL);
@@ -901,6 +950,16 @@ void OctreeServer::setupDatagramProcessingThread() {
     _datagramProcessingThread->start();
 }
 
+void OctreeServer::openSharedPortReceivers() {
+    if (_numReceiveSockets > 1) {
+        // the node socket can only be rebound to share its port from the thread that owns it
+        connect(DependencyManager::get<NodeList>().data(), &LimitedNodeList::sharedPortPacketReceived,
+                this, &OctreeServer::readPendingDatagram);
+        QMetaObject::invokeMethod(_datagramProcessor, "openSharedPortReceivers", Qt::BlockingQueuedConnection,
+                                  Q_ARG(int, _numReceiveSockets));
+    }
+}
+
 bool OctreeServer::readOptionBool(const QString& optionName, const QJsonObject& settingsSectionObject, bool& result) {
     result = false; // assume it doesn't exist
     bool optionAvailable = false;
@@ -1085,6 +1144,11 @@ void OctreeServer::readConfiguration() {
     }
     qDebug("packetsPerSecondTotalMax=%d _packetsTotalPerInterval=%d", 
                     packetsPerSecondTotalMax, _packetsTotalPerInterval);
+
+    // more than one socket on our port spreads reading inbound datagrams across that many threads
+    if (readOptionInt(QString("receiveSockets"), settingsSectionObject, _numReceiveSockets)) {
+        qDebug("receiveSockets=%d", _numReceiveSockets);
+    }
                     
                     
     readAdditionalConfiguration(settingsSectionObject);
@@ -1110,6 +1174,9 @@ void OctreeServer::run() {
 
     // read the configuration from either the payload or the domain server configuration
     readConfiguration();
+
+    // after the configuration, which says how many sockets to read our port from
+    openSharedPortReceivers();
         
     beforeRun(); // after payload has been processed
 
@@ -1132,6 +1199,21 @@ void OctreeServer::run() {
 
     srand((unsigned)time(0));
 
+    // if our tree can be copied, send threads encode from published versions of it
+    const int NUM_VERSION_TREES = 2;
+    QVector<Octree*> versionTrees;
+    for (int i = 0; i < NUM_VERSION_TREES; i++) {
+        Octree* versionTree = createVersionTree();
+        if (versionTree) {
+            versionTrees << versionTree;
+        }
+    }
+    if (versionTrees.size() == NUM_VERSION_TREES) {
+        _versionPublisher = new OctreeVersionPublisher(_tree, versionTrees);
+    } else {
+        qDeleteAll(versionTrees);
+    }
+
     // if we want Persistence, set up the local file and persist thread
     if (_wantPersist) {
 
@@ -1139,9 +1221,14 @@ void OctreeServer::run() {
         _persistThread = new OctreePersistThread(_tree, _persistFilename, _persistInterval,
                                                  _wantBackup, _settings, _debugTimestampNow, _persistAsFileType);
         if (_persistThread) {
+            // the first version is published once the tree is loaded
+            connect(_persistThread, &OctreePersistThread::loadCompleted, this, &OctreeServer::startVersionPublisher);
             _persistThread->initialize(true);
         }
     }
+    if (!_persistThread) {
+        startVersionPublisher();
+    }
 
     HifiSockAddr senderSockAddr;
 
@@ -1170,6 +1257,12 @@ void OctreeServer::run() {
     qDebug() << "Now running... started at: " << localBuffer << utcBuffer;
 }
 
+void OctreeServer::startVersionPublisher() {
+    if (_versionPublisher) {
+        _versionPublisher->initialize(true);
+    }
+}
+
 void OctreeServer::nodeAdded(SharedNodePointer node) {
     // we might choose to use this notifier to track clients in a pending state
     qDebug() << qPrintable(_safeServerName) << "server added node:" << *node;
@@ -1380,6 +1473,13 @@ void OctreeServer::sendStatsPacket() {
     statsObject1[baseName + QString(".1.1.octree.elementCount")] = (double)OctreeElement::getNodeCount();
     statsObject1[baseName + QString(".1.2.octree.internalElementCount")] = (double)OctreeElement::getInternalNodeCount();
     statsObject1[baseName + QString(".1.3.octree.leafElementCount")] = (double)OctreeElement::getLeafNodeCount();
+    if (_versionPublisher) {
+        statsObject1[baseName + QString(".1.4.octree.versionAge")] = getAverageVersionAge();
+        statsObject1[baseName + QString(".1.5.octree.versionCopiesElementCount")] =
+            (double)_versionPublisher->getCopiesElementCount();
+        statsObject1[baseName + QString(".1.6.octree.versionPendingChangesBytes")] =
+            (double)_versionPublisher->getPendingChangesSize();
+    }
 
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject1);
 
@@ -1410,6 +1510,8 @@ void OctreeServer::sendStatsPacket() {
         (double)_octreeInboundPacketProcessor->getTotalPacketsProcessed();
     statsObject3[baseName + QString(".3.inbound.data.2.totalElements")] = 
         (double)_octreeInboundPacketProcessor->getTotalElementsProcessed();
+    statsObject3[baseName + QString(".3.inbound.data.3.droppedPackets")] = 
+        (double)_octreeInboundPacketProcessor->getDroppedPacketCount();
     statsObject3[baseName + QString(".3.inbound.timing.1.avgTransitTimePerPacket")] = 
         (double)_octreeInboundPacketProcessor->getAverageTransitTimePerPacket();
     statsObject3[baseName + QString(".3.inbound.timing.2.avgProcessTimePerPacket")] = 
@@ -20,12 +20,15 @@
 
 #include <ThreadedAssignment.h>
 #include <EnvironmentData.h>
+#include <OctreeVersionPublisher.h>
 
 #include "OctreePersistThread.h"
 #include "OctreeSendThread.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
 
+class OctreeServerDatagramProcessor;
+
 const int DEFAULT_PACKETS_PER_INTERVAL = 2000; // some 120,000 packets per second total
 
 /// Handles assignments of type OctreeServer - sending octrees to various clients.
@@ -43,6 +46,9 @@ public:
     bool wantsVerboseDebug() const { return _verboseDebug; }
 
     Octree* getOctree() { return _tree; }
+
+    /// NULL unless send threads encode from published versions of the tree instead of the tree itself
+    OctreeVersionPublisher* getVersionPublisher() { return _versionPublisher; }
     JurisdictionMap* getJurisdiction() { return _jurisdiction; }
 
     int getPacketsPerClientPerInterval() const { return std::min(_packetsPerClientPerInterval, 
@@ -100,6 +106,9 @@ public:
 
     static void trackProcessWaitTime(float time);
     static float getAverageProcessWaitTime() { return _averageProcessWaitTime.getAverage(); }
+
+    static void trackVersionAge(float age) { _averageVersionAge.updateAverage(age); }
+    static float getAverageVersionAge() { return _averageVersionAge.getAverage(); }
     
     // these methods allow us to track which threads got to various states
     static void didProcess(OctreeSendThread* thread);
@@ -128,8 +137,15 @@ public slots:
     void readPendingDatagrams() { }; // this will not be called since our datagram processing thread will handle
     void readPendingDatagram(const QByteArray& receivedPacket, const HifiSockAddr& senderSockAddr);
 
+private slots:
+    void startVersionPublisher();
+
 protected:
     virtual Octree* createTree() = 0;
+
+    /// Subclasses whose tree can journal its changes return an empty tree of the same type here, send threads then
+    /// encode from copies of the tree kept up to date by a version publisher, and edits never wait on them
+    virtual Octree* createVersionTree() { return NULL; }
     bool readOptionBool(const QString& optionName, const QJsonObject& settingsSectionObject, bool& result);
     bool readOptionInt(const QString& optionName, const QJsonObject& settingsSectionObject, int& result);
     bool readOptionString(const QString& optionName, const QJsonObject& settingsSectionObject, QString& result);
@@ -144,6 +160,7 @@ protected:
     QString getStatusLink();
 
     void setupDatagramProcessingThread();
+    void openSharedPortReceivers();
 
     int _argc;
     const char** _argv;
@@ -160,6 +177,8 @@ protected:
     QString _persistAsFileType;
     int _packetsPerClientPerInterval;
     int _packetsTotalPerInterval;
+    int _numReceiveSockets;
+    OctreeServerDatagramProcessor* _datagramProcessor;
     Octree* _tree; // this IS a reaveraging tree
     bool _wantPersist;
     bool _debugSending;
@@ -170,6 +189,7 @@ protected:
     JurisdictionSender* _jurisdictionSender;
     OctreeInboundPacketProcessor* _octreeInboundPacketProcessor;
     OctreePersistThread* _persistThread;
+    OctreeVersionPublisher* _versionPublisher;
     
     int _persistInterval;
     bool _wantBackup;
@@ -229,6 +249,8 @@ protected:
     static int _shortProcessWait;
     static int _noProcessWait;
 
+    static SimpleMovingAverage _averageVersionAge;
+
     static QMap<OctreeSendThread*, quint64> _threadsDidProcess;
     static QMap<OctreeSendThread*, quint64> _threadsDidPacketDistributor;
     static QMap<OctreeSendThread*, quint64> _threadsDidHandlePacketSend;
@@ -46,10 +46,17 @@ void OctreeServerDatagramProcessor::readPendingDatagrams() {
         PacketType packetType = packetTypeForPacket(incomingPacket);
         if (packetType == PacketTypePing) {
             DependencyManager::get<NodeList>()->processNodeData(senderSockAddr, incomingPacket);
-            return; // don't emit
+            continue; // don't emit, but keep reading so that draining the socket empties it
         }
         
         // emit the signal to tell AudioMixer it needs to process a packet
         emit packetRequiresProcessing(incomingPacket, senderSockAddr);
     }
 }
+
+void OctreeServerDatagramProcessor::openSharedPortReceivers(int numReceiveSockets) {
+    // anything still queued on the node socket would be lost when it is rebound
+    readPendingDatagrams();
+
+    DependencyManager::get<NodeList>()->openSharedPortReceivers(numReceiveSockets);
+}
@@ -22,6 +22,10 @@ public:
     ~OctreeServerDatagramProcessor();
 public slots:
     void readPendingDatagrams();
+
+    /// drains the node socket and then shares its port with more receive sockets, see
+    /// LimitedNodeList::openSharedPortReceivers. Runs on our thread, which owns the node socket.
+    void openSharedPortReceivers(int numReceiveSockets);
 signals:
     void packetRequiresProcessing(const QByteArray& receivedPacket, const HifiSockAddr& senderSockAddr);
 private:
@@ -22,6 +22,7 @@
 #include <QStandardPaths>
 #include <QTimer>
 #include <QUrlQuery>
+#include <QtEndian>
 
 #include <AccountManager.h>
 #include <HifiConfigVariantMap.h>
@@ -48,6 +49,9 @@ const QString MAXIMUM_USER_CAPACITY = "security.maximum_user_capacity";
 const QString ALLOWED_EDITORS_SETTINGS_KEYPATH = "security.allowed_editors";
 const QString EDITORS_ARE_REZZERS_KEYPATH = "security.editors_are_rezzers";
 
+// a delta with more removals than this isn't worth much over the full list
+const int MAX_DOMAIN_LIST_DELTA_REMOVALS = 64;
+
 DomainServer::DomainServer(int argc, char* argv[]) :
     QCoreApplication(argc, argv),
     _httpManager(DOMAIN_SERVER_HTTP_PORT, QString("%1/resources/web/").arg(QCoreApplication::applicationDirPath()), this),
@@ -63,7 +67,10 @@ DomainServer::DomainServer(int argc, char* argv[]) :
     _cookieSessionHash(),
     _automaticNetworkingSetting(),
     _settingsManager(),
-    _iceServerSocket(ICE_SERVER_DEFAULT_HOSTNAME, ICE_SERVER_DEFAULT_PORT)
+    _iceServerSocket(ICE_SERVER_DEFAULT_HOSTNAME, ICE_SERVER_DEFAULT_PORT),
+    _domainListVersion(1),
+    _oldestDomainListDeltaVersion(1),
+    _domainListRemovals()
 {
     LogUtils::init();
     Setting::init();
@@ -696,6 +703,7 @@ void DomainServer::handleConnectRequest(const QByteArray& packet, const HifiSock
         }
 
         nodeData->setSendingSockAddr(senderSockAddr);
+        refreshDomainListEntry(newNode);
 
         // reply back to the user with a PacketTypeDomainList
         sendDomainListToNode(newNode, senderSockAddr, nodeInterestList.toSet());
@@ -931,19 +939,44 @@ NodeSet DomainServer::nodeInterestListFromPacket(const QByteArray& packet, int n
 }
 
 void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr,
-                                        const NodeSet& nodeInterestList) {
+                                        const NodeSet& nodeInterestList, quint32 knownDomainListVersion) {
     auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
     QByteArray broadcastPacket = limitedNodeList->byteArrayWithPopulatedHeader(PacketTypeDomainList);
 
+    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+
+    // a node holding a version we still have all the removals since gets what changed after it, anyone else
+    // gets every node. Nodes we don't send other nodes to don't hold any version of the list.
+    bool canSendDelta = knownDomainListVersion != 0 && knownDomainListVersion >= _oldestDomainListDeltaVersion
+        && knownDomainListVersion <= _domainListVersion;
+    quint32 fromVersion = canSendDelta ? knownDomainListVersion : 0;
+    quint32 toVersion = nodeData->isAuthenticated() ? _domainListVersion : 0;
+
     // always send the node their own UUID back
     QDataStream broadcastDataStream(&broadcastPacket, QIODevice::Append);
     broadcastDataStream << node->getUUID();
     broadcastDataStream << node->getCanAdjustLocks();
     broadcastDataStream << node->getCanRez();
+    broadcastDataStream << fromVersion << toVersion;
 
+    // the packet number and count are filled in once all of the packets are built
+    int packetNumberOffset = broadcastDataStream.device()->pos();
+    broadcastDataStream << (quint16)0 << (quint16)0;
     int numBroadcastPacketLeadBytes = broadcastDataStream.device()->pos();
 
-    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+    // the nodes that left since the version the node holds only go in the first packet
+    QVector<QUuid> removedNodeUUIDs;
+    if (fromVersion != 0 && toVersion != 0) {
+        foreach (const DomainListRemoval& removal, _domainListRemovals) {
+            if (removal.version > fromVersion && nodeInterestList.contains(removal.nodeType)) {
+                removedNodeUUIDs.append(removal.nodeUUID);
+            }
+        }
+    }
+    broadcastDataStream << (quint16)removedNodeUUIDs.size();
+    foreach (const QUuid& removedNodeUUID, removedNodeUUIDs) {
+        broadcastDataStream << removedNodeUUID;
+    }
 
     // if we've established a connection via ICE with this peer, use that socket
     // otherwise just try to reply back to them on their sending socket (although that may not work)
@@ -952,6 +985,8 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
         destinationSockAddr = senderSockAddr;
     }
 
+    QList<QByteArray> broadcastPackets;
+
     if (nodeInterestList.size() > 0) {
 
 //        DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
@@ -960,14 +995,13 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
         if (nodeData->isAuthenticated()) {
             // if this authenticated node has any interest types, send back those nodes as well
             limitedNodeList->eachNode([&](const SharedNodePointer& otherNode){
-                // reset our nodeByteArray and nodeDataStream
-                QByteArray nodeByteArray;
-                QDataStream nodeDataStream(&nodeByteArray, QIODevice::Append);
-
                 if (otherNode->getUUID() != node->getUUID() && nodeInterestList.contains(otherNode->getType())) {
+                    DomainServerNodeData* otherNodeData = reinterpret_cast<DomainServerNodeData*>(otherNode->getLinkedData());
 
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    nodeDataStream << *otherNode.data();
+                    if (fromVersion != 0 && otherNodeData->getDomainListEntryVersion() <= fromVersion) {
+                        // the node already has this one
+                        return;
+                    }
 
                     // pack the secret that these two nodes will use to communicate with each other
                     QUuid secretUUID = nodeData->getSessionSecretHash().value(otherNode->getUUID());
@@ -979,33 +1013,56 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
                         nodeData->getSessionSecretHash().insert(otherNode->getUUID(), secretUUID);
 
                         // set it on the other Node's sessionSecretHash
-                        reinterpret_cast<DomainServerNodeData*>(otherNode->getLinkedData())
-                        ->getSessionSecretHash().insert(node->getUUID(), secretUUID);
-
+                        otherNodeData->getSessionSecretHash().insert(node->getUUID(), secretUUID);
                     }
 
-                    nodeDataStream << secretUUID;
+                    const QByteArray& nodeEntry = otherNodeData->getDomainListEntry();
 
-                    if (broadcastPacket.size() +  nodeByteArray.size() > dataMTU) {
+                    if (broadcastPacket.size() + nodeEntry.size() + NUM_BYTES_RFC4122_UUID > dataMTU) {
                         // we need to break here and start a new packet
-                        // so send the current one
-
-                        limitedNodeList->writeUnverifiedDatagram(broadcastPacket, node, senderSockAddr);
+                        broadcastPackets.append(broadcastPacket);
 
-                        // reset the broadcastPacket structure
+                        // reset the broadcastPacket structure, the later packets don't carry removed nodes
                         broadcastPacket.resize(numBroadcastPacketLeadBytes);
-                        broadcastDataStream.device()->seek(numBroadcastPacketLeadBytes);
+                        broadcastPacket.append(sizeof(quint16), 0);
                     }
 
-                    // append the nodeByteArray to the current state of broadcastDataStream
-                    broadcastPacket.append(nodeByteArray);
+                    // don't send avatar nodes to other avatars, that will come from avatar mixer
+                    broadcastPacket.append(nodeEntry);
+                    broadcastPacket.append(secretUUID.toRfc4122());
                 }
             });
         }
     }
 
     // always write the last broadcastPacket
-    limitedNodeList->writeUnverifiedDatagram(broadcastPacket, node, senderSockAddr);
+    broadcastPackets.append(broadcastPacket);
+
+    // now that we know how many packets there are, number them so the node knows when it has the whole version
+    quint16 numPackets = broadcastPackets.size();
+    for (quint16 i = 0; i < numPackets; i++) {
+        QByteArray& packet = broadcastPackets[i];
+        qToBigEndian(i, reinterpret_cast<uchar*>(packet.data() + packetNumberOffset));
+        qToBigEndian(numPackets, reinterpret_cast<uchar*>(packet.data() + packetNumberOffset + sizeof(quint16)));
+
+        limitedNodeList->writeUnverifiedDatagram(packet, node, senderSockAddr);
+    }
+}
+
+void DomainServer::refreshDomainListEntry(const SharedNodePointer& node) {
+    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+    if (!nodeData) {
+        return;
+    }
+
+    QByteArray nodeEntry;
+    QDataStream nodeDataStream(&nodeEntry, QIODevice::Append);
+    nodeDataStream << *node.data();
+
+    // only a change to the entry makes a new version of the domain list
+    if (nodeEntry != nodeData->getDomainListEntry()) {
+        nodeData->setDomainListEntry(nodeEntry, ++_domainListVersion);
+    }
 }
 
 void DomainServer::readAvailableDatagrams() {
@@ -1388,15 +1445,17 @@ void DomainServer::processDatagram(const QByteArray& receivedPacket, const HifiS
                     SharedNodePointer checkInNode = nodeList->nodeWithUUID(nodeUUID);
                     checkInNode->setPublicSocket(nodePublicAddress);
                     checkInNode->setLocalSocket(nodeLocalAddress);
+                    refreshDomainListEntry(checkInNode);
 
                     // update last receive to now
                     quint64 timeNow = usecTimestampNow();
                     checkInNode->setLastHeardMicrostamp(timeNow);
 
                     QList<NodeType_t> nodeInterestList;
-                    packetStream >> nodeInterestList;
+                    quint32 knownDomainListVersion;
+                    packetStream >> nodeInterestList >> knownDomainListVersion;
 
-                    sendDomainListToNode(checkInNode, senderSockAddr, nodeInterestList.toSet());
+                    sendDomainListToNode(checkInNode, senderSockAddr, nodeInterestList.toSet(), knownDomainListVersion);
                 }
 
                 break;
@@ -2083,6 +2142,7 @@ void DomainServer::refreshStaticAssignmentAndAddToQueue(SharedAssignmentPointer&
 void DomainServer::nodeAdded(SharedNodePointer node) {
     // we don't use updateNodeWithData, so add the DomainServerNodeData to the node here
     node->setLinkedData(new DomainServerNodeData());
+    refreshDomainListEntry(node);
 }
 
 void DomainServer::nodeKilled(SharedNodePointer node) {
@@ -2091,6 +2151,13 @@ void DomainServer::nodeKilled(SharedNodePointer node) {
     _connectingICEPeers.remove(node->getUUID());
     _connectedICEPeers.remove(node->getUUID());
 
+    // remember the removal for domain list deltas, once we forget one the nodes that didn't hear about it get full lists
+    DomainListRemoval removal = { ++_domainListVersion, node->getUUID(), node->getType() };
+    _domainListRemovals.append(removal);
+    if (_domainListRemovals.size() > MAX_DOMAIN_LIST_DELTA_REMOVALS) {
+        _oldestDomainListDeltaVersion = _domainListRemovals.takeFirst().version;
+    }
+
     DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
 
     if (nodeData) {
@@ -34,6 +34,13 @@
 typedef QSharedPointer<Assignment> SharedAssignmentPointer;
 typedef QMultiHash<QUuid, WalletTransaction*> TransactionHash;
 
+/// a node that left the domain, kept so that domain list deltas can tell nodes holding an older list about it
+struct DomainListRemoval {
+    quint32 version;
+    QUuid nodeUUID;
+    NodeType_t nodeType;
+};
+
 
 class DomainServer : public QCoreApplication, public HTTPSRequestHandler {
     Q_OBJECT
@@ -100,7 +107,8 @@ private:
                                    const HifiSockAddr& senderSockAddr);
     NodeSet nodeInterestListFromPacket(const QByteArray& packet, int numPreceedingBytes);
     void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr,
-                              const NodeSet& nodeInterestList);
+                              const NodeSet& nodeInterestList, quint32 knownDomainListVersion = 0);
+    void refreshDomainListEntry(const SharedNodePointer& node);
 
     void parseAssignmentConfigs(QSet<Assignment::Type>& excludedTypes);
     void addStaticAssignmentToAssignmentHash(Assignment* newAssignment);
@@ -159,6 +167,11 @@ private:
     DomainServerSettingsManager _settingsManager;
 
     HifiSockAddr _iceServerSocket;
+
+    // bumped each time a node is added, removed or changes how it's written in the domain list
+    quint32 _domainListVersion;
+    quint32 _oldestDomainListDeltaVersion;
+    QList<DomainListRemoval> _domainListRemovals;
 };
 
 
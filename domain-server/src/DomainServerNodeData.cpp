@@ -26,7 +26,9 @@ DomainServerNodeData::DomainServerNodeData() :
     _paymentIntervalTimer(),
     _statsJSONObject(),
     _sendingSockAddr(),
-    _isAuthenticated(true)
+    _isAuthenticated(true),
+    _domainListEntry(),
+    _domainListEntryVersion(0)
 {
     _paymentIntervalTimer.start();
 }
@@ -47,6 +47,14 @@ public:
     bool isAuthenticated() const { return _isAuthenticated; }
     
     QHash<QUuid, QUuid>& getSessionSecretHash() { return _sessionSecretHash; }
+
+    /// this node as it's written in domain lists, serialized once when it changes and reused for every recipient
+    void setDomainListEntry(const QByteArray& entry, quint32 version)
+        { _domainListEntry = entry; _domainListEntryVersion = version; }
+    const QByteArray& getDomainListEntry() const { return _domainListEntry; }
+
+    /// the domain list version in which this node's entry last changed
+    quint32 getDomainListEntryVersion() const { return _domainListEntryVersion; }
 private:
     QJsonObject mergeJSONStatsFromNewObject(const QJsonObject& newObject, QJsonObject destinationObject);
     
@@ -58,6 +66,8 @@ private:
     QJsonObject _statsJSONObject;
     HifiSockAddr _sendingSockAddr;
     bool _isAuthenticated;
+    QByteArray _domainListEntry;
+    quint32 _domainListEntryVersion;
 };
 
 #endif // hifi_DomainServerNodeData_h
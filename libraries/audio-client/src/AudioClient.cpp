@@ -40,6 +40,7 @@ extern "C" {
 
 #include <soxr.h>
 
+#include <AudioCodec.h>
 #include <NodeList.h>
 #include <PacketHeaders.h>
 #include <PositionalAudioStream.h>
@@ -713,13 +714,8 @@ void AudioClient::handleLocalEchoAndReverb(QByteArray& inputByteArray) {
 void AudioClient::handleAudioInput() {
     static char audioDataPacket[MAX_PACKET_SIZE];
 
-    static int numBytesPacketHeader = numBytesForPacketHeaderGivenPacketType(PacketTypeMicrophoneAudioNoEcho);
-
-    // NOTE: we assume PacketTypeMicrophoneAudioWithEcho has same size headers as
-    // PacketTypeMicrophoneAudioNoEcho.  If not, then networkAudioSamples will be pointing to the wrong place for writing
-    // audio samples with echo.
-    static int leadingBytes = numBytesPacketHeader + sizeof(quint16) + sizeof(glm::vec3) + sizeof(glm::quat) + sizeof(quint8);
-    static int16_t* networkAudioSamples = (int16_t*)(audioDataPacket + leadingBytes);
+    // the samples are encoded into the packet once we know it isn't silent
+    static int16_t networkAudioSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
 
     float inputToNetworkInputRatio = calculateDeviceToNetworkInputRatio();
 
@@ -857,6 +853,9 @@ void AudioClient::handleAudioInput() {
                 memcpy(currentPacketPtr, &headOrientation, sizeof(headOrientation));
                 currentPacketPtr += sizeof(headOrientation);
 
+                // let the mixer know which codec to send our mix in
+                *currentPacketPtr++ = AudioCodec::DEFAULT_CODEC;
+
             } else {
                 // set the mono/stereo byte
                 *currentPacketPtr++ = isStereo;
@@ -869,8 +868,12 @@ void AudioClient::handleAudioInput() {
                 memcpy(currentPacketPtr, &headOrientation, sizeof(headOrientation));
                 currentPacketPtr += sizeof(headOrientation);
 
-                // audio samples have already been packed (written to networkAudioSamples)
-                currentPacketPtr += numNetworkBytes;
+                // let the mixer know which codec to send our mix in
+                *currentPacketPtr++ = AudioCodec::DEFAULT_CODEC;
+
+                // encode the audio samples we wrote to networkAudioSamples
+                currentPacketPtr += AudioCodec::encodeFrame(AudioCodec::DEFAULT_CODEC, networkAudioSamples,
+                                                            numNetworkSamples, _isStereoInput ? 2 : 1, currentPacketPtr);
             }
 
             _stats.sentPacket();
@@ -0,0 +1,306 @@
+//
+//  AudioCodec.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "AudioCodec.h"
+
+static PCMAudioCodec pcmCodec;
+static DeltaRiceAudioCodec deltaRiceCodec;
+
+static AudioCodec* registeredCodecs[std::numeric_limits<quint8>::max() + 1] = { &pcmCodec, &deltaRiceCodec };
+
+void AudioCodec::registerCodec(AudioCodec* codec) {
+    registeredCodecs[codec->getID()] = codec;
+}
+
+AudioCodec* AudioCodec::getCodec(quint8 codecID) {
+    return registeredCodecs[codecID];
+}
+
+int AudioCodec::encodeFrame(quint8 codecID, const int16_t* samples, int numSamples, int numChannels, char* destination) {
+    int pcmBytes = numSamples * sizeof(int16_t);
+    char* payload = destination + FRAME_HEADER_BYTES;
+
+    int payloadBytes = -1;
+    AudioCodec* codec = getCodec(codecID);
+    if (codec && codecID != PCM) {
+        // the codec only gets as much room as the raw samples would take, if it can't beat that we send those
+        payloadBytes = codec->encode(samples, numSamples, numChannels, payload, pcmBytes - 1);
+    }
+
+    if (payloadBytes < 0) {
+        codecID = PCM;
+        payloadBytes = pcmCodec.encode(samples, numSamples, numChannels, payload, pcmBytes);
+    }
+
+    quint16 frameSamples = numSamples;
+    destination[0] = codecID;
+    memcpy(destination + sizeof(quint8), &frameSamples, sizeof(quint16));
+
+    return FRAME_HEADER_BYTES + payloadBytes;
+}
+
+int AudioCodec::samplesInFrame(const char* frame, int numBytes) {
+    if (numBytes < FRAME_HEADER_BYTES) {
+        return 0;
+    }
+    quint16 frameSamples;
+    memcpy(&frameSamples, frame + sizeof(quint8), sizeof(quint16));
+    return frameSamples;
+}
+
+quint8 AudioCodec::codecForFrame(const char* frame, int numBytes) {
+    return (numBytes > 0) ? (quint8)frame[0] : (quint8)PCM;
+}
+
+int AudioCodec::decodeFrame(const char* frame, int numBytes, int16_t* samples, int maxSamples, int numChannels) {
+    int numSamples = samplesInFrame(frame, numBytes);
+    AudioCodec* codec = getCodec(codecForFrame(frame, numBytes));
+
+    if (numBytes < FRAME_HEADER_BYTES || !codec || numSamples > maxSamples) {
+        return -1;
+    }
+
+    int payloadBytes = codec->decode(frame + FRAME_HEADER_BYTES, numBytes - FRAME_HEADER_BYTES,
+                                     samples, numSamples, numChannels);
+    return (payloadBytes < 0) ? -1 : FRAME_HEADER_BYTES + payloadBytes;
+}
+
+int PCMAudioCodec::encode(const int16_t* samples, int numSamples, int numChannels, char* destination, int maxBytes) const {
+    int numBytes = numSamples * sizeof(int16_t);
+    if (numBytes > maxBytes) {
+        return -1;
+    }
+    memcpy(destination, samples, numBytes);
+    return numBytes;
+}
+
+int PCMAudioCodec::decode(const char* data, int numBytes, int16_t* samples, int numSamples, int numChannels) const {
+    int numSampleBytes = numSamples * sizeof(int16_t);
+    if (numSampleBytes > numBytes) {
+        return -1;
+    }
+    memcpy(samples, data, numSampleBytes);
+    return numSampleBytes;
+}
+
+// the Rice parameter is picked again for every block of this many samples
+const int RICE_BLOCK_SAMPLES = 64;
+const int RICE_PARAMETER_BITS = 5;
+const int MAX_RICE_PARAMETER = 16;
+
+// a quotient this large is sent as this many one bits followed by the raw residual
+const int RICE_ESCAPE_QUOTIENT = 16;
+const int RAW_RESIDUAL_BITS = 17;
+
+// residuals of 16-bit samples need 17 bits, folding the sign into the low bit keeps small magnitudes small
+static inline quint32 zigzagEncode(int residual) {
+    return (residual >= 0) ? (quint32)residual << 1 : ((quint32)(-residual) << 1) - 1;
+}
+
+static inline int zigzagDecode(quint32 value) {
+    return (value & 1) ? -(int)((value + 1) >> 1) : (int)(value >> 1);
+}
+
+class RiceBitWriter {
+public:
+    RiceBitWriter(char* destination, int maxBytes) :
+        _destination(reinterpret_cast<uchar*>(destination)),
+        _maxBytes(maxBytes),
+        _numBytes(0),
+        _accumulator(0),
+        _numBits(0)
+    {}
+
+    bool hasOverflowed() const { return _numBytes > _maxBytes; }
+
+    void write(quint32 value, int numBits) {
+        _accumulator = (_accumulator << numBits) | (value & ((1u << numBits) - 1));
+        _numBits += numBits;
+        while (_numBits >= 8) {
+            _numBits -= 8;
+            putByte((uchar)(_accumulator >> _numBits));
+        }
+    }
+
+    void writeOnes(int count) {
+        const int MAX_BITS_PER_WRITE = 24;
+        while (count > 0) {
+            int numBits = std::min(count, MAX_BITS_PER_WRITE);
+            write((1u << numBits) - 1, numBits);
+            count -= numBits;
+        }
+    }
+
+    /// flushes the last partial byte, returns the number of bytes written or -1 if they didn't fit
+    int finish() {
+        if (_numBits > 0) {
+            putByte((uchar)(_accumulator << (8 - _numBits)));
+            _numBits = 0;
+        }
+        return hasOverflowed() ? -1 : _numBytes;
+    }
+
+private:
+    void putByte(uchar byte) {
+        if (_numBytes < _maxBytes) {
+            _destination[_numBytes] = byte;
+        }
+        _numBytes++;
+    }
+
+    uchar* _destination;
+    int _maxBytes;
+    int _numBytes;
+    quint64 _accumulator;
+    int _numBits;
+};
+
+class RiceBitReader {
+public:
+    RiceBitReader(const char* data, int numBytes) :
+        _data(reinterpret_cast<const uchar*>(data)),
+        _numBytes(numBytes),
+        _position(0),
+        _accumulator(0),
+        _numBits(0)
+    {}
+
+    int getBytesRead() const { return _position; }
+
+    bool read(int numBits, quint32& value) {
+        while (_numBits < numBits) {
+            if (_position >= _numBytes) {
+                return false;
+            }
+            _accumulator = (_accumulator << 8) | _data[_position++];
+            _numBits += 8;
+        }
+        _numBits -= numBits;
+        value = (quint32)(_accumulator >> _numBits) & ((1u << numBits) - 1);
+        return true;
+    }
+
+    /// counts one bits up to a zero bit (which is consumed) or until maxCount ones have been read
+    bool readOnes(int maxCount, int& count) {
+        count = 0;
+        quint32 bit;
+        while (count < maxCount) {
+            if (!read(1, bit)) {
+                return false;
+            }
+            if (!bit) {
+                break;
+            }
+            count++;
+        }
+        return true;
+    }
+
+private:
+    const uchar* _data;
+    int _numBytes;
+    int _position;
+    quint64 _accumulator;
+    int _numBits;
+};
+
+static inline int residualForSample(const int16_t* samples, int index, int numChannels) {
+    int previous = (index >= numChannels) ? samples[index - numChannels] : 0;
+    return samples[index] - previous;
+}
+
+int DeltaRiceAudioCodec::encode(const int16_t* samples, int numSamples, int numChannels,
+                                char* destination, int maxBytes) const {
+    RiceBitWriter writer(destination, maxBytes);
+
+    for (int blockStart = 0; blockStart < numSamples; blockStart += RICE_BLOCK_SAMPLES) {
+        int blockEnd = std::min(blockStart + RICE_BLOCK_SAMPLES, numSamples);
+        int blockSamples = blockEnd - blockStart;
+
+        // pick the parameter that puts 2^k around the mean residual
+        quint64 residualSum = 0;
+        for (int i = blockStart; i < blockEnd; i++) {
+            residualSum += zigzagEncode(residualForSample(samples, i, numChannels));
+        }
+        int riceParameter = 0;
+        while (riceParameter < MAX_RICE_PARAMETER && ((quint64)blockSamples << riceParameter) < residualSum) {
+            riceParameter++;
+        }
+        writer.write(riceParameter, RICE_PARAMETER_BITS);
+
+        for (int i = blockStart; i < blockEnd; i++) {
+            quint32 value = zigzagEncode(residualForSample(samples, i, numChannels));
+            quint32 quotient = value >> riceParameter;
+
+            if (quotient < (quint32)RICE_ESCAPE_QUOTIENT) {
+                writer.writeOnes(quotient);
+                writer.write(0, 1);
+                if (riceParameter > 0) {
+                    writer.write(value, riceParameter);
+                }
+            } else {
+                writer.writeOnes(RICE_ESCAPE_QUOTIENT);
+                writer.write(value, RAW_RESIDUAL_BITS);
+            }
+        }
+
+        if (writer.hasOverflowed()) {
+            // no point encoding the rest, this frame will go out as PCM
+            return -1;
+        }
+    }
+
+    return writer.finish();
+}
+
+int DeltaRiceAudioCodec::decode(const char* data, int numBytes, int16_t* samples, int numSamples, int numChannels) const {
+    RiceBitReader reader(data, numBytes);
+
+    for (int blockStart = 0; blockStart < numSamples; blockStart += RICE_BLOCK_SAMPLES) {
+        int blockEnd = std::min(blockStart + RICE_BLOCK_SAMPLES, numSamples);
+
+        quint32 riceParameter;
+        if (!reader.read(RICE_PARAMETER_BITS, riceParameter) || riceParameter > (quint32)MAX_RICE_PARAMETER) {
+            return -1;
+        }
+
+        for (int i = blockStart; i < blockEnd; i++) {
+            int quotient;
+            if (!reader.readOnes(RICE_ESCAPE_QUOTIENT, quotient)) {
+                return -1;
+            }
+
+            quint32 value;
+            if (quotient < RICE_ESCAPE_QUOTIENT) {
+                quint32 remainder = 0;
+                if (riceParameter > 0 && !reader.read(riceParameter, remainder)) {
+                    return -1;
+                }
+                value = ((quint32)quotient << riceParameter) | remainder;
+            } else if (!reader.read(RAW_RESIDUAL_BITS, value)) {
+                return -1;
+            }
+
+            int previous = (i >= numChannels) ? samples[i - numChannels] : 0;
+            int sample = previous + zigzagDecode(value);
+            if (sample < std::numeric_limits<int16_t>::min() || sample > std::numeric_limits<int16_t>::max()) {
+                return -1;
+            }
+            samples[i] = sample;
+        }
+    }
+
+    return reader.getBytesRead();
+}
@@ -0,0 +1,88 @@
+//
+//  AudioCodec.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioCodec_h
+#define hifi_AudioCodec_h
+
+#include <stdint.h>
+
+#include <QtCore/QtGlobal>
+
+/// Encodes and decodes the audio carried by mic, injector and mixed audio packets. Each frame of audio in a packet
+/// is sent as a small header naming the codec and the number of samples, followed by the codec's payload. Senders
+/// always fall back to PCM when a codec can't beat it, so any receiver can decode any frame of a codec it knows.
+class AudioCodec {
+public:
+    enum ID {
+        PCM = 0,
+        DeltaRice,
+        NUM_BUILT_IN_CODECS
+    };
+
+    static const quint8 DEFAULT_CODEC = DeltaRice;
+    static const int FRAME_HEADER_BYTES = sizeof(quint8) + sizeof(quint16);
+
+    virtual ~AudioCodec() {}
+
+    virtual quint8 getID() const = 0;
+    virtual const char* getName() const = 0;
+
+    /// encodes interleaved samples into destination, returns the number of bytes written or -1 if they don't fit
+    virtual int encode(const int16_t* samples, int numSamples, int numChannels, char* destination, int maxBytes) const = 0;
+
+    /// decodes numSamples interleaved samples, returns the number of bytes read or -1 if the data is malformed
+    virtual int decode(const char* data, int numBytes, int16_t* samples, int numSamples, int numChannels) const = 0;
+
+    /// makes a codec available to encodeFrame and decodeFrame under its ID, call this before any audio is sent
+    static void registerCodec(AudioCodec* codec);
+
+    /// returns the codec registered with this ID, or NULL if there isn't one
+    static AudioCodec* getCodec(quint8 codecID);
+
+    /// the most bytes encodeFrame can write for a frame of numSamples
+    static int maxEncodedFrameBytes(int numSamples) { return FRAME_HEADER_BYTES + numSamples * sizeof(int16_t); }
+
+    /// writes a frame header and the samples encoded with codecID (or PCM if that codec doesn't make them smaller),
+    /// returns the number of bytes written
+    static int encodeFrame(quint8 codecID, const int16_t* samples, int numSamples, int numChannels, char* destination);
+
+    /// returns the number of samples in the encoded frame, or 0 if there isn't a complete frame header
+    static int samplesInFrame(const char* frame, int numBytes);
+
+    /// returns the ID of the codec an encoded frame was written with
+    static quint8 codecForFrame(const char* frame, int numBytes);
+
+    /// decodes a frame into samples, which needs room for samplesInFrame samples,
+    /// returns the number of bytes read or -1 if the frame can't be decoded
+    static int decodeFrame(const char* frame, int numBytes, int16_t* samples, int maxSamples, int numChannels);
+};
+
+/// raw 16-bit samples, every receiver can decode these
+class PCMAudioCodec : public AudioCodec {
+public:
+    virtual quint8 getID() const { return PCM; }
+    virtual const char* getName() const { return "pcm"; }
+
+    virtual int encode(const int16_t* samples, int numSamples, int numChannels, char* destination, int maxBytes) const;
+    virtual int decode(const char* data, int numBytes, int16_t* samples, int numSamples, int numChannels) const;
+};
+
+/// Lossless codec cheap enough to run once per listener per frame - each channel is predicted from its previous sample
+/// and the residuals are Rice coded, with the Rice parameter picked per block of samples.
+class DeltaRiceAudioCodec : public AudioCodec {
+public:
+    virtual quint8 getID() const { return DeltaRice; }
+    virtual const char* getName() const { return "delta-rice"; }
+
+    virtual int encode(const int16_t* samples, int numSamples, int numChannels, char* destination, int maxBytes) const;
+    virtual int decode(const char* data, int numBytes, int16_t* samples, int numSamples, int numChannels) const;
+};
+
+#endif // hifi_AudioCodec_h
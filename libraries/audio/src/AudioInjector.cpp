@@ -18,6 +18,7 @@
 #include <UUID.h>
 
 #include "AbstractAudioInterface.h"
+#include "AudioCodec.h"
 #include "AudioRingBuffer.h"
 #include "AudioLogging.h"
 
@@ -216,16 +217,21 @@ void AudioInjector::injectToMixer() {
             volume = MAX_INJECTOR_VOLUME * _options.volume;
             memcpy(injectAudioPacket.data() + volumeOptionOffset, &volume, sizeof(volume));
             
-            // resize the QByteArray to the right size
-            injectAudioPacket.resize(numPreAudioDataBytes + bytesToCopy);
+            // resize the QByteArray to fit the largest frame we could encode
+            int numSamplesToEncode = bytesToCopy / sizeof(int16_t);
+            injectAudioPacket.resize(numPreAudioDataBytes + AudioCodec::maxEncodedFrameBytes(numSamplesToEncode));
 
             // pack the sequence number
             memcpy(injectAudioPacket.data() + numPreSequenceNumberBytes,
                    &outgoingInjectedAudioSequenceNumber, sizeof(quint16));
             
-            // copy the next NETWORK_BUFFER_LENGTH_BYTES_PER_CHANNEL bytes to the packet
-            memcpy(injectAudioPacket.data() + numPreAudioDataBytes,
-                   _audioData.data() + _currentSendPosition, bytesToCopy);
+            // encode the next NETWORK_BUFFER_LENGTH_BYTES_PER_CHANNEL bytes into the packet
+            int numEncodedBytes = AudioCodec::encodeFrame(AudioCodec::DEFAULT_CODEC,
+                                                          reinterpret_cast<const int16_t*>(_audioData.data()
+                                                                                           + _currentSendPosition),
+                                                          numSamplesToEncode, _options.stereo ? 2 : 1,
+                                                          injectAudioPacket.data() + numPreAudioDataBytes);
+            injectAudioPacket.resize(numPreAudioDataBytes + numEncodedBytes);
             
             // grab our audio mixer from the NodeList, if it exists
             SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
@@ -0,0 +1,336 @@
+//
+//  AudioMixKernels.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "AudioMixKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define AUDIO_MIX_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(AUDIO_MIX_KERNELS_X86) && defined(__GNUC__)
+// lets us compile the vector kernels without raising the instruction set for the rest of the library
+#define AUDIO_MIX_TARGET_SSE2 __attribute__((target("sse2")))
+#define AUDIO_MIX_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define AUDIO_MIX_TARGET_SSE2
+#define AUDIO_MIX_TARGET_AVX2
+#endif
+
+const float MIN_LIMITED_SAMPLE = -32768.0f;
+const float MAX_LIMITED_SAMPLE = 32767.0f;
+
+// how far above the limiter threshold the mix can go before it is at full scale
+const float LIMITER_KNEE_RANGE = 1.0f - MIX_BUS_LIMITER_THRESHOLD;
+
+// the scalar kernels are the reference, the vector versions have to match them exactly
+
+static void scalarAccumulateMonoToStereoChannel(float* destination, const int16_t* source, int numSamples, float gain) {
+    for (int i = 0; i < numSamples; i++) {
+        destination[i * 2] += source[i] * gain;
+    }
+}
+
+static void scalarAccumulateWithGain(float* destination, const int16_t* source, int numSamples, float gain) {
+    for (int i = 0; i < numSamples; i++) {
+        destination[i] += source[i] * gain;
+    }
+}
+
+static void scalarAccumulate(float* destination, const float* source, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        destination[i] += source[i];
+    }
+}
+
+static void scalarLimitToSamples(int16_t* destination, const float* source, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        float sample = source[i];
+
+        // above the threshold the excess is squashed by excess / (excess + range), which starts out at unity slope
+        // and approaches full scale without ever reaching it
+        float excess = std::max(fabsf(sample) - MIX_BUS_LIMITER_THRESHOLD, 0.0f);
+        float reduction = (excess * excess) / (excess + LIMITER_KNEE_RANGE);
+        float limited = (sample < 0.0f) ? sample + reduction : sample - reduction;
+
+        float scaled = std::min(std::max(limited * MIX_BUS_TO_SAMPLE_SCALE, MIN_LIMITED_SAMPLE), MAX_LIMITED_SAMPLE);
+        destination[i] = (int16_t) scaled;
+    }
+}
+
+#ifdef AUDIO_MIX_KERNELS_X86
+
+// SSE2 has no sign extension instruction, so unpack each sample into the high half of a 32-bit lane and shift it down
+AUDIO_MIX_TARGET_SSE2 static inline __m128 sse2SamplesToFloat(__m128i samples) {
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+}
+
+AUDIO_MIX_TARGET_SSE2
+static void sse2AccumulateMonoToStereoChannel(float* destination, const int16_t* source, int numSamples, float gain) {
+    const int SAMPLES_PER_STEP = 4;
+    __m128 gainVector = _mm_set1_ps(gain);
+    __m128 zero = _mm_setzero_ps();
+
+    int i = 0;
+    for (; i + SAMPLES_PER_STEP <= numSamples; i += SAMPLES_PER_STEP) {
+        __m128i input = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + i));
+        __m128 products = _mm_mul_ps(sse2SamplesToFloat(input), gainVector);
+
+        // interleaving the products with zeros leaves the other channel as it was
+        float* output = destination + (i * 2);
+        _mm_storeu_ps(output, _mm_add_ps(_mm_loadu_ps(output), _mm_unpacklo_ps(products, zero)));
+        _mm_storeu_ps(output + 4, _mm_add_ps(_mm_loadu_ps(output + 4), _mm_unpackhi_ps(products, zero)));
+    }
+
+    scalarAccumulateMonoToStereoChannel(destination + (i * 2), source + i, numSamples - i, gain);
+}
+
+AUDIO_MIX_TARGET_SSE2
+static void sse2AccumulateWithGain(float* destination, const int16_t* source, int numSamples, float gain) {
+    const int SAMPLES_PER_STEP = 4;
+    __m128 gainVector = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i + SAMPLES_PER_STEP <= numSamples; i += SAMPLES_PER_STEP) {
+        __m128i input = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + i));
+        __m128 products = _mm_mul_ps(sse2SamplesToFloat(input), gainVector);
+        _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), products));
+    }
+
+    scalarAccumulateWithGain(destination + i, source + i, numSamples - i, gain);
+}
+
+AUDIO_MIX_TARGET_SSE2
+static void sse2Accumulate(float* destination, const float* source, int numSamples) {
+    const int SAMPLES_PER_STEP = 4;
+
+    int i = 0;
+    for (; i + SAMPLES_PER_STEP <= numSamples; i += SAMPLES_PER_STEP) {
+        _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), _mm_loadu_ps(source + i)));
+    }
+
+    scalarAccumulate(destination + i, source + i, numSamples - i);
+}
+
+AUDIO_MIX_TARGET_SSE2 static inline __m128i sse2Limit(__m128 samples) {
+    __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 excess = _mm_max_ps(_mm_sub_ps(_mm_andnot_ps(signMask, samples), _mm_set1_ps(MIX_BUS_LIMITER_THRESHOLD)),
+                               _mm_setzero_ps());
+    __m128 reduction = _mm_div_ps(_mm_mul_ps(excess, excess), _mm_add_ps(excess, _mm_set1_ps(LIMITER_KNEE_RANGE)));
+
+    // giving the reduction the sign of the sample pulls it toward zero from either side
+    __m128 limited = _mm_sub_ps(samples, _mm_or_ps(reduction, _mm_and_ps(signMask, samples)));
+
+    __m128 scaled = _mm_mul_ps(limited, _mm_set1_ps(MIX_BUS_TO_SAMPLE_SCALE));
+    scaled = _mm_min_ps(_mm_max_ps(scaled, _mm_set1_ps(MIN_LIMITED_SAMPLE)), _mm_set1_ps(MAX_LIMITED_SAMPLE));
+    return _mm_cvttps_epi32(scaled);
+}
+
+AUDIO_MIX_TARGET_SSE2
+static void sse2LimitToSamples(int16_t* destination, const float* source, int numSamples) {
+    const int SAMPLES_PER_STEP = 8;
+
+    int i = 0;
+    for (; i + SAMPLES_PER_STEP <= numSamples; i += SAMPLES_PER_STEP) {
+        __m128i low = sse2Limit(_mm_loadu_ps(source + i));
+        __m128i high = sse2Limit(_mm_loadu_ps(source + i + 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packs_epi32(low, high));
+    }
+
+    scalarLimitToSamples(destination + i, source + i, numSamples - i);
+}
+
+AUDIO_MIX_TARGET_AVX2 static inline __m256 avx2SamplesToFloat(__m128i samples) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(samples));
+}
+
+AUDIO_MIX_TARGET_AVX2
+static void avx2AccumulateMonoToStereoChannel(float* destination, const int16_t* source, int numSamples, float gain) {
+    const int SAMPLES_PER_STEP = 8;
+    __m256 gainVector = _mm256_set1_ps(gain);
+    __m256 zero = _mm256_setzero_ps();
+
+    int i = 0;
+    for (; i + SAMPLES_PER_STEP <= numSamples; i += SAMPLES_PER_STEP) {
+        __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        __m256 products = _mm256_mul_ps(avx2SamplesToFloat(input), gainVector);
+
+        // the 256-bit unpacks work within 128-bit lanes, so put the halves back in order afterwards
+        __m256 low = _mm256_unpacklo_ps(products, zero);
+        __m256 high = _mm256_unpackhi_ps(products, zero);
+
+        float* output = destination + (i * 2);
+        _mm256_storeu_ps(output, _mm256_add_ps(_mm256_loadu_ps(output), _mm256_permute2f128_ps(low, high, 0x20)));
+        _mm256_storeu_ps(output + 8, _mm256_add_ps(_mm256_loadu_ps(output + 8), _mm256_permute2f128_ps(low, high, 0x31)));
+    }
+
+    scalarAccumulateMonoToStereoChannel(destination + (i * 2), source + i, numSamples - i, gain);
+}
+
+AUDIO_MIX_TARGET_AVX2
+static void avx2AccumulateWithGain(float* destination, const int16_t* source, int numSamples, float gain) {
+    const int SAMPLES_PER_STEP = 8;
+    __m256 gainVector = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i + SAMPLES_PER_STEP <= numSamples; i += SAMPLES_PER_STEP) {
+        __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        __m256 products = _mm256_mul_ps(avx2SamplesToFloat(input), gainVector);
+        _mm256_storeu_ps(destination + i, _mm256_add_ps(_mm256_loadu_ps(destination + i), products));
+    }
+
+    scalarAccumulateWithGain(destination + i, source + i, numSamples - i, gain);
+}
+
+AUDIO_MIX_TARGET_AVX2
+static void avx2Accumulate(float* destination, const float* source, int numSamples) {
+    const int SAMPLES_PER_STEP = 8;
+
+    int i = 0;
+    for (; i + SAMPLES_PER_STEP <= numSamples; i += SAMPLES_PER_STEP) {
+        _mm256_storeu_ps(destination + i, _mm256_add_ps(_mm256_loadu_ps(destination + i), _mm256_loadu_ps(source + i)));
+    }
+
+    scalarAccumulate(destination + i, source + i, numSamples - i);
+}
+
+AUDIO_MIX_TARGET_AVX2 static inline __m256i avx2Limit(__m256 samples) {
+    __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 excess = _mm256_max_ps(_mm256_sub_ps(_mm256_andnot_ps(signMask, samples),
+                                                _mm256_set1_ps(MIX_BUS_LIMITER_THRESHOLD)),
+                                  _mm256_setzero_ps());
+    __m256 reduction = _mm256_div_ps(_mm256_mul_ps(excess, excess),
+                                     _mm256_add_ps(excess, _mm256_set1_ps(LIMITER_KNEE_RANGE)));
+    __m256 limited = _mm256_sub_ps(samples, _mm256_or_ps(reduction, _mm256_and_ps(signMask, samples)));
+
+    __m256 scaled = _mm256_mul_ps(limited, _mm256_set1_ps(MIX_BUS_TO_SAMPLE_SCALE));
+    scaled = _mm256_min_ps(_mm256_max_ps(scaled, _mm256_set1_ps(MIN_LIMITED_SAMPLE)),
+                           _mm256_set1_ps(MAX_LIMITED_SAMPLE));
+    return _mm256_cvttps_epi32(scaled);
+}
+
+AUDIO_MIX_TARGET_AVX2
+static void avx2LimitToSamples(int16_t* destination, const float* source, int numSamples) {
+    const int SAMPLES_PER_STEP = 16;
+
+    int i = 0;
+    for (; i + SAMPLES_PER_STEP <= numSamples; i += SAMPLES_PER_STEP) {
+        __m256i low = avx2Limit(_mm256_loadu_ps(source + i));
+        __m256i high = avx2Limit(_mm256_loadu_ps(source + i + 8));
+
+        // the 256-bit pack works within 128-bit lanes, so put the quarters back in order afterwards
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), packed);
+    }
+
+    scalarLimitToSamples(destination + i, source + i, numSamples - i);
+}
+
+#endif // AUDIO_MIX_KERNELS_X86
+
+static AudioMixKernels::InstructionSet detectInstructionSet() {
+#if defined(AUDIO_MIX_KERNELS_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return AudioMixKernels::AVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        return AudioMixKernels::SSE2;
+    }
+#elif defined(AUDIO_MIX_KERNELS_X86) && defined(_MSC_VER)
+    const int SSE2_BIT = 1 << 26;
+    const int OSXSAVE_BIT = 1 << 27;
+    const int AVX2_BIT = 1 << 5;
+    const unsigned long long XMM_AND_YMM_STATE = 0x6;
+
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 1);
+    bool hasSSE2 = (cpuInfo[3] & SSE2_BIT) != 0;
+
+    // AVX2 needs both the CPU and the OS (which has to save the YMM registers) on board
+    bool osSavesYMM = (cpuInfo[2] & OSXSAVE_BIT) != 0
+        && (_xgetbv(0) & XMM_AND_YMM_STATE) == XMM_AND_YMM_STATE;
+    __cpuidex(cpuInfo, 7, 0);
+
+    if (osSavesYMM && (cpuInfo[1] & AVX2_BIT) != 0) {
+        return AudioMixKernels::AVX2;
+    } else if (hasSSE2) {
+        return AudioMixKernels::SSE2;
+    }
+#endif
+    return AudioMixKernels::Scalar;
+}
+
+AudioMixKernels::InstructionSet AudioMixKernels::_instructionSet = AudioMixKernels::Scalar;
+AudioMixKernels::GainKernel AudioMixKernels::_accumulateMonoToStereoChannel = scalarAccumulateMonoToStereoChannel;
+AudioMixKernels::GainKernel AudioMixKernels::_accumulateWithGain = scalarAccumulateWithGain;
+AudioMixKernels::Kernel AudioMixKernels::_accumulate = scalarAccumulate;
+AudioMixKernels::LimitKernel AudioMixKernels::_limitToSamples = scalarLimitToSamples;
+
+// pick the widest kernels once the scalar defaults above are in place
+static bool kernelsSelected = AudioMixKernels::setInstructionSet(AudioMixKernels::getSupportedInstructionSet());
+
+AudioMixKernels::InstructionSet AudioMixKernels::getSupportedInstructionSet() {
+    static InstructionSet supportedInstructionSet = detectInstructionSet();
+    return supportedInstructionSet;
+}
+
+AudioMixKernels::InstructionSet AudioMixKernels::getInstructionSet() {
+    return _instructionSet;
+}
+
+bool AudioMixKernels::setInstructionSet(InstructionSet instructionSet) {
+    if (instructionSet > getSupportedInstructionSet()) {
+        return false;
+    }
+
+    switch (instructionSet) {
+#ifdef AUDIO_MIX_KERNELS_X86
+        case AVX2:
+            _accumulateMonoToStereoChannel = avx2AccumulateMonoToStereoChannel;
+            _accumulateWithGain = avx2AccumulateWithGain;
+            _accumulate = avx2Accumulate;
+            _limitToSamples = avx2LimitToSamples;
+            break;
+        case SSE2:
+            _accumulateMonoToStereoChannel = sse2AccumulateMonoToStereoChannel;
+            _accumulateWithGain = sse2AccumulateWithGain;
+            _accumulate = sse2Accumulate;
+            _limitToSamples = sse2LimitToSamples;
+            break;
+#endif
+        default:
+            _accumulateMonoToStereoChannel = scalarAccumulateMonoToStereoChannel;
+            _accumulateWithGain = scalarAccumulateWithGain;
+            _accumulate = scalarAccumulate;
+            _limitToSamples = scalarLimitToSamples;
+            break;
+    }
+
+    _instructionSet = instructionSet;
+    return true;
+}
+
+const char* AudioMixKernels::getInstructionSetName(InstructionSet instructionSet) {
+    switch (instructionSet) {
+        case AVX2:
+            return "AVX2";
+        case SSE2:
+            return "SSE2";
+        default:
+            return "scalar";
+    }
+}
@@ -0,0 +1,77 @@
+//
+//  AudioMixKernels.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernels_h
+#define hifi_AudioMixKernels_h
+
+#include <stdint.h>
+
+// the mix bus holds samples as floats, where 1.0f is the full scale of an int16_t sample
+const float SAMPLE_TO_MIX_BUS_SCALE = 1.0f / 32768.0f;
+const float MIX_BUS_TO_SAMPLE_SCALE = 32768.0f;
+
+// the limiter leaves the mix alone below this level and bends anything louder smoothly toward full scale
+const float MIX_BUS_LIMITER_THRESHOLD = 0.7f;
+
+/// Sample loops used to mix streams for a listener. Each kernel has a scalar version and vectorized SSE2/AVX2 versions
+/// that produce bit-identical output, the widest one the CPU supports is picked at startup.
+class AudioMixKernels {
+public:
+    enum InstructionSet {
+        Scalar = 0,
+        SSE2,
+        AVX2
+    };
+
+    /// the widest instruction set supported by the CPU we're running on
+    static InstructionSet getSupportedInstructionSet();
+
+    static InstructionSet getInstructionSet();
+
+    /// forces the kernels to a given instruction set, returns false if the CPU doesn't support it
+    static bool setInstructionSet(InstructionSet instructionSet);
+
+    static const char* getInstructionSetName(InstructionSet instructionSet);
+
+    /// adds each mono source sample times gain to every other destination sample (one channel of an interleaved
+    /// stereo mix bus). The vector versions add zero to the other channel, so destination needs room for
+    /// numSamples * 2 samples.
+    static void accumulateMonoToStereoChannel(float* destination, const int16_t* source, int numSamples, float gain) {
+        _accumulateMonoToStereoChannel(destination, source, numSamples, gain * SAMPLE_TO_MIX_BUS_SCALE);
+    }
+
+    /// adds each source sample times gain to the matching mix bus sample
+    static void accumulateWithGain(float* destination, const int16_t* source, int numSamples, float gain) {
+        _accumulateWithGain(destination, source, numSamples, gain * SAMPLE_TO_MIX_BUS_SCALE);
+    }
+
+    /// adds each mix bus sample in source to the matching sample in destination
+    static void accumulate(float* destination, const float* source, int numSamples) {
+        _accumulate(destination, source, numSamples);
+    }
+
+    /// runs the mix bus through a soft-knee limiter and converts it to int16_t, this is the only place the mix clips
+    static void limitToSamples(int16_t* destination, const float* source, int numSamples) {
+        _limitToSamples(destination, source, numSamples);
+    }
+
+private:
+    typedef void (*GainKernel)(float* destination, const int16_t* source, int numSamples, float gain);
+    typedef void (*Kernel)(float* destination, const float* source, int numSamples);
+    typedef void (*LimitKernel)(int16_t* destination, const float* source, int numSamples);
+
+    static InstructionSet _instructionSet;
+    static GainKernel _accumulateMonoToStereoChannel;
+    static GainKernel _accumulateWithGain;
+    static Kernel _accumulate;
+    static LimitKernel _limitToSamples;
+};
+
+#endif // hifi_AudioMixKernels_h
@@ -22,23 +22,33 @@
 
 #include "AudioRingBuffer.h"
 
+static int bufferLengthForCapacity(int numFrameSamples, int numFramesCapacity) {
+    // keep one frame more than the capacity so that the last frame popped isn't overwritten by the next write,
+    // rounded up to a power of two so that indices wrap with a mask
+    int minLength = numFrameSamples * (numFramesCapacity + 1);
+    int bufferLength = 1;
+    while (bufferLength < minLength) {
+        bufferLength <<= 1;
+    }
+    return bufferLength;
+}
+
 AudioRingBuffer::AudioRingBuffer(int numFrameSamples, bool randomAccessMode, int numFramesCapacity) :
 _frameCapacity(numFramesCapacity),
 _sampleCapacity(numFrameSamples * numFramesCapacity),
-_bufferLength(numFrameSamples * (numFramesCapacity + 1)),
+_bufferLength(bufferLengthForCapacity(numFrameSamples, numFramesCapacity)),
+_bufferMask(_bufferLength - 1),
 _numFrameSamples(numFrameSamples),
 _randomAccessMode(randomAccessMode),
-_overflowCount(0)
+_overflowCount(0),
+_readIndex(0),
+_writeIndex(0)
 {
     if (numFrameSamples) {
         _buffer = new int16_t[_bufferLength];
         memset(_buffer, 0, _bufferLength * sizeof(int16_t));
-        _nextOutput = _buffer;
-        _endOfLastWrite = _buffer;
     } else {
         _buffer = NULL;
-        _nextOutput = NULL;
-        _endOfLastWrite = NULL;
     }
 };
 
@@ -54,19 +64,31 @@ void AudioRingBuffer::reset() {
 void AudioRingBuffer::resizeForFrameSize(int numFrameSamples) {
     delete[] _buffer;
     _sampleCapacity = numFrameSamples * _frameCapacity;
-    _bufferLength = numFrameSamples * (_frameCapacity + 1);
+    _bufferLength = bufferLengthForCapacity(numFrameSamples, _frameCapacity);
+    _bufferMask = _bufferLength - 1;
     _numFrameSamples = numFrameSamples;
     _buffer = new int16_t[_bufferLength];
     memset(_buffer, 0, _bufferLength * sizeof(int16_t));
-    if (_randomAccessMode) {
-        memset(_buffer, 0, _bufferLength * sizeof(int16_t));
-    }
     reset();
 }
 
 void AudioRingBuffer::clear() {
-    _endOfLastWrite = _buffer;
-    _nextOutput = _buffer;
+    _readIndex.store(0, std::memory_order_relaxed);
+    _writeIndex.store(0, std::memory_order_release);
+}
+
+void AudioRingBuffer::copyFromBuffer(int16_t* destination, uint32_t index, int numSamples) const {
+    int start = index & _bufferMask;
+    int numSamplesToEnd = std::min(numSamples, _bufferLength - start);
+    memcpy(destination, _buffer + start, numSamplesToEnd * sizeof(int16_t));
+    memcpy(destination + numSamplesToEnd, _buffer, (numSamples - numSamplesToEnd) * sizeof(int16_t));
+}
+
+void AudioRingBuffer::copyToBuffer(uint32_t index, const int16_t* source, int numSamples) {
+    int start = index & _bufferMask;
+    int numSamplesToEnd = std::min(numSamples, _bufferLength - start);
+    memcpy(_buffer + start, source, numSamplesToEnd * sizeof(int16_t));
+    memcpy(_buffer, source + numSamplesToEnd, (numSamples - numSamplesToEnd) * sizeof(int16_t));
 }
 
 int AudioRingBuffer::readSamples(int16_t* destination, int maxSamples) {
@@ -74,42 +96,42 @@ int AudioRingBuffer::readSamples(int16_t* destination, int maxSamples) {
 }
 
 int AudioRingBuffer::readData(char *data, int maxSize) {
+    if (!_buffer) {
+        return 0;
+    }
 
-    // only copy up to the number of samples we have available
-    int numReadSamples = std::min((int)(maxSize / sizeof(int16_t)), samplesAvailable());
+    int16_t* destination = reinterpret_cast<int16_t*>(data);
+    uint32_t readIndex = _readIndex.load(std::memory_order_acquire);
+    int numReadSamples;
 
-    // If we're in random access mode, then we consider our number of available read samples slightly
-    // differently. Namely, if anything has been written, we say we have as many samples as they ask for
-    // otherwise we say we have nothing available
-    if (_randomAccessMode) {
-        numReadSamples = _endOfLastWrite ? (maxSize / sizeof(int16_t)) : 0;
-    }
+    while (true) {
+        uint32_t writeIndex = _writeIndex.load(std::memory_order_acquire);
 
-    if (_nextOutput + numReadSamples > _buffer + _bufferLength) {
-        // we're going to need to do two reads to get this data, it wraps around the edge
+        // only copy up to the number of samples we have available
+        numReadSamples = std::min((int)(maxSize / sizeof(int16_t)), (int)(writeIndex - readIndex));
 
-        // read to the end of the buffer
-        int numSamplesToEnd = (_buffer + _bufferLength) - _nextOutput;
-        memcpy(data, _nextOutput, numSamplesToEnd * sizeof(int16_t));
+        // If we're in random access mode, then we consider our number of available read samples slightly
+        // differently. Namely, we say we have as many samples as they ask for
         if (_randomAccessMode) {
-            memset(_nextOutput, 0, numSamplesToEnd * sizeof(int16_t)); // clear it
+            numReadSamples = std::min((int)(maxSize / sizeof(int16_t)), _sampleCapacity);
         }
 
-        // read the rest from the beginning of the buffer
-        memcpy(data + (numSamplesToEnd * sizeof(int16_t)), _buffer, (numReadSamples - numSamplesToEnd) * sizeof(int16_t));
-        if (_randomAccessMode) {
-            memset(_buffer, 0, (numReadSamples - numSamplesToEnd) * sizeof(int16_t)); // clear it
-        }
-    } else {
-        // read the data
-        memcpy(data, _nextOutput, numReadSamples * sizeof(int16_t));
-        if (_randomAccessMode) {
-            memset(_nextOutput, 0, numReadSamples * sizeof(int16_t)); // clear it
+        copyFromBuffer(destination, readIndex, numReadSamples);
+
+        // if the writer overflowed while we were copying, what we copied may have been overwritten - start over
+        if (_readIndex.compare_exchange_weak(readIndex, readIndex + numReadSamples,
+                                             std::memory_order_acq_rel, std::memory_order_acquire)) {
+            break;
         }
     }
 
-    // push the position of _nextOutput by the number of samples read
-    _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, numReadSamples);
+    if (_randomAccessMode) {
+        // clear what was read
+        int start = readIndex & _bufferMask;
+        int numSamplesToEnd = std::min(numReadSamples, _bufferLength - start);
+        memset(_buffer + start, 0, numSamplesToEnd * sizeof(int16_t));
+        memset(_buffer, 0, (numReadSamples - numSamplesToEnd) * sizeof(int16_t));
+    }
 
     return numReadSamples * sizeof(int16_t);
 }
@@ -118,58 +140,77 @@ int AudioRingBuffer::writeSamples(const int16_t* source, int maxSamples) {
     return writeData((const char*)source, maxSamples * sizeof(int16_t)) / sizeof(int16_t);
 }
 
+void AudioRingBuffer::makeRoomForWrite(uint32_t writeIndex, int numSamples) {
+    uint32_t readIndex = _readIndex.load(std::memory_order_acquire);
+
+    while ((int)(writeIndex - readIndex) + numSamples > _sampleCapacity) {
+        // there's not enough room for this write.  erase old data to make room for this new data
+        if (_readIndex.compare_exchange_weak(readIndex, writeIndex + numSamples - _sampleCapacity,
+                                             std::memory_order_acq_rel, std::memory_order_acquire)) {
+            _overflowCount++;
+            qCDebug(audio) << "Overflowed ring buffer! Overwriting old data";
+            break;
+        }
+    }
+}
+
 int AudioRingBuffer::writeData(const char* data, int maxSize) {
+    if (!_buffer) {
+        return 0;
+    }
+
     // make sure we have enough bytes left for this to be the right amount of audio
     // otherwise we should not copy that data, and leave the buffer pointers where they are
     int samplesToCopy = std::min((int)(maxSize / sizeof(int16_t)), _sampleCapacity);
 
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qCDebug(audio) << "Overflowed ring buffer! Overwriting old data";
-    }
+    // only this thread moves the write index
+    uint32_t writeIndex = _writeIndex.load(std::memory_order_relaxed);
 
-    if (_endOfLastWrite + samplesToCopy <= _buffer + _bufferLength) {
-        memcpy(_endOfLastWrite, data, samplesToCopy * sizeof(int16_t));
-    } else {
-        int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
-        memcpy(_endOfLastWrite, data, numSamplesToEnd * sizeof(int16_t));
-        memcpy(_buffer, data + (numSamplesToEnd * sizeof(int16_t)), (samplesToCopy - numSamplesToEnd) * sizeof(int16_t));
-    }
+    makeRoomForWrite(writeIndex, samplesToCopy);
+    copyToBuffer(writeIndex, reinterpret_cast<const int16_t*>(data), samplesToCopy);
 
-    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, samplesToCopy);
+    // publish the samples to the reader
+    _writeIndex.store(writeIndex + samplesToCopy, std::memory_order_release);
 
     return samplesToCopy * sizeof(int16_t);
 }
 
 int16_t& AudioRingBuffer::operator[](const int index) {
-    return *shiftedPositionAccomodatingWrap(_nextOutput, index);
+    return _buffer[(_readIndex.load(std::memory_order_acquire) + index) & _bufferMask];
 }
 
 const int16_t& AudioRingBuffer::operator[] (const int index) const {
-    return *shiftedPositionAccomodatingWrap(_nextOutput, index);
+    return _buffer[(_readIndex.load(std::memory_order_acquire) + index) & _bufferMask];
 }
 
-void AudioRingBuffer::shiftReadPosition(unsigned int numSamples) {
-    _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, numSamples);
+AudioRingBuffer::ConstIterator AudioRingBuffer::shiftReadPosition(unsigned int numSamples) {
+    if (!_buffer) {
+        return ConstIterator();
+    }
+
+    uint32_t readIndex = _readIndex.load(std::memory_order_acquire);
+    while (!_readIndex.compare_exchange_weak(readIndex, readIndex + numSamples,
+                                             std::memory_order_acq_rel, std::memory_order_acquire)) {
+        // the writer pushed the read index forward, shift from where it left it
+    }
+    return ConstIterator(_buffer, _bufferLength, _buffer + (readIndex & _bufferMask));
 }
 
 int AudioRingBuffer::samplesAvailable() const {
-    if (!_endOfLastWrite) {
+    if (!_buffer) {
         return 0;
     }
 
-    int sampleDifference = _endOfLastWrite - _nextOutput;
-    if (sampleDifference < 0) {
-        sampleDifference += _bufferLength;
-    }
-    return sampleDifference;
+    // load the read index first, the writer only ever moves it towards the write index
+    uint32_t readIndex = _readIndex.load(std::memory_order_acquire);
+    uint32_t writeIndex = _writeIndex.load(std::memory_order_acquire);
+    return (int)(writeIndex - readIndex);
 }
 
 int AudioRingBuffer::addSilentSamples(int silentSamples) {
+    if (!_buffer) {
+        return 0;
+    }
 
     int samplesRoomFor = _sampleCapacity - samplesAvailable();
     if (silentSamples > samplesRoomFor) {
@@ -179,40 +220,23 @@ int AudioRingBuffer::addSilentSamples(int silentSamples) {
     }
 
     // memset zeroes into the buffer, accomodate a wrap around the end
-    // push the _endOfLastWrite to the correct spot
-    if (_endOfLastWrite + silentSamples <= _buffer + _bufferLength) {
-        memset(_endOfLastWrite, 0, silentSamples * sizeof(int16_t));
-    } else {
-        int numSamplesToEnd = (_buffer + _bufferLength) - _endOfLastWrite;
-        memset(_endOfLastWrite, 0, numSamplesToEnd * sizeof(int16_t));
-        memset(_buffer, 0, (silentSamples - numSamplesToEnd) * sizeof(int16_t));
-    }
-    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, silentSamples);
-
-    return silentSamples;
-}
+    uint32_t writeIndex = _writeIndex.load(std::memory_order_relaxed);
+    int start = writeIndex & _bufferMask;
+    int numSamplesToEnd = std::min(silentSamples, _bufferLength - start);
+    memset(_buffer + start, 0, numSamplesToEnd * sizeof(int16_t));
+    memset(_buffer, 0, (silentSamples - numSamplesToEnd) * sizeof(int16_t));
 
-int16_t* AudioRingBuffer::shiftedPositionAccomodatingWrap(int16_t* position, int numSamplesShift) const {
+    _writeIndex.store(writeIndex + silentSamples, std::memory_order_release);
 
-    if (numSamplesShift > 0 && position + numSamplesShift >= _buffer + _bufferLength) {
-        // this shift will wrap the position around to the beginning of the ring
-        return position + numSamplesShift - _bufferLength;
-    } else if (numSamplesShift < 0 && position + numSamplesShift < _buffer) {
-        // this shift will go around to the end of the ring
-        return position + numSamplesShift + _bufferLength;
-    } else {
-        return position + numSamplesShift;
-    }
+    return silentSamples;
 }
 
 float AudioRingBuffer::getFrameLoudness(const int16_t* frameStart) const {
     float loudness = 0.0f;
-    const int16_t* sampleAt = frameStart;
-    const int16_t* _bufferLastAt = _buffer + _bufferLength - 1;
+    int frameIndex = frameStart - _buffer;
 
     for (int i = 0; i < _numFrameSamples; ++i) {
-        loudness += std::abs(*sampleAt);
-        sampleAt = sampleAt == _bufferLastAt ? _buffer : sampleAt + 1;
+        loudness += std::abs(_buffer[(frameIndex + i) & _bufferMask]);
     }
     loudness /= _numFrameSamples;
     loudness /= AudioConstants::MAX_SAMPLE_VALUE;
@@ -228,47 +252,61 @@ float AudioRingBuffer::getFrameLoudness(ConstIterator frameStart) const {
 }
 
 float AudioRingBuffer::getNextOutputFrameLoudness() const {
-    return getFrameLoudness(_nextOutput);
+    if (!_buffer) {
+        return 0.0f;
+    }
+    return getFrameLoudness(_buffer + (_readIndex.load(std::memory_order_acquire) & _bufferMask));
+}
+
+AudioRingBuffer::ConstIterator AudioRingBuffer::nextOutput() const {
+    if (!_buffer) {
+        return ConstIterator();
+    }
+    return ConstIterator(_buffer, _bufferLength, _buffer + (_readIndex.load(std::memory_order_acquire) & _bufferMask));
+}
+
+AudioRingBuffer::ConstIterator AudioRingBuffer::lastFrameWritten() const {
+    if (!_buffer) {
+        return ConstIterator();
+    }
+    return ConstIterator(_buffer, _bufferLength, _buffer + (_writeIndex.load(std::memory_order_acquire) & _bufferMask))
+        - _numFrameSamples;
 }
 
 int AudioRingBuffer::writeSamples(ConstIterator source, int maxSamples) {
-    int samplesToCopy = std::min(maxSamples, _sampleCapacity);
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qCDebug(audio) << "Overflowed ring buffer! Overwriting old data";
+    if (!_buffer) {
+        return 0;
     }
 
-    int16_t* bufferLast = _buffer + _bufferLength - 1;
+    int samplesToCopy = std::min(maxSamples, _sampleCapacity);
+    uint32_t writeIndex = _writeIndex.load(std::memory_order_relaxed);
+    makeRoomForWrite(writeIndex, samplesToCopy);
+
     for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = *source;
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
+        _buffer[(writeIndex + i) & _bufferMask] = *source;
         ++source;
     }
 
+    _writeIndex.store(writeIndex + samplesToCopy, std::memory_order_release);
+
     return samplesToCopy;
 }
 
 int AudioRingBuffer::writeSamplesWithFade(ConstIterator source, int maxSamples, float fade) {
-    int samplesToCopy = std::min(maxSamples, _sampleCapacity);
-    int samplesRoomFor = _sampleCapacity - samplesAvailable();
-    if (samplesToCopy > samplesRoomFor) {
-        // there's not enough room for this write.  erase old data to make room for this new data
-        int samplesToDelete = samplesToCopy - samplesRoomFor;
-        _nextOutput = shiftedPositionAccomodatingWrap(_nextOutput, samplesToDelete);
-        _overflowCount++;
-        qCDebug(audio) << "Overflowed ring buffer! Overwriting old data";
+    if (!_buffer) {
+        return 0;
     }
 
-    int16_t* bufferLast = _buffer + _bufferLength - 1;
+    int samplesToCopy = std::min(maxSamples, _sampleCapacity);
+    uint32_t writeIndex = _writeIndex.load(std::memory_order_relaxed);
+    makeRoomForWrite(writeIndex, samplesToCopy);
+
     for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = (int16_t)((float)(*source) * fade);
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
+        _buffer[(writeIndex + i) & _bufferMask] = (int16_t)((float)(*source) * fade);
         ++source;
     }
 
+    _writeIndex.store(writeIndex + samplesToCopy, std::memory_order_release);
+
     return samplesToCopy;
 }
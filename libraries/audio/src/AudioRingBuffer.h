@@ -14,6 +14,10 @@
 
 #include "AudioConstants.h"
 
+#include <algorithm>
+#include <atomic>
+#include <string.h>
+
 #include <QtCore/QIODevice>
 
 #include <SharedUtil.h>
@@ -21,6 +25,13 @@
 
 const int DEFAULT_RING_BUFFER_FRAME_CAPACITY = 10;
 
+// the read and write indices are kept at least this far apart so that the reader and writer don't false share
+const int RING_BUFFER_CACHE_LINE_BYTES = 64;
+
+/// Single-producer/single-consumer ring buffer of samples. One thread may write (writeData, writeSamples,
+/// addSilentSamples) while another reads (readData, readSamples, shiftReadPosition) without any locking.
+/// When a write doesn't fit the writer pushes the read position forward itself, so the reader only commits a read
+/// if nothing was overwritten while it was copying. reset, clear and resizeForFrameSize need both sides stopped.
 class AudioRingBuffer {
 public:
     AudioRingBuffer(int numFrameSamples, bool randomAccessMode = false, int numFramesCapacity = DEFAULT_RING_BUFFER_FRAME_CAPACITY);
@@ -43,8 +54,6 @@ public:
     int16_t& operator[](const int index);
     const int16_t& operator[] (const int index) const;
 
-    void shiftReadPosition(unsigned int numSamples);
-
     float getNextOutputFrameLoudness() const;
 
     int samplesAvailable() const;
@@ -59,37 +68,48 @@ public:
 private:
     float getFrameLoudness(const int16_t* frameStart) const;
 
+    /// pushes the read index forward if numSamples written at writeIndex won't fit
+    void makeRoomForWrite(uint32_t writeIndex, int numSamples);
+
+    void copyFromBuffer(int16_t* destination, uint32_t index, int numSamples) const;
+    void copyToBuffer(uint32_t index, const int16_t* source, int numSamples);
+
 protected:
     // disallow copying of AudioRingBuffer objects
     AudioRingBuffer(const AudioRingBuffer&);
     AudioRingBuffer& operator= (const AudioRingBuffer&);
 
-    int16_t* shiftedPositionAccomodatingWrap(int16_t* position, int numSamplesShift) const;
-
     int _frameCapacity;
     int _sampleCapacity;
-    int _bufferLength;      // actual length of _buffer: will be one frame larger than _sampleCapacity
+    int _bufferLength;      // actual length of _buffer: a power of two at least one frame larger than _sampleCapacity
+    uint32_t _bufferMask;
     int _numFrameSamples;
-    int16_t* _nextOutput;
-    int16_t* _endOfLastWrite;
     int16_t* _buffer;
     bool _randomAccessMode; /// will this ringbuffer be used for random access? if so, do some special processing
 
     int _overflowCount; /// how many times has the ring buffer has overwritten old data
 
+    // total samples ever read and written, masked to find their place in _buffer
+    char _readIndexPadding[RING_BUFFER_CACHE_LINE_BYTES];
+    std::atomic<uint32_t> _readIndex;
+    char _writeIndexPadding[RING_BUFFER_CACHE_LINE_BYTES - sizeof(std::atomic<uint32_t>)];
+    std::atomic<uint32_t> _writeIndex;
+    char _endPadding[RING_BUFFER_CACHE_LINE_BYTES - sizeof(std::atomic<uint32_t>)];
+
 public:
     class ConstIterator { //public std::iterator < std::forward_iterator_tag, int16_t > {
     public:
         ConstIterator()
             : _bufferLength(0),
+            _bufferMask(0),
             _bufferFirst(NULL),
-            _bufferLast(NULL),
             _at(NULL) {}
 
+        /// capacity has to be a power of two
         ConstIterator(int16_t* bufferFirst, int capacity, int16_t* at)
             : _bufferLength(capacity),
+            _bufferMask(capacity - 1),
             _bufferFirst(bufferFirst),
-            _bufferLast(bufferFirst + capacity - 1),
             _at(at) {}
 
         bool isNull() const { return _at == NULL; }
@@ -100,14 +120,14 @@ public:
 
         ConstIterator& operator=(const ConstIterator& rhs) {
             _bufferLength = rhs._bufferLength;
+            _bufferMask = rhs._bufferMask;
             _bufferFirst = rhs._bufferFirst;
-            _bufferLast = rhs._bufferLast;
             _at = rhs._at;
             return *this;
         }
 
         ConstIterator& operator++() {
-            _at = (_at == _bufferLast) ? _bufferFirst : _at + 1;
+            _at = atShiftedBy(1);
             return *this;
         }
 
@@ -118,7 +138,7 @@ public:
         }
 
         ConstIterator& operator--() {
-            _at = (_at == _bufferFirst) ? _bufferLast : _at - 1;
+            _at = atShiftedBy(-1);
             return *this;
         }
 
@@ -141,41 +161,38 @@ public:
         }
 
         void readSamples(int16_t* dest, int numSamples) {
-            int16_t* at = _at;
-            for (int i = 0; i < numSamples; i++) {
-                *dest = *at;
-                ++dest;
-                at = (at == _bufferLast) ? _bufferFirst : at + 1;
-            }
+            // at most two copies, one up to the end of the buffer and one from its start
+            int numSamplesToEnd = std::min(numSamples, (int)(_bufferFirst + _bufferLength - _at));
+            memcpy(dest, _at, numSamplesToEnd * sizeof(int16_t));
+            memcpy(dest + numSamplesToEnd, _bufferFirst, (numSamples - numSamplesToEnd) * sizeof(int16_t));
         }
 
         void readSamplesWithFade(int16_t* dest, int numSamples, float fade) {
-            int16_t* at = _at;
+            int index = _at - _bufferFirst;
             for (int i = 0; i < numSamples; i++) {
-                *dest = (float)*at * fade;
+                *dest = (float)_bufferFirst[(index + i) & _bufferMask] * fade;
                 ++dest;
-                at = (at == _bufferLast) ? _bufferFirst : at + 1;
             }
         }
 
     private:
         int16_t* atShiftedBy(int i) {
-            i = (_at - _bufferFirst + i) % _bufferLength;
-            if (i < 0) {
-                i += _bufferLength;
-            }
-            return _bufferFirst + i;
+            // the mask wraps negative shifts around too
+            return _bufferFirst + ((_at - _bufferFirst + i) & _bufferMask);
         }
 
     private:
         int _bufferLength;
+        int _bufferMask;
         int16_t* _bufferFirst;
-        int16_t* _bufferLast;
         int16_t* _at;
     };
 
-    ConstIterator nextOutput() const { return ConstIterator(_buffer, _bufferLength, _nextOutput); }
-    ConstIterator lastFrameWritten() const { return ConstIterator(_buffer, _bufferLength, _endOfLastWrite) - _numFrameSamples; }
+    ConstIterator nextOutput() const;
+    ConstIterator lastFrameWritten() const;
+
+    /// moves the read position forward, returns an iterator at the first of the samples that were skipped over
+    ConstIterator shiftReadPosition(unsigned int numSamples);
 
     float getFrameLoudness(ConstIterator frameStart) const;
 
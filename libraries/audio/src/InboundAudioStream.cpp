@@ -11,6 +11,7 @@
 
 #include <glm/glm.hpp>
 
+#include "AudioCodec.h"
 #include "InboundAudioStream.h"
 #include "PacketHeaders.h"
 
@@ -117,7 +118,21 @@ int InboundAudioStream::parseData(const QByteArray& packet) {
     int networkSamples;
 
     // parse the info after the seq number and before the audio data (the stream properties)
-    readBytes += parseStreamProperties(packetType, packet.mid(readBytes), networkSamples);
+    int propertyBytes = parseStreamProperties(packetType, packet.mid(readBytes), networkSamples);
+    if (propertyBytes < 0) {
+        // the packet is cut short, fill in for it and any it skipped like we would for dropped ones
+        int packetsToFillIn = 0;
+        if (arrivalInfo._status == SequenceNumberStats::OnTime) {
+            packetsToFillIn = 1;
+        } else if (arrivalInfo._status == SequenceNumberStats::Early) {
+            packetsToFillIn = arrivalInfo._seqDiffFromExpected + 1;
+        }
+        if (packetsToFillIn > 0) {
+            writeSamplesForDroppedPackets(packetsToFillIn * _ringBuffer.getNumFrameSamples());
+        }
+        return packet.size();
+    }
+    readBytes += propertyBytes;
 
     // handle this packet based on its arrival status.
     switch (arrivalInfo._status) {
@@ -135,7 +150,13 @@ int InboundAudioStream::parseData(const QByteArray& packet) {
             if (packetType == PacketTypeSilentAudioFrame) {
                 writeDroppableSilentSamples(networkSamples);
             } else {
-                readBytes += parseAudioData(packetType, packet.mid(readBytes), networkSamples);
+                int audioBytes = parseAudioData(packetType, packet.mid(readBytes), networkSamples);
+                if (audioBytes < 0) {
+                    // we couldn't decode this one, fill in for it like we would for a dropped packet
+                    writeSamplesForDroppedPackets(networkSamples);
+                    audioBytes = packet.size() - readBytes;
+                }
+                readBytes += audioBytes;
             }
             break;
         }
@@ -170,19 +191,38 @@ int InboundAudioStream::parseData(const QByteArray& packet) {
 
 int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& numAudioSamples) {
     if (type == PacketTypeSilentAudioFrame) {
+        if (packetAfterSeqNum.size() < (int)sizeof(quint16)) {
+            return -1;
+        }
         quint16 numSilentSamples = 0;
         memcpy(&numSilentSamples, packetAfterSeqNum.constData(), sizeof(quint16));
         numAudioSamples = numSilentSamples;
         return sizeof(quint16);
     } else {
         // mixed audio packets do not have any info between the seq num and the audio data.
-        numAudioSamples = packetAfterSeqNum.size() / sizeof(int16_t);
+        numAudioSamples = AudioCodec::samplesInFrame(packetAfterSeqNum.constData(), packetAfterSeqNum.size());
         return 0;
     }
 }
 
 int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties, int numAudioSamples) {
-    return _ringBuffer.writeData(packetAfterStreamProperties.data(), numAudioSamples * sizeof(int16_t));
+    int readBytes = decodeAudioFrame(packetAfterStreamProperties, numAudioSamples, _decodedSamples);
+    if (readBytes < 0) {
+        return -1;
+    }
+    _ringBuffer.writeData(_decodedSamples.constData(), _decodedSamples.size());
+    return readBytes;
+}
+
+int InboundAudioStream::decodeAudioFrame(const QByteArray& encodedFrame, int numAudioSamples, QByteArray& decodedSamples) {
+    // the sample count comes from the frame's own header, so it can't size the buffer without a bound
+    int maxSamples = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * getNumChannels();
+    if (numAudioSamples > maxSamples) {
+        return -1;
+    }
+    decodedSamples.resize(numAudioSamples * sizeof(int16_t));
+    return AudioCodec::decodeFrame(encodedFrame.constData(), encodedFrame.size(),
+                                   reinterpret_cast<int16_t*>(decodedSamples.data()), numAudioSamples, getNumChannels());
 }
 
 int InboundAudioStream::writeDroppableSilentSamples(int silentSamples) {
@@ -271,8 +311,7 @@ int InboundAudioStream::popFrames(int maxFrames, bool allOrNothing, bool starveI
 }
 
 void InboundAudioStream::popSamplesNoCheck(int samples) {
-    _lastPopOutput = _ringBuffer.nextOutput();
-    _ringBuffer.shiftReadPosition(samples);
+    _lastPopOutput = _ringBuffer.shiftReadPosition(samples);
     framesAvailableChanged();
 
     _hasStarted = true;
@@ -193,13 +193,21 @@ protected:
 
     /// parses the info between the seq num and the audio data in the network packet and calculates
     /// how many audio samples this packet contains (used when filling in samples for dropped packets).
-    /// default implementation assumes no stream properties and raw audio samples after stream propertiess
+    /// returns -1 if the packet is too short to hold them.
+    /// default implementation assumes no stream properties and an encoded audio frame after stream propertiess
     virtual int parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& networkSamples);
 
-    /// parses the audio data in the network packet.
-    /// default implementation assumes packet contains raw audio samples after stream properties
+    /// parses the audio data in the network packet, returns -1 if it can't be decoded and the packet should be
+    /// treated as dropped. default implementation assumes packet contains an encoded audio frame after stream properties
     virtual int parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties, int networkSamples);
 
+    /// the number of interleaved channels in this stream's audio frames, mixed audio is always stereo
+    virtual int getNumChannels() const { return 2; }
+
+    /// decodes the audio frame at the start of encodedFrame into decodedSamples, returns the number of bytes read
+    /// or -1 if it can't be decoded or holds more samples than a network frame for this stream's channels
+    int decodeAudioFrame(const QByteArray& encodedFrame, int networkSamples, QByteArray& decodedSamples);
+
     /// writes silent samples to the buffer that may be dropped to reduce latency caused by the buffer
     virtual int writeDroppableSilentSamples(int silentSamples);
 
@@ -259,6 +267,9 @@ protected:
     MovingMinMaxAvg<quint64> _timeGapStatsForStatsPacket;
 
     bool _repetitionWithFade;
+
+    // scratch space for decoding the audio in each packet before it goes into the ring buffer
+    QByteArray _decodedSamples;
     
     // Reverb properties
     bool _hasReverb;
@@ -17,6 +17,7 @@
 #include <PacketHeaders.h>
 #include <UUID.h>
 
+#include "AudioCodec.h"
 #include "InjectedAudioStream.h"
 
 InjectedAudioStream::InjectedAudioStream(const QUuid& streamIdentifier, const bool isStereo, const InboundAudioStream::Settings& settings) :
@@ -69,7 +70,8 @@ int InjectedAudioStream::parseStreamProperties(PacketType type,
     packetStream >> _ignorePenumbra;
     
     int numAudioBytes = packetAfterSeqNum.size() - packetStream.device()->pos();
-    numAudioSamples = numAudioBytes / sizeof(int16_t);
+    numAudioSamples = AudioCodec::samplesInFrame(packetAfterSeqNum.constData() + packetStream.device()->pos(),
+                                                 numAudioBytes);
 
     return packetStream.device()->pos();
 }
@@ -44,14 +44,20 @@ int MixedProcessedAudioStream::writeLastFrameRepeatedWithFade(int samples) {
 
 int MixedProcessedAudioStream::parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties, int networkSamples) {
 
-    emit addedStereoSamples(packetAfterStreamProperties);
+    QByteArray networkBuffer;
+    int readBytes = decodeAudioFrame(packetAfterStreamProperties, networkSamples, networkBuffer);
+    if (readBytes < 0) {
+        return -1;
+    }
+
+    emit addedStereoSamples(networkBuffer);
 
     QByteArray outputBuffer;
-    emit processSamples(packetAfterStreamProperties, outputBuffer);
+    emit processSamples(networkBuffer, outputBuffer);
 
     _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
     
-    return packetAfterStreamProperties.size();
+    return readBytes;
 }
 
 int MixedProcessedAudioStream::networkToDeviceSamples(int networkSamples) {
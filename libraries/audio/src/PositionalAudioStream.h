@@ -53,6 +53,8 @@ protected:
 
     int parsePositionalData(const QByteArray& positionalByteArray);
 
+    virtual int getNumChannels() const { return _isStereo ? 2 : 1; }
+
 protected:
     Type _type;
     glm::vec3 _position;
@@ -60,7 +60,11 @@ AvatarData::AvatarData() :
     _owningAvatarMixer(),
     _velocity(0.0f),
     _targetVelocity(0.0f),
-    _localAABox(DEFAULT_LOCAL_AABOX_CORNER, DEFAULT_LOCAL_AABOX_SCALE)
+    _localAABox(DEFAULT_LOCAL_AABOX_CORNER, DEFAULT_LOCAL_AABOX_SCALE),
+    _sentKeyframeID(0),
+    _deltasSinceKeyframe(0),
+    _receivedKeyframeID(0),
+    _hasReceivedKeyframe(false)
 {
 
 }
@@ -132,35 +136,106 @@ void AvatarData::setHandPosition(const glm::vec3& handPosition) {
     _handPosition = glm::inverse(getOrientation()) * (handPosition - _position);
 }
 
-QByteArray AvatarData::toByteArray() {
-    // TODO: DRY this up to a shared method
-    // that can pack any type given the number of bytes
-    // and return the number of bytes to push the pointer
-    
-    // lazily allocate memory for HeadData in case we're not an Avatar instance
-    if (!_headData) {
-        _headData = new HeadData(this);
+// the number of bytes each fixed size field takes, variable sized fields go out with a two byte size in front of them
+const int VARIABLE_FIELD_SIZE = -1;
+static const int AVATAR_DATA_FIELD_SIZES[NUM_AVATAR_DATA_FIELDS] = {
+    sizeof(glm::vec3), // position
+    3 * sizeof(uint16_t), // body yaw, pitch and roll
+    sizeof(uint16_t), // scale
+    3 * sizeof(uint16_t), // head pitch, yaw and roll
+    sizeof(glm::vec3), // look at
+    sizeof(float), // audio loudness
+    VARIABLE_FIELD_SIZE, // bit items and referential
+    VARIABLE_FIELD_SIZE, // face data
+    sizeof(uint8_t) // pupil dilation
+};
+
+// two rotations are within the threshold of each other when the dot product of their quats is at least this
+static const float JOINT_ROTATION_DELTA_MIN_DOT = cosf(glm::radians(AVATAR_JOINT_ROTATION_DELTA_THRESHOLD) * 0.5f);
+
+static QByteArray byteArrayFromBuffer(const unsigned char* start, const unsigned char* end) {
+    return QByteArray(reinterpret_cast<const char*>(start), end - start);
+}
+
+static bool hasFieldChanged(int field, const QByteArray& current, const QByteArray& keyframe) {
+    if (current.size() != keyframe.size()) {
+        return true;
     }
-    if (_forceFaceTrackerConnected) {
-        _headData->_isFaceTrackerConnected = true;
+
+    switch (field) {
+        case AVATAR_POSITION_FIELD:
+        case AVATAR_LOOK_AT_FIELD: {
+            glm::vec3 currentValue, keyframeValue;
+            memcpy(&currentValue, current.constData(), sizeof(currentValue));
+            memcpy(&keyframeValue, keyframe.constData(), sizeof(keyframeValue));
+
+            float threshold = (field == AVATAR_POSITION_FIELD)
+                ? AVATAR_POSITION_DELTA_THRESHOLD : AVATAR_LOOK_AT_DELTA_THRESHOLD;
+            return glm::distance(currentValue, keyframeValue) > threshold;
+        }
+        case AVATAR_AUDIO_LOUDNESS_FIELD: {
+            float currentValue, keyframeValue;
+            memcpy(&currentValue, current.constData(), sizeof(currentValue));
+            memcpy(&keyframeValue, keyframe.constData(), sizeof(keyframeValue));
+            return fabsf(currentValue - keyframeValue) > AVATAR_AUDIO_LOUDNESS_DELTA_THRESHOLD;
+        }
+        default:
+            // the rest of the fields are quantized as they are packed, so any difference is a real one
+            return current != keyframe;
     }
-    
-    QByteArray avatarDataByteArray;
-    avatarDataByteArray.resize(MAX_PACKET_SIZE);
-    
-    unsigned char* destinationBuffer = reinterpret_cast<unsigned char*>(avatarDataByteArray.data());
+}
+
+static int packJointBits(unsigned char* destinationBuffer, const QVector<bool>& bits) {
     unsigned char* startPosition = destinationBuffer;
-    
-    memcpy(destinationBuffer, &_position, sizeof(_position));
-    destinationBuffer += sizeof(_position);
-    
+    unsigned char byte = 0;
+    int bit = 0;
+    foreach (bool isSet, bits) {
+        if (isSet) {
+            byte |= (1 << bit);
+        }
+        if (++bit == BITS_IN_BYTE) {
+            *destinationBuffer++ = byte;
+            bit = byte = 0;
+        }
+    }
+    if (bit != 0) {
+        *destinationBuffer++ = byte;
+    }
+    return destinationBuffer - startPosition;
+}
+
+static int unpackJointBits(const unsigned char* sourceBuffer, QVector<bool>& bits) {
+    const unsigned char* startPosition = sourceBuffer;
+    unsigned char byte = 0;
+    for (int i = 0; i < bits.size(); i++) {
+        int bit = i % BITS_IN_BYTE;
+        if (bit == 0) {
+            byte = *sourceBuffer++;
+        }
+        bits[i] = (bool)(byte & (1 << bit));
+    }
+    return sourceBuffer - startPosition;
+}
+
+void AvatarData::packFields(QVector<QByteArray>& fields) {
+    fields.resize(NUM_AVATAR_DATA_FIELDS);
+
+    unsigned char buffer[MAX_PACKET_SIZE];
+    unsigned char* destinationBuffer;
+
+    fields[AVATAR_POSITION_FIELD] = QByteArray(reinterpret_cast<const char*>(&_position), sizeof(_position));
+
     // Body rotation (NOTE: This needs to become a quaternion to save two bytes)
+    destinationBuffer = buffer;
     destinationBuffer += packFloatAngleToTwoByte(destinationBuffer, _bodyYaw);
     destinationBuffer += packFloatAngleToTwoByte(destinationBuffer, _bodyPitch);
     destinationBuffer += packFloatAngleToTwoByte(destinationBuffer, _bodyRoll);
-    
+    fields[AVATAR_BODY_ORIENTATION_FIELD] = byteArrayFromBuffer(buffer, destinationBuffer);
+
     // Body scale
+    destinationBuffer = buffer;
     destinationBuffer += packFloatRatioToTwoByte(destinationBuffer, _targetScale);
+    fields[AVATAR_SCALE_FIELD] = byteArrayFromBuffer(buffer, destinationBuffer);
 
     // Head rotation (NOTE: This needs to become a quaternion to save two bytes)
     glm::vec3 pitchYawRoll = glm::vec3(_headData->getFinalPitch(),
@@ -172,18 +247,20 @@ QByteArray AvatarData::toByteArray() {
                                    _headData->getFinalLeanSideways());
         pitchYawRoll -= lean;
     }
+    destinationBuffer = buffer;
     destinationBuffer += packFloatAngleToTwoByte(destinationBuffer, pitchYawRoll.x);
     destinationBuffer += packFloatAngleToTwoByte(destinationBuffer, pitchYawRoll.y);
     destinationBuffer += packFloatAngleToTwoByte(destinationBuffer, pitchYawRoll.z);
+    fields[AVATAR_HEAD_ORIENTATION_FIELD] = byteArrayFromBuffer(buffer, destinationBuffer);
 
     // Lookat Position
-    memcpy(destinationBuffer, &_headData->_lookAtPosition, sizeof(_headData->_lookAtPosition));
-    destinationBuffer += sizeof(_headData->_lookAtPosition);
-     
+    fields[AVATAR_LOOK_AT_FIELD] = QByteArray(reinterpret_cast<const char*>(&_headData->_lookAtPosition),
+                                              sizeof(_headData->_lookAtPosition));
+
     // Instantaneous audio loudness (used to drive facial animation)
-    memcpy(destinationBuffer, &_headData->_audioLoudness, sizeof(float));
-    destinationBuffer += sizeof(float);
-    
+    fields[AVATAR_AUDIO_LOUDNESS_FIELD] = QByteArray(reinterpret_cast<const char*>(&_headData->_audioLoudness),
+                                                     sizeof(float));
+
     // bitMask of less than byte wide items
     unsigned char bitItems = 0;
 
@@ -202,14 +279,17 @@ QByteArray AvatarData::toByteArray() {
     if (_referential != NULL && _referential->isValid()) {
         setAtBit(bitItems, HAS_REFERENTIAL);
     }
+    destinationBuffer = buffer;
     *destinationBuffer++ = bitItems;
-    
+
     // Add referential
     if (_referential != NULL && _referential->isValid()) {
         destinationBuffer += _referential->packReferential(destinationBuffer);
     }
+    fields[AVATAR_STATE_FIELD] = byteArrayFromBuffer(buffer, destinationBuffer);
 
     // If it is connected, pack up the data
+    destinationBuffer = buffer;
     if (_headData->_isFaceTrackerConnected) {
         memcpy(destinationBuffer, &_headData->_leftEyeBlink, sizeof(float));
         destinationBuffer += sizeof(float);
@@ -222,39 +302,118 @@ QByteArray AvatarData::toByteArray() {
 
         memcpy(destinationBuffer, &_headData->_browAudioLift, sizeof(float));
         destinationBuffer += sizeof(float);
-        
+
         *destinationBuffer++ = _headData->_blendshapeCoefficients.size();
         memcpy(destinationBuffer, _headData->_blendshapeCoefficients.data(),
             _headData->_blendshapeCoefficients.size() * sizeof(float));
         destinationBuffer += _headData->_blendshapeCoefficients.size() * sizeof(float);
     }
-    
+    fields[AVATAR_FACE_FIELD] = byteArrayFromBuffer(buffer, destinationBuffer);
+
     // pupil dilation
+    destinationBuffer = buffer;
     destinationBuffer += packFloatToByte(destinationBuffer, _headData->_pupilDilation, 1.0f);
+    fields[AVATAR_PUPIL_FIELD] = byteArrayFromBuffer(buffer, destinationBuffer);
+}
 
-    // joint data
-    *destinationBuffer++ = _jointData.size();
-    unsigned char validity = 0;
-    int validityBit = 0;
-    foreach (const JointData& data, _jointData) {
-        if (data.valid) {
-            validity |= (1 << validityBit);
+QByteArray AvatarData::encodeFields(const QVector<QByteArray>& fields, quint16 fieldMask,
+                                    const QVector<bool>& changedJoints, quint8 keyframeID) const {
+    QByteArray avatarDataByteArray;
+    avatarDataByteArray.resize(MAX_PACKET_SIZE);
+
+    unsigned char* destinationBuffer = reinterpret_cast<unsigned char*>(avatarDataByteArray.data());
+    unsigned char* startPosition = destinationBuffer;
+
+    *destinationBuffer++ = keyframeID;
+    memcpy(destinationBuffer, &fieldMask, sizeof(fieldMask));
+    destinationBuffer += sizeof(fieldMask);
+
+    for (int i = 0; i < NUM_AVATAR_DATA_FIELDS; i++) {
+        if (fieldMask & (1U << i)) {
+            const QByteArray& field = fields.at(i);
+            if (AVATAR_DATA_FIELD_SIZES[i] == VARIABLE_FIELD_SIZE) {
+                quint16 fieldSize = field.size();
+                memcpy(destinationBuffer, &fieldSize, sizeof(fieldSize));
+                destinationBuffer += sizeof(fieldSize);
+            }
+            memcpy(destinationBuffer, field.constData(), field.size());
+            destinationBuffer += field.size();
+        }
+    }
+
+    if (fieldMask & AVATAR_JOINTS_FIELD_BIT) {
+        // joint count, validity bits, a bit for each joint whose rotation follows, and those rotations
+        *destinationBuffer++ = _jointData.size();
+
+        QVector<bool> validJoints(_jointData.size());
+        for (int i = 0; i < _jointData.size(); i++) {
+            validJoints[i] = _jointData.at(i).valid;
         }
-        if (++validityBit == BITS_IN_BYTE) {
-            *destinationBuffer++ = validity;
-            validityBit = validity = 0;
+        destinationBuffer += packJointBits(destinationBuffer, validJoints);
+        destinationBuffer += packJointBits(destinationBuffer, changedJoints);
+
+        for (int i = 0; i < _jointData.size(); i++) {
+            if (changedJoints.at(i)) {
+                destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, _jointData.at(i).rotation);
+            }
         }
     }
-    if (validityBit != 0) {
-        *destinationBuffer++ = validity;
+
+    return avatarDataByteArray.left(destinationBuffer - startPosition);
+}
+
+QByteArray AvatarData::toByteArray() {
+    // lazily allocate memory for HeadData in case we're not an Avatar instance
+    if (!_headData) {
+        _headData = new HeadData(this);
     }
-    foreach (const JointData& data, _jointData) {
-        if (data.valid) {
-            destinationBuffer += packOrientationQuatToBytes(destinationBuffer, data.rotation);
+    if (_forceFaceTrackerConnected) {
+        _headData->_isFaceTrackerConnected = true;
+    }
+
+    QVector<QByteArray> fields;
+    packFields(fields);
+
+    if (_sentKeyframe.isEmpty() || _deltasSinceKeyframe >= AVATAR_KEYFRAME_INTERVAL
+            || _jointData.size() != _sentKeyframeJoints.size()) {
+        // a keyframe carries every field and every valid joint
+        QVector<bool> keyframeJoints(_jointData.size());
+        for (int i = 0; i < _jointData.size(); i++) {
+            keyframeJoints[i] = _jointData.at(i).valid;
         }
+        quint16 fieldMask = AVATAR_KEYFRAME_BIT | AVATAR_JOINTS_FIELD_BIT | (AVATAR_JOINTS_FIELD_BIT - 1);
+
+        _sentKeyframeFields = fields;
+        _sentKeyframeJoints = _jointData;
+        _sentKeyframe = encodeFields(fields, fieldMask, keyframeJoints, ++_sentKeyframeID);
+        _deltasSinceKeyframe = 0;
+        return _sentKeyframe;
     }
-        
-    return avatarDataByteArray.left(destinationBuffer - startPosition);
+
+    quint16 fieldMask = 0;
+    for (int i = 0; i < NUM_AVATAR_DATA_FIELDS; i++) {
+        if (hasFieldChanged(i, fields.at(i), _sentKeyframeFields.at(i))) {
+            fieldMask |= (1U << i);
+        }
+    }
+
+    // a joint goes out when it has become valid or turned past the threshold since the keyframe,
+    // the joint section also goes out when a joint has become invalid
+    QVector<bool> changedJoints(_jointData.size());
+    for (int i = 0; i < _jointData.size(); i++) {
+        const JointData& data = _jointData.at(i);
+        const JointData& keyframeData = _sentKeyframeJoints.at(i);
+
+        changedJoints[i] = data.valid && (!keyframeData.valid
+            || fabsf(glm::dot(data.rotation, keyframeData.rotation)) < JOINT_ROTATION_DELTA_MIN_DOT);
+
+        if (changedJoints.at(i) || data.valid != keyframeData.valid) {
+            fieldMask |= AVATAR_JOINTS_FIELD_BIT;
+        }
+    }
+
+    ++_deltasSinceKeyframe;
+    return encodeFields(fields, fieldMask, changedJoints, _sentKeyframeID);
 }
 
 bool AvatarData::shouldLogError(const quint64& now) {
@@ -282,279 +441,341 @@ int AvatarData::parseDataAtOffset(const QByteArray& packet, int offset) {
     const unsigned char* sourceBuffer = startPosition;
     quint64 now = usecTimestampNow();
 
-    // The absolute minimum size of the update data is as follows:
-    // 50 bytes of "plain old data" {
-    //     position      = 12 bytes
-    //     bodyYaw       =  2 (compressed float)
-    //     bodyPitch     =  2 (compressed float)
-    //     bodyRoll      =  2 (compressed float)
-    //     targetScale   =  2 (compressed float)
-    //     headPitch     =  2 (compressed float)
-    //     headYaw       =  2 (compressed float)
-    //     headRoll      =  2 (compressed float)
-    //     lookAt        = 12
-    //     audioLoudness =  4
-    // }
-    // + 1 byte for pupilSize
-    // + 1 byte for numJoints (0)
-    // = 45 bytes
-    int minPossibleSize = 45;
-    
+    // every update starts with the ID of its keyframe and the mask of the fields it carries
+    int minPossibleSize = sizeof(quint8) + sizeof(quint16);
     int maxAvailableSize = packet.size() - offset;
-    if (minPossibleSize > maxAvailableSize) {
+
+    auto reportMalformed = [&](const char* where) -> int {
         if (shouldLogError(now)) {
-            qCDebug(avatars) << "Malformed AvatarData packet at the start; "
+            qCDebug(avatars) << "Malformed AvatarData packet" << where << ";"
                 << " displayName = '" << _displayName << "'"
-                << " minPossibleSize = " << minPossibleSize 
+                << " minPossibleSize = " << minPossibleSize
                 << " maxAvailableSize = " << maxAvailableSize;
         }
         // this packet is malformed so we report all bytes as consumed
         return maxAvailableSize;
+    };
+
+    if (minPossibleSize > maxAvailableSize) {
+        return reportMalformed("at the start");
     }
 
-    { // Body world position, rotation, and scale
-        // position
-        glm::vec3 position;
-        memcpy(&position, sourceBuffer, sizeof(position));
-        sourceBuffer += sizeof(position);
-        
-        if (glm::isnan(position.x) || glm::isnan(position.y) || glm::isnan(position.z)) {
-            if (shouldLogError(now)) {
-                qCDebug(avatars) << "Discard nan AvatarData::position; displayName = '" << _displayName << "'";
+    quint8 keyframeID = *sourceBuffer++;
+    quint16 fieldMask;
+    memcpy(&fieldMask, sourceBuffer, sizeof(fieldMask));
+    sourceBuffer += sizeof(fieldMask);
+
+    bool isKeyframe = fieldMask & AVATAR_KEYFRAME_BIT;
+    if (isKeyframe && (fieldMask & (AVATAR_JOINTS_FIELD_BIT | (AVATAR_JOINTS_FIELD_BIT - 1)))
+            != (AVATAR_JOINTS_FIELD_BIT | (AVATAR_JOINTS_FIELD_BIT - 1))) {
+        return reportMalformed("with a keyframe missing fields");
+    }
+
+    QVector<QByteArray> fields(NUM_AVATAR_DATA_FIELDS);
+    for (int i = 0; i < NUM_AVATAR_DATA_FIELDS; i++) {
+        if (!(fieldMask & (1U << i))) {
+            continue;
+        }
+
+        int fieldSize = AVATAR_DATA_FIELD_SIZES[i];
+        if (fieldSize == VARIABLE_FIELD_SIZE) {
+            quint16 variableFieldSize;
+            minPossibleSize += sizeof(variableFieldSize);
+            if (minPossibleSize > maxAvailableSize) {
+                return reportMalformed("before a field size");
             }
-            return maxAvailableSize;
+            memcpy(&variableFieldSize, sourceBuffer, sizeof(variableFieldSize));
+            sourceBuffer += sizeof(variableFieldSize);
+            fieldSize = variableFieldSize;
         }
-        setPosition(position);
-        
-        // rotation (NOTE: This needs to become a quaternion to save two bytes)
-        float yaw, pitch, roll;
-        sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &yaw);
-        sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &pitch);
-        sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &roll);
-        if (glm::isnan(yaw) || glm::isnan(pitch) || glm::isnan(roll)) {
-            if (shouldLogError(now)) {
-                qCDebug(avatars) << "Discard nan AvatarData::yaw,pitch,roll; displayName = '" << _displayName << "'";
+
+        minPossibleSize += fieldSize;
+        if (minPossibleSize > maxAvailableSize) {
+            return reportMalformed("in a field");
+        }
+        fields[i] = byteArrayFromBuffer(sourceBuffer, sourceBuffer + fieldSize);
+        sourceBuffer += fieldSize;
+    }
+
+    // joint data
+    bool hasJoints = fieldMask & AVATAR_JOINTS_FIELD_BIT;
+    QVector<JointData> jointData;
+    QVector<bool> changedJoints;
+    if (hasJoints) {
+        minPossibleSize++;
+        if (minPossibleSize > maxAvailableSize) {
+            return reportMalformed("before JointCount");
+        }
+        int numJoints = *sourceBuffer++;
+        int bytesOfBits = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
+
+        // validity bits then changed bits
+        minPossibleSize += 2 * bytesOfBits;
+        if (minPossibleSize > maxAvailableSize) {
+            return reportMalformed("after JointBits");
+        }
+        QVector<bool> validJoints(numJoints);
+        changedJoints.resize(numJoints);
+        sourceBuffer += unpackJointBits(sourceBuffer, validJoints);
+        sourceBuffer += unpackJointBits(sourceBuffer, changedJoints);
+
+        minPossibleSize += changedJoints.count(true) * SMALLEST_THREE_QUAT_BYTES;
+        if (minPossibleSize > maxAvailableSize) {
+            return reportMalformed("after JointData");
+        }
+
+        jointData.resize(numJoints);
+        for (int i = 0; i < numJoints; i++) {
+            JointData& data = jointData[i];
+            data.valid = validJoints.at(i);
+            if (changedJoints.at(i)) {
+                sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, data.rotation);
             }
-            return maxAvailableSize;
         }
-        if (_bodyYaw != yaw || _bodyPitch != pitch || _bodyRoll != roll) {
+    }
+
+    int numBytesRead = sourceBuffer - startPosition;
+
+    if (!isKeyframe) {
+        if (!_hasReceivedKeyframe || keyframeID != _receivedKeyframeID
+                || (hasJoints && jointData.size() != _receivedKeyframeJoints.size())) {
+            // we don't have the keyframe this delta was taken against, wait for the next one
+            return numBytesRead;
+        }
+
+        // anything the delta doesn't carry is still what it was in the keyframe
+        for (int i = 0; i < NUM_AVATAR_DATA_FIELDS; i++) {
+            if (!(fieldMask & (1U << i))) {
+                fields[i] = _receivedKeyframeFields.at(i);
+            }
+        }
+        if (hasJoints) {
+            for (int i = 0; i < jointData.size(); i++) {
+                if (!changedJoints.at(i)) {
+                    jointData[i].rotation = _receivedKeyframeJoints.at(i).rotation;
+                }
+            }
+        } else {
+            jointData = _receivedKeyframeJoints;
+        }
+    }
+
+    // the fields are unpacked in order, the face data needs the bit items in the state field before it
+    for (int i = 0; i < NUM_AVATAR_DATA_FIELDS; i++) {
+        if (!unpackField(i, fields.at(i), now)) {
+            // the rest of the packet is fine, it is just this update we throw away
+            return numBytesRead;
+        }
+    }
+
+    _jointData = jointData;
+    foreach (const JointData& data, _jointData) {
+        if (data.valid) {
             _hasNewJointRotations = true;
-            _bodyYaw = yaw;
-            _bodyPitch = pitch;
-            _bodyRoll = roll;
+            break;
         }
-        
-        // scale
-        float scale;
-        sourceBuffer += unpackFloatRatioFromTwoByte(sourceBuffer, scale);
-        if (glm::isnan(scale)) {
-            if (shouldLogError(now)) {
-                qCDebug(avatars) << "Discard nan AvatarData::scale; displayName = '" << _displayName << "'";
+    }
+
+    if (isKeyframe) {
+        _receivedKeyframeFields = fields;
+        _receivedKeyframeJoints = jointData;
+        _receivedKeyframeID = keyframeID;
+        _hasReceivedKeyframe = true;
+    }
+
+    _averageBytesReceived.updateAverage(numBytesRead); 
+    return numBytesRead;
+}
+
+bool AvatarData::unpackField(int field, const QByteArray& data, quint64 now) {
+    const unsigned char* sourceBuffer = reinterpret_cast<const unsigned char*>(data.constData());
+
+    switch (field) {
+        case AVATAR_POSITION_FIELD: {
+            glm::vec3 position;
+            memcpy(&position, sourceBuffer, sizeof(position));
+            if (glm::isnan(position.x) || glm::isnan(position.y) || glm::isnan(position.z)) {
+                if (shouldLogError(now)) {
+                    qCDebug(avatars) << "Discard nan AvatarData::position; displayName = '" << _displayName << "'";
+                }
+                return false;
             }
-            return maxAvailableSize;
+            setPosition(position);
+            return true;
         }
-        _targetScale = scale;
-    } // 20 bytes
-    
-    { // Head rotation 
-        //(NOTE: This needs to become a quaternion to save two bytes)
-        float headYaw, headPitch, headRoll;
-        sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &headPitch);
-        sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &headYaw);
-        sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &headRoll);
-        if (glm::isnan(headYaw) || glm::isnan(headPitch) || glm::isnan(headRoll)) {
-            if (shouldLogError(now)) {
-                qCDebug(avatars) << "Discard nan AvatarData::headYaw,headPitch,headRoll; displayName = '" << _displayName << "'";
+        case AVATAR_BODY_ORIENTATION_FIELD: {
+            // rotation (NOTE: This needs to become a quaternion to save two bytes)
+            float yaw, pitch, roll;
+            sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &yaw);
+            sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &pitch);
+            sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &roll);
+            if (glm::isnan(yaw) || glm::isnan(pitch) || glm::isnan(roll)) {
+                if (shouldLogError(now)) {
+                    qCDebug(avatars) << "Discard nan AvatarData::yaw,pitch,roll; displayName = '" << _displayName << "'";
+                }
+                return false;
+            }
+            if (_bodyYaw != yaw || _bodyPitch != pitch || _bodyRoll != roll) {
+                _hasNewJointRotations = true;
+                _bodyYaw = yaw;
+                _bodyPitch = pitch;
+                _bodyRoll = roll;
             }
-            return maxAvailableSize;
+            return true;
         }
-        _headData->setBasePitch(headPitch);
-        _headData->setBaseYaw(headYaw);
-        _headData->setBaseRoll(headRoll);
-    } // 6 bytes
-    
-    { // Lookat Position
-        glm::vec3 lookAt;
-        memcpy(&lookAt, sourceBuffer, sizeof(lookAt));
-        sourceBuffer += sizeof(lookAt);
-        if (glm::isnan(lookAt.x) || glm::isnan(lookAt.y) || glm::isnan(lookAt.z)) {
-            if (shouldLogError(now)) {
-                qCDebug(avatars) << "Discard nan AvatarData::lookAt; displayName = '" << _displayName << "'";
+        case AVATAR_SCALE_FIELD: {
+            float scale;
+            unpackFloatRatioFromTwoByte(sourceBuffer, scale);
+            if (glm::isnan(scale)) {
+                if (shouldLogError(now)) {
+                    qCDebug(avatars) << "Discard nan AvatarData::scale; displayName = '" << _displayName << "'";
+                }
+                return false;
             }
-            return maxAvailableSize;
+            _targetScale = scale;
+            return true;
         }
-        _headData->_lookAtPosition = lookAt;
-    } // 12 bytes
-    
-    { // AudioLoudness
-        // Instantaneous audio loudness (used to drive facial animation)
-        float audioLoudness;
-        memcpy(&audioLoudness, sourceBuffer, sizeof(float));
-        sourceBuffer += sizeof(float);
-        if (glm::isnan(audioLoudness)) {
-            if (shouldLogError(now)) {
-                qCDebug(avatars) << "Discard nan AvatarData::audioLoudness; displayName = '" << _displayName << "'";
+        case AVATAR_HEAD_ORIENTATION_FIELD: {
+            //(NOTE: This needs to become a quaternion to save two bytes)
+            float headYaw, headPitch, headRoll;
+            sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &headPitch);
+            sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &headYaw);
+            sourceBuffer += unpackFloatAngleFromTwoByte((uint16_t*) sourceBuffer, &headRoll);
+            if (glm::isnan(headYaw) || glm::isnan(headPitch) || glm::isnan(headRoll)) {
+                if (shouldLogError(now)) {
+                    qCDebug(avatars) << "Discard nan AvatarData::headYaw,headPitch,headRoll; displayName = '" << _displayName << "'";
+                }
+                return false;
             }
-            return maxAvailableSize;
-         }
-        _headData->_audioLoudness = audioLoudness;
-    } // 4 bytes
-    
-    { // bitFlags and face data
-        unsigned char bitItems = *sourceBuffer++;
-        
-        // key state, stored as a semi-nibble in the bitItems
-        _keyState = (KeyState)getSemiNibbleAt(bitItems,KEY_STATE_START_BIT);
-
-        // hand state, stored as a semi-nibble plus a bit in the bitItems
-        // we store the hand state as well as other items in a shared bitset. The hand state is an octal, but is split 
-        // into two sections to maintain backward compatibility. The bits are ordered as such (0-7 left to right).
-        //     +---+-----+-----+--+
-        //     |x,x|H0,H1|x,x,x|H2|
-        //     +---+-----+-----+--+
-        // Hand state - H0,H1,H2 is found in the 3rd, 4th, and 8th bits
-        _handState = getSemiNibbleAt(bitItems, HAND_STATE_START_BIT) 
-            + (oneAtBit(bitItems, HAND_STATE_FINGER_POINTING_BIT) ? IS_FINGER_POINTING_FLAG : 0);
-        
-        _headData->_isFaceTrackerConnected = oneAtBit(bitItems, IS_FACESHIFT_CONNECTED);
-        bool hasReferential = oneAtBit(bitItems, HAS_REFERENTIAL);
-        
-        // Referential
-        if (hasReferential) {
-            Referential* ref = new Referential(sourceBuffer, this);
-            if (_referential == NULL ||
-                ref->version() != _referential->version()) {
-                changeReferential(ref);
-            } else {
-                delete ref;
+            _headData->setBasePitch(headPitch);
+            _headData->setBaseYaw(headYaw);
+            _headData->setBaseRoll(headRoll);
+            return true;
+        }
+        case AVATAR_LOOK_AT_FIELD: {
+            glm::vec3 lookAt;
+            memcpy(&lookAt, sourceBuffer, sizeof(lookAt));
+            if (glm::isnan(lookAt.x) || glm::isnan(lookAt.y) || glm::isnan(lookAt.z)) {
+                if (shouldLogError(now)) {
+                    qCDebug(avatars) << "Discard nan AvatarData::lookAt; displayName = '" << _displayName << "'";
+                }
+                return false;
             }
-            _referential->update();
-        } else if (_referential != NULL) {
-            changeReferential(NULL);
+            _headData->_lookAtPosition = lookAt;
+            return true;
         }
-    
-    
-        if (_headData->_isFaceTrackerConnected) {
+        case AVATAR_AUDIO_LOUDNESS_FIELD: {
+            // Instantaneous audio loudness (used to drive facial animation)
+            float audioLoudness;
+            memcpy(&audioLoudness, sourceBuffer, sizeof(float));
+            if (glm::isnan(audioLoudness)) {
+                if (shouldLogError(now)) {
+                    qCDebug(avatars) << "Discard nan AvatarData::audioLoudness; displayName = '" << _displayName << "'";
+                }
+                return false;
+            }
+            _headData->_audioLoudness = audioLoudness;
+            return true;
+        }
+        case AVATAR_STATE_FIELD: {
+            if (data.isEmpty()) {
+                if (shouldLogError(now)) {
+                    qCDebug(avatars) << "Malformed AvatarData bit items; displayName = '" << _displayName << "'";
+                }
+                return false;
+            }
+            unsigned char bitItems = *sourceBuffer++;
+
+            // key state, stored as a semi-nibble in the bitItems
+            _keyState = (KeyState)getSemiNibbleAt(bitItems,KEY_STATE_START_BIT);
+
+            // hand state, stored as a semi-nibble plus a bit in the bitItems
+            // we store the hand state as well as other items in a shared bitset. The hand state is an octal, but is split
+            // into two sections to maintain backward compatibility. The bits are ordered as such (0-7 left to right).
+            //     +---+-----+-----+--+
+            //     |x,x|H0,H1|x,x,x|H2|
+            //     +---+-----+-----+--+
+            // Hand state - H0,H1,H2 is found in the 3rd, 4th, and 8th bits
+            _handState = getSemiNibbleAt(bitItems, HAND_STATE_START_BIT)
+                + (oneAtBit(bitItems, HAND_STATE_FINGER_POINTING_BIT) ? IS_FINGER_POINTING_FLAG : 0);
+
+            _headData->_isFaceTrackerConnected = oneAtBit(bitItems, IS_FACESHIFT_CONNECTED);
+            bool hasReferential = oneAtBit(bitItems, HAS_REFERENTIAL);
+
+            // Referential
+            if (hasReferential) {
+                Referential* ref = new Referential(sourceBuffer, this);
+                if (_referential == NULL ||
+                    ref->version() != _referential->version()) {
+                    changeReferential(ref);
+                } else {
+                    delete ref;
+                }
+                _referential->update();
+            } else if (_referential != NULL) {
+                changeReferential(NULL);
+            }
+            return true;
+        }
+        case AVATAR_FACE_FIELD: {
+            if (!_headData->_isFaceTrackerConnected) {
+                return true;
+            }
+
             float leftEyeBlink, rightEyeBlink, averageLoudness, browAudioLift;
-            minPossibleSize += sizeof(leftEyeBlink) + sizeof(rightEyeBlink) + sizeof(averageLoudness) + sizeof(browAudioLift);
-            minPossibleSize++; // one byte for blendDataSize
-            if (minPossibleSize > maxAvailableSize) {
+            int minPossibleSize = sizeof(leftEyeBlink) + sizeof(rightEyeBlink) + sizeof(averageLoudness)
+                + sizeof(browAudioLift) + 1; // one byte for blendDataSize
+            if (minPossibleSize > data.size()) {
                 if (shouldLogError(now)) {
-                    qCDebug(avatars) << "Malformed AvatarData packet after BitItems;"
-                        << " displayName = '" << _displayName << "'"
-                        << " minPossibleSize = " << minPossibleSize 
-                        << " maxAvailableSize = " << maxAvailableSize;
+                    qCDebug(avatars) << "Malformed AvatarData face data; displayName = '" << _displayName << "'";
                 }
-                return maxAvailableSize;
+                return false;
             }
             // unpack face data
             memcpy(&leftEyeBlink, sourceBuffer, sizeof(float));
             sourceBuffer += sizeof(float);
-            
+
             memcpy(&rightEyeBlink, sourceBuffer, sizeof(float));
             sourceBuffer += sizeof(float);
-            
+
             memcpy(&averageLoudness, sourceBuffer, sizeof(float));
             sourceBuffer += sizeof(float);
-            
+
             memcpy(&browAudioLift, sourceBuffer, sizeof(float));
             sourceBuffer += sizeof(float);
-            
-            if (glm::isnan(leftEyeBlink) || glm::isnan(rightEyeBlink) 
+
+            if (glm::isnan(leftEyeBlink) || glm::isnan(rightEyeBlink)
                     || glm::isnan(averageLoudness) || glm::isnan(browAudioLift)) {
                 if (shouldLogError(now)) {
                     qCDebug(avatars) << "Discard nan AvatarData::faceData; displayName = '" << _displayName << "'";
                 }
-                return maxAvailableSize;
+                return false;
             }
-            _headData->_leftEyeBlink = leftEyeBlink;
-            _headData->_rightEyeBlink = rightEyeBlink;
-            _headData->_averageLoudness = averageLoudness;
-            _headData->_browAudioLift = browAudioLift;
-            
+
             int numCoefficients = (int)(*sourceBuffer++);
             int blendDataSize = numCoefficients * sizeof(float);
-            minPossibleSize += blendDataSize;
-            if (minPossibleSize > maxAvailableSize) {
+            if (minPossibleSize + blendDataSize > data.size()) {
                 if (shouldLogError(now)) {
-                    qCDebug(avatars) << "Malformed AvatarData packet after Blendshapes;"
-                        << " displayName = '" << _displayName << "'"
-                        << " minPossibleSize = " << minPossibleSize 
-                        << " maxAvailableSize = " << maxAvailableSize;
+                    qCDebug(avatars) << "Malformed AvatarData blendshapes; displayName = '" << _displayName << "'";
                 }
-                return maxAvailableSize;
+                return false;
             }
 
+            _headData->_leftEyeBlink = leftEyeBlink;
+            _headData->_rightEyeBlink = rightEyeBlink;
+            _headData->_averageLoudness = averageLoudness;
+            _headData->_browAudioLift = browAudioLift;
+
             _headData->_blendshapeCoefficients.resize(numCoefficients);
             memcpy(_headData->_blendshapeCoefficients.data(), sourceBuffer, blendDataSize);
-            sourceBuffer += numCoefficients * sizeof(float);
-    
-            //bitItemsDataSize = 4 * sizeof(float) + 1 + blendDataSize;
+            return true;
         }
-    } // 1 + bitItemsDataSize bytes
-    
-    { // pupil dilation
-        sourceBuffer += unpackFloatFromByte(sourceBuffer, _headData->_pupilDilation, 1.0f);
-    } // 1 byte
-    
-    // joint data
-    int numJoints = *sourceBuffer++;
-    int bytesOfValidity = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
-    minPossibleSize += bytesOfValidity;
-    if (minPossibleSize > maxAvailableSize) {
-        if (shouldLogError(now)) {
-            qCDebug(avatars) << "Malformed AvatarData packet after JointValidityBits;"
-                << " displayName = '" << _displayName << "'"
-                << " minPossibleSize = " << minPossibleSize 
-                << " maxAvailableSize = " << maxAvailableSize;
-        }
-        return maxAvailableSize;
-    }
-    int numValidJoints = 0;
-    _jointData.resize(numJoints);
-    { // validity bits
-        unsigned char validity = 0;
-        int validityBit = 0;
-        for (int i = 0; i < numJoints; i++) {
-            if (validityBit == 0) {
-                validity = *sourceBuffer++;
-            }
-            bool valid = (bool)(validity & (1 << validityBit));
-            if (valid) {
-                ++numValidJoints;
-            }
-            _jointData[i].valid = valid;
-            validityBit = (validityBit + 1) % BITS_IN_BYTE; 
-        }
-    }
-    // 1 + bytesOfValidity bytes
-
-    // each joint rotation component is stored in two bytes (sizeof(uint16_t))
-    int COMPONENTS_PER_QUATERNION = 4;
-    minPossibleSize += numValidJoints * COMPONENTS_PER_QUATERNION * sizeof(uint16_t);
-    if (minPossibleSize > maxAvailableSize) {
-        if (shouldLogError(now)) {
-            qCDebug(avatars) << "Malformed AvatarData packet after JointData;"
-                << " displayName = '" << _displayName << "'"
-                << " minPossibleSize = " << minPossibleSize 
-                << " maxAvailableSize = " << maxAvailableSize;
-        }
-        return maxAvailableSize;
+        case AVATAR_PUPIL_FIELD:
+            unpackFloatFromByte(sourceBuffer, _headData->_pupilDilation, 1.0f);
+            return true;
+        default:
+            return true;
     }
-
-    { // joint data
-        for (int i = 0; i < numJoints; i++) {
-            JointData& data = _jointData[i];
-            if (data.valid) {
-                _hasNewJointRotations = true;
-                sourceBuffer += unpackOrientationQuatFromBytes(sourceBuffer, data.rotation);
-            }
-        }
-    } // numJoints * 8 bytes
-    
-    int numBytesRead = sourceBuffer - startPosition;
-    _averageBytesReceived.updateAverage(numBytesRead); 
-    return numBytesRead;
 }
 
 int AvatarData::getAverageBytesReceivedPerSecond() const {
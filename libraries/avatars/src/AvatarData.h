@@ -93,6 +93,33 @@ const char LEFT_HAND_POINTING_FLAG = 1;
 const char RIGHT_HAND_POINTING_FLAG = 2;
 const char IS_FINGER_POINTING_FLAG = 4;
 
+// AvatarData goes out either as a keyframe holding every field, or as a delta holding just the fields and joints that
+// have moved past a small threshold since the last keyframe. Deltas are always taken against the keyframe and never
+// against each other, so a lost delta costs nothing and a lost keyframe only costs the deltas until the next one.
+enum AvatarDataField {
+    AVATAR_POSITION_FIELD = 0,
+    AVATAR_BODY_ORIENTATION_FIELD,
+    AVATAR_SCALE_FIELD,
+    AVATAR_HEAD_ORIENTATION_FIELD,
+    AVATAR_LOOK_AT_FIELD,
+    AVATAR_AUDIO_LOUDNESS_FIELD,
+    AVATAR_STATE_FIELD, // bit items and referential
+    AVATAR_FACE_FIELD, // empty unless a face tracker is connected
+    AVATAR_PUPIL_FIELD,
+    NUM_AVATAR_DATA_FIELDS
+};
+
+// the field mask has a bit for each AvatarDataField, one for the joints, and one set on keyframes
+const quint16 AVATAR_JOINTS_FIELD_BIT = 1U << NUM_AVATAR_DATA_FIELDS;
+const quint16 AVATAR_KEYFRAME_BIT = 1U << 15;
+
+const int AVATAR_KEYFRAME_INTERVAL = 60; // serializations, about a second at the rate avatars and the mixer send
+
+const float AVATAR_POSITION_DELTA_THRESHOLD = 0.001f; // meters
+const float AVATAR_LOOK_AT_DELTA_THRESHOLD = 0.01f; // meters
+const float AVATAR_AUDIO_LOUDNESS_DELTA_THRESHOLD = 1.0f;
+const float AVATAR_JOINT_ROTATION_DELTA_THRESHOLD = 0.25f; // degrees
+
 static const float MAX_AVATAR_SCALE = 1000.0f;
 static const float MIN_AVATAR_SCALE = .005f;
 
@@ -167,8 +194,17 @@ public:
     glm::vec3 getHandPosition() const;
     void setHandPosition(const glm::vec3& handPosition);
 
+    /// \return the avatar as a delta against the last keyframe, or as a new keyframe every AVATAR_KEYFRAME_INTERVAL
+    /// calls and whenever the joints change shape
     virtual QByteArray toByteArray();
 
+    /// \return the last keyframe toByteArray produced, for receivers that may not have it yet
+    const QByteArray& getSentKeyframe() const { return _sentKeyframe; }
+    quint8 getSentKeyframeID() const { return _sentKeyframeID; }
+
+    /// \return true if the last toByteArray produced a keyframe rather than a delta
+    bool wasKeyframeSentLast() const { return !_sentKeyframe.isEmpty() && _deltasSinceKeyframe == 0; }
+
     /// \return true if an error should be logged
     bool shouldLogError(const quint64& now);
 
@@ -398,7 +434,26 @@ protected:
 
     SimpleMovingAverage _averageBytesReceived;
 
+    // the last keyframe we serialized, the deltas we send are taken against it
+    QVector<QByteArray> _sentKeyframeFields;
+    QVector<JointData> _sentKeyframeJoints;
+    QByteArray _sentKeyframe;
+    quint8 _sentKeyframeID;
+    int _deltasSinceKeyframe;
+
+    // the last keyframe we parsed, the deltas we receive are applied to it
+    QVector<QByteArray> _receivedKeyframeFields;
+    QVector<JointData> _receivedKeyframeJoints;
+    quint8 _receivedKeyframeID;
+    bool _hasReceivedKeyframe;
+
 private:
+    void packFields(QVector<QByteArray>& fields);
+    QByteArray encodeFields(const QVector<QByteArray>& fields, quint16 fieldMask,
+                            const QVector<bool>& changedJoints, quint8 keyframeID) const;
+    bool unpackField(int field, const QByteArray& data, quint64 now);
+
+
     // privatize the copy constructor and assignment operator so they cannot be called
     AvatarData(const AvatarData&);
     AvatarData& operator= (const AvatarData&);
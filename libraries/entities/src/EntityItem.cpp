@@ -290,6 +290,31 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     return appendState;
 }
 
+bool EntityItem::appendCachedEntityData(OctreePacketData* packetData) const {
+    QByteArray cachedEntityData;
+    {
+        QMutexLocker locker(&_cachedEntityDataMutex);
+        if (_cachedEntityDataLastEdited != _lastEdited || _cachedEntityDataLastUpdated != _lastUpdated
+            || _cachedEntityDataLastSimulated != _lastSimulated || _cachedEntityDataSimulatorID != _simulatorID) {
+            return false;
+        }
+        cachedEntityData = _cachedEntityData;
+    }
+    return !cachedEntityData.isEmpty()
+        && packetData->appendRawData((const unsigned char*)cachedEntityData.constData(), cachedEntityData.size());
+}
+
+void EntityItem::cacheEntityData(const unsigned char* data, int length) const {
+    QByteArray entityData((const char*)data, length);
+
+    QMutexLocker locker(&_cachedEntityDataMutex);
+    _cachedEntityData.swap(entityData);
+    _cachedEntityDataLastEdited = _lastEdited;
+    _cachedEntityDataLastUpdated = _lastUpdated;
+    _cachedEntityDataLastSimulated = _lastSimulated;
+    _cachedEntityDataSimulatorID = _simulatorID;
+}
+
 // TODO: My goal is to get rid of this concept completely. The old code (and some of the current code) used this
 // result to calculate if a packet being sent to it was potentially bad or corrupt. I've adjusted this to now
 // only consider the minimum header bytes as being required. But it would be preferable to completely eliminate
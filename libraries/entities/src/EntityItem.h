@@ -16,6 +16,8 @@
 
 #include <glm/glm.hpp>
 
+#include <QtCore/QMutex>
+
 #include <AnimationCache.h> // for Animation, AnimationCache, and AnimationPointer classes
 #include <CollisionInfo.h>
 #include <Octree.h> // for EncodeBitstreamParams class
@@ -140,6 +142,13 @@ public:
                                     int& propertyCount, 
                                     OctreeElement::AppendState& appendState) const { /* do nothing*/ };
 
+    /// Appends the bytes appendEntityData last wrote for this entity with all of its properties, as long as the entity
+    /// hasn't changed since. Returns false without appending anything if there are no such bytes or they don't fit.
+    bool appendCachedEntityData(OctreePacketData* packetData) const;
+
+    /// Keeps the bytes appendEntityData just wrote for all of this entity's properties, for appendCachedEntityData
+    void cacheEntityData(const unsigned char* data, int length) const;
+
     static EntityItemID readEntityItemIDFromBuffer(const unsigned char* data, int bytesLeftToRead, 
                                     ReadBitstreamToTreeParams& args);
 
@@ -417,6 +426,14 @@ protected:
     EntityTreeElement* _element = nullptr; // set by EntityTreeElement
     void* _physicsInfo = nullptr; // set by EntitySimulation
     bool _simulated; // set by EntitySimulation
+
+    // the last complete encoding of this entity and the times it was encoded at, shared by every send thread
+    mutable QMutex _cachedEntityDataMutex;
+    mutable QByteArray _cachedEntityData;
+    mutable quint64 _cachedEntityDataLastEdited = 0;
+    mutable quint64 _cachedEntityDataLastUpdated = 0;
+    mutable quint64 _cachedEntityDataLastSimulated = 0;
+    mutable QUuid _cachedEntityDataSimulatorID; // the simulation can clear this without touching any of the times
 };
 
 #endif // hifi_EntityItem_h
@@ -134,6 +134,7 @@ void EntitySimulation::sortEntitiesThatMoved() {
             itemItr = _entitiesToSort.erase(itemItr);
         } else {
             moveOperator.addEntityToMoveList(entity, newCube);
+            _entityTree->journalChangedEntity(entity->getEntityItemID());
             ++itemItr;
         }
     }
@@ -10,6 +10,7 @@
 //
 
 #include <PerfStat.h>
+#include <QDataStream>
 #include <QDateTime>
 #include <QtScript/QScriptEngine>
 
@@ -22,7 +23,7 @@
 #include "UpdateEntityOperator.h"
 #include "QVariantGLM.h"
 #include "EntitiesLogging.h"
-#include "RecurseOctreeToMapOperator.h"
+#include "EntityTreeSnapshot.h"
 
 
 const quint64 SIMULATOR_CHANGE_LOCKOUT_PERIOD = (quint64)(0.2f * USECS_PER_SECOND);
@@ -55,10 +56,22 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
         _simulation->clearEntities();
         _simulation->unlock();
     }
-    foreach (EntityTreeElement* element, _entityToElementMap) {
+    QSet<EntityTreeElement*> elementsWithEntities;
+    foreach (EntityItem* entity, _entityMap) {
+        elementsWithEntities.insert(entity->getElement());
+    }
+    foreach (EntityTreeElement* element, elementsWithEntities) {
         element->cleanupEntities();
     }
-    _entityToElementMap.clear();
+    _entityMap.clear();
+
+    // whatever was journaled no longer describes the tree, the whole tree will need to be written
+    for (size_t i = 0; i < _changeJournals.size(); i++) {
+        _changeJournals[i].changedEntities.clear();
+        _changeJournals[i].deletedEntities.clear();
+        _changeJournals[i].hasLostChanges = true;
+    }
+
     Octree::eraseAllOctreeElements(createNewRoot);
 }
 
@@ -84,6 +97,7 @@ void EntityTree::postAddEntity(EntityItem* entity) {
         _simulation->unlock();
     }
     _isDirty = true;
+    journalChangedEntity(entity->getEntityItemID());
     emit addingEntity(entity->getEntityItemID());
 }
 
@@ -144,6 +158,7 @@ bool EntityTree::updateEntityWithElement(EntityItem* entity, const EntityItemPro
                 UpdateEntityOperator theOperator(this, containingElement, entity, tempProperties);
                 recurseTreeWithOperator(&theOperator);
                 _isDirty = true;
+                journalChangedEntity(entity->getEntityItemID());
             }
         }
     } else {
@@ -188,6 +203,7 @@ bool EntityTree::updateEntityWithElement(EntityItem* entity, const EntityItemPro
         UpdateEntityOperator theOperator(this, containingElement, entity, properties);
         recurseTreeWithOperator(&theOperator);
         _isDirty = true;
+        journalChangedEntity(entity->getEntityItemID());
 
         uint32_t newFlags = entity->getDirtyFlags() & ~preFlags;
         if (newFlags) {
@@ -372,6 +388,11 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
             _recentlyDeletedEntitiesLock.unlock();
         }
 
+        for (size_t i = 0; i < _changeJournals.size(); i++) {
+            _changeJournals[i].changedEntities.remove(theEntity->getEntityItemID());
+            _changeJournals[i].deletedEntities.insert(theEntity->getEntityItemID());
+        }
+
         if (_simulation) {
             _simulation->removeEntity(theEntity);
         } 
@@ -535,12 +556,7 @@ EntityItem* EntityTree::findEntityByID(const QUuid& id) {
 }
 
 EntityItem* EntityTree::findEntityByEntityItemID(const EntityItemID& entityID) /*const*/ {
-    EntityItem* foundEntity = NULL;
-    EntityTreeElement* containingElement = getContainingElement(entityID);
-    if (containingElement) {
-        foundEntity = containingElement->getEntityWithEntityItemID(entityID);
-    }
-    return foundEntity;
+    return _entityMap.value(entityID);
 }
 
 int EntityTree::processEditPacketData(PacketType packetType, const unsigned char* packetData, int packetLength,
@@ -684,14 +700,14 @@ void EntityTree::update() {
     }
 }
 
-bool EntityTree::hasEntitiesDeletedSince(quint64 sinceTime) {
+bool EntityTree::hasEntitiesDeletedSince(quint64 sinceTime, quint64 untilTime) {
     // we can probably leverage the ordered nature of QMultiMap to do this quickly...
     bool hasSomethingNewer = false;
 
     _recentlyDeletedEntitiesLock.lockForRead();
     QMultiMap<quint64, QUuid>::const_iterator iterator = _recentlyDeletedEntityItemIDs.constBegin();
     while (iterator != _recentlyDeletedEntityItemIDs.constEnd()) {
-        if (iterator.key() > sinceTime) {
+        if (iterator.key() > sinceTime && iterator.key() <= untilTime) {
             hasSomethingNewer = true;
         }
         ++iterator;
@@ -701,8 +717,8 @@ bool EntityTree::hasEntitiesDeletedSince(quint64 sinceTime) {
 }
 
 // sinceTime is an in/out parameter - it will be side effected with the last time sent out
-bool EntityTree::encodeEntitiesDeletedSince(OCTREE_PACKET_SEQUENCE sequenceNumber, quint64& sinceTime, unsigned char* outputBuffer,
-                                            size_t maxLength, size_t& outputLength) {
+bool EntityTree::encodeEntitiesDeletedSince(OCTREE_PACKET_SEQUENCE sequenceNumber, quint64& sinceTime, quint64 untilTime,
+                                            unsigned char* outputBuffer, size_t maxLength, size_t& outputLength) {
     bool hasMoreToSend = true;
 
     unsigned char* copyAt = outputBuffer;
@@ -742,7 +758,7 @@ bool EntityTree::encodeEntitiesDeletedSince(OCTREE_PACKET_SEQUENCE sequenceNumbe
     _recentlyDeletedEntitiesLock.lockForRead();
 
     QMultiMap<quint64, QUuid>::const_iterator iterator = _recentlyDeletedEntityItemIDs.constBegin();
-    while (iterator != _recentlyDeletedEntityItemIDs.constEnd()) {
+    while (iterator != _recentlyDeletedEntityItemIDs.constEnd() && iterator.key() <= untilTime) {
         QList<QUuid> values = _recentlyDeletedEntityItemIDs.values(iterator.key());
         for (int valueItem = 0; valueItem < values.size(); ++valueItem) {
 
@@ -773,7 +789,7 @@ bool EntityTree::encodeEntitiesDeletedSince(OCTREE_PACKET_SEQUENCE sequenceNumbe
     }
 
     // if we got to the end, then we're done sending
-    if (iterator == _recentlyDeletedEntityItemIDs.constEnd()) {
+    if (iterator == _recentlyDeletedEntityItemIDs.constEnd() || iterator.key() > untilTime) {
         hasMoreToSend = false;
     }
     _recentlyDeletedEntitiesLock.unlock();
@@ -908,25 +924,26 @@ int EntityTree::processEraseMessageDetails(const QByteArray& dataByteArray, cons
 
 EntityTreeElement* EntityTree::getContainingElement(const EntityItemID& entityItemID)  /*const*/ {
     // TODO: do we need to make this thread safe? Or is it acceptable as is
-    EntityTreeElement* element = _entityToElementMap.value(entityItemID);
-    return element;
+    EntityItem* entity = _entityMap.value(entityItemID);
+    return entity ? entity->getElement() : NULL;
 }
 
-void EntityTree::setContainingElement(const EntityItemID& entityItemID, EntityTreeElement* element) {
+void EntityTree::setContainingElement(EntityItem* entity, EntityTreeElement* element) {
     // TODO: do we need to make this thread safe? Or is it acceptable as is
     if (element) {
-        _entityToElementMap[entityItemID] = element;
+        assert(entity->getElement() == element);
+        _entityMap[entity->getEntityItemID()] = entity;
     } else {
-        _entityToElementMap.remove(entityItemID);
+        _entityMap.remove(entity->getEntityItemID());
     }
 }
 
 void EntityTree::debugDumpMap() {
     qCDebug(entities) << "EntityTree::debugDumpMap() --------------------------";
-    QHashIterator<EntityItemID, EntityTreeElement*> i(_entityToElementMap);
+    QHashIterator<EntityItemID, EntityItem*> i(_entityMap);
     while (i.hasNext()) {
         i.next();
-        qCDebug(entities) << i.key() << ": " << i.value();
+        qCDebug(entities) << i.key() << ": " << i.value()->getElement();
     }
     qCDebug(entities) << "-----------------------------------------------------";
 }
@@ -1026,14 +1043,103 @@ bool EntityTree::sendEntitiesOperation(OctreeElement* element, void* extraData)
     return true;
 }
 
-bool EntityTree::writeToMap(QVariantMap& entityDescription, OctreeElement* element, bool skipDefaultValues) {
-    entityDescription["Entities"] = QVariantList();
-    QScriptEngine scriptEngine;
-    RecurseOctreeToMapOperator theOperator(entityDescription, element, &scriptEngine, skipDefaultValues);
-    recurseTreeWithOperator(&theOperator);
+bool EntityTree::takeSnapshotOperation(OctreeElement* element, void* extraData) {
+    EntityTreeSnapshot* snapshot = static_cast<EntityTreeSnapshot*>(extraData);
+    EntityTreeElement* entityTreeElement = static_cast<EntityTreeElement*>(element);
+
+    foreach (EntityItem* entity, entityTreeElement->getEntities()) {
+        snapshot->addEntity(entity);
+    }
     return true;
 }
 
+OctreeSnapshot* EntityTree::takeSnapshot(OctreeElement* element) {
+    EntityTreeSnapshot* snapshot = new EntityTreeSnapshot();
+    recurseElementWithOperation(element ? element : _rootElement, takeSnapshotOperation, snapshot);
+    return snapshot;
+}
+
+int EntityTree::startChangeJournal() {
+    _changeJournals.push_back(ChangeJournal());
+    return (int)_changeJournals.size() - 1;
+}
+
+OctreeSnapshot* EntityTree::takeChangesSnapshot(int journalID) {
+    ChangeJournal& journal = _changeJournals[journalID];
+    if (journal.hasLostChanges) {
+        journal.hasLostChanges = false;
+        return NULL;
+    }
+
+    EntityTreeSnapshot* snapshot = new EntityTreeSnapshot();
+    foreach (const EntityItemID& entityID, journal.changedEntities) {
+        EntityItem* entity = findEntityByEntityItemID(entityID);
+        if (entity) {
+            snapshot->addEntity(entity);
+        }
+    }
+    foreach (const EntityItemID& entityID, journal.deletedEntities) {
+        snapshot->addDeletedEntity(entityID);
+    }
+
+    journal.changedEntities.clear();
+    journal.deletedEntities.clear();
+    return snapshot;
+}
+
+void EntityTree::journalChangedEntity(const EntityItemID& entityID) {
+    for (size_t i = 0; i < _changeJournals.size(); i++) {
+        _changeJournals[i].changedEntities.insert(entityID);
+    }
+}
+
+int EntityTree::replayJournal(const QByteArray& journal) {
+    QDataStream journalStream(journal);
+    QScriptEngine scriptEngine;
+    int bytesReplayed = 0;
+
+    while (!journalStream.atEnd()) {
+        QByteArray record;
+        journalStream >> record;
+        if (journalStream.status() != QDataStream::Ok) {
+            break; // the last record was cut short, the server stopped while it was being written
+        }
+
+        QDataStream recordStream(record);
+        quint8 recordType;
+        recordStream >> recordType;
+
+        if (recordType == EntityTreeSnapshot::DeletedEntityRecord) {
+            QUuid entityID;
+            recordStream >> entityID;
+            deleteEntity(EntityItemID(entityID), true, true);
+        } else if (recordType == EntityTreeSnapshot::ChangedEntityRecord) {
+            // a record holds every property of the entity, the same way readFromMap() gets them
+            QVariantMap entityMap;
+            recordStream >> entityMap;
+            QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+            EntityItemProperties properties;
+            EntityItemPropertiesFromScriptValue(entityScriptValue, properties);
+
+            EntityItemID entityID(QUuid(entityMap["id"].toString()));
+            EntityTreeElement* containingElement = getContainingElement(entityID);
+            EntityItem* entity = containingElement ? containingElement->getEntityWithEntityItemID(entityID) : NULL;
+            if (entity) {
+                UpdateEntityOperator theOperator(this, containingElement, entity, properties);
+                recurseTreeWithOperator(&theOperator);
+                entityChanged(entity);
+            } else if (!addEntity(entityID, properties)) {
+                qCDebug(entities) << "replaying journaled entity failed:" << entityID << properties.getType();
+            }
+        }
+
+        bytesReplayed = journalStream.device()->pos();
+    }
+
+    _isDirty = true;
+    return bytesReplayed;
+}
+
 bool EntityTree::readFromMap(QVariantMap& map) {
     // map will have a top-level list keyed as "Entities".  This will be extracted
     // and iterated over.  Each member of this list is converted to a QVariantMap, then
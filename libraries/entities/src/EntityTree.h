@@ -12,6 +12,8 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <vector>
+
 #include <QSet>
 #include <QVector>
 
@@ -128,8 +130,9 @@ public:
     void removeNewlyCreatedHook(NewlyCreatedEntityHook* hook);
 
     bool hasAnyDeletedEntities() const { return _recentlyDeletedEntityItemIDs.size() > 0; }
-    bool hasEntitiesDeletedSince(quint64 sinceTime);
-    bool encodeEntitiesDeletedSince(OCTREE_PACKET_SEQUENCE sequenceNumber, quint64& sinceTime, 
+    // only entities deleted after sinceTime and no later than untilTime
+    bool hasEntitiesDeletedSince(quint64 sinceTime, quint64 untilTime);
+    bool encodeEntitiesDeletedSince(OCTREE_PACKET_SEQUENCE sequenceNumber, quint64& sinceTime, quint64 untilTime,
                                     unsigned char* packetData, size_t maxLength, size_t& outputLength);
     void forgetEntitiesDeletedBefore(quint64 sinceTime);
 
@@ -146,7 +149,7 @@ public:
     }
     
     EntityTreeElement* getContainingElement(const EntityItemID& entityItemID)  /*const*/;
-    void setContainingElement(const EntityItemID& entityItemID, EntityTreeElement* element);
+    void setContainingElement(EntityItem* entity, EntityTreeElement* element);
     void debugDumpMap();
     virtual void dumpTree();
     virtual void pruneTree();
@@ -162,11 +165,23 @@ public:
     bool wantEditLogging() const { return _wantEditLogging; }
     void setWantEditLogging(bool value) { _wantEditLogging = value; }
 
-    bool writeToMap(QVariantMap& entityDescription, OctreeElement* element, bool skipDefaultValues);
+    /// when true, an entity encoded whole for one node is kept encoded and copied into the packets of other nodes
+    /// until it changes, instead of being encoded again for each of them
+    bool wantEncodeCache() const { return _wantEncodeCache; }
+    void setWantEncodeCache(bool value) { _wantEncodeCache = value; }
+
+    virtual OctreeSnapshot* takeSnapshot(OctreeElement* element);
+    virtual int startChangeJournal();
+    virtual OctreeSnapshot* takeChangesSnapshot(int journalID);
+    virtual int replayJournal(const QByteArray& journal);
     bool readFromMap(QVariantMap& entityDescription);
     
     float getContentsLargestDimension();
 
+    /// Notes a change the tree's own edit methods didn't make, like the simulation moving an entity, in the change
+    /// journals. The caller must hold the tree lock for writing.
+    void journalChangedEntity(const EntityItemID& entityID);
+
 signals:
     void deletingEntity(const EntityItemID& entityID);
     void addingEntity(const EntityItemID& entityID);
@@ -185,6 +200,7 @@ private:
     static bool findInCubeOperation(OctreeElement* element, void* extraData);
     static bool findInBoxOperation(OctreeElement* element, void* extraData);
     static bool sendEntitiesOperation(OctreeElement* element, void* extraData);
+    static bool takeSnapshotOperation(OctreeElement* element, void* extraData);
 
     void notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode);
 
@@ -195,11 +211,22 @@ private:
     QMultiMap<quint64, QUuid> _recentlyDeletedEntityItemIDs;
     EntityItemFBXService* _fbxService;
 
-    QHash<EntityItemID, EntityTreeElement*> _entityToElementMap;
+    // every entity in the tree by ID, an entity knows its own containing element
+    QHash<EntityItemID, EntityItem*> _entityMap;
 
     EntitySimulation* _simulation;
     
     bool _wantEditLogging = false;
+    bool _wantEncodeCache = false;
+
+    // what changed since each journal's owner last took its changes. Only touched with the tree locked for writing, or
+    // by the journal's owner with it locked for reading, journals are only added with it locked for writing
+    struct ChangeJournal {
+        bool hasLostChanges = false;
+        QSet<EntityItemID> changedEntities;
+        QSet<EntityItemID> deletedEntities;
+    };
+    std::vector<ChangeJournal> _changeJournals;
 };
 
 #endif // hifi_EntityTree_h
@@ -18,14 +18,12 @@
 #include "EntitiesLogging.h"
 #include "EntityTreeElement.h"
 
-EntityTreeElement::EntityTreeElement(unsigned char* octalCode) : OctreeElement(), _entityItems(NULL) {
+EntityTreeElement::EntityTreeElement(unsigned char* octalCode) : OctreeElement() {
     init(octalCode);
 };
 
 EntityTreeElement::~EntityTreeElement() {
     _octreeMemoryUsage -= sizeof(EntityTreeElement);
-    delete _entityItems;
-    _entityItems = NULL;
 }
 
 // This will be called primarily on addChildAt(), which means we're adding a child of our
@@ -39,7 +37,6 @@ OctreeElement* EntityTreeElement::createNewElement(unsigned char* octalCode) {
 
 void EntityTreeElement::init(unsigned char* octalCode) {
     OctreeElement::init(octalCode);
-    _entityItems = new QList<EntityItem*>;
     _octreeMemoryUsage += sizeof(EntityTreeElement);
 }
 
@@ -71,7 +68,7 @@ void EntityTreeElement::initializeExtraEncodeData(EncodeBitstreamParams& params)
     // Check to see if this element yet has encode data... if it doesn't create it
     if (!extraEncodeData->contains(this)) {
         EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData = new EntityTreeElementExtraEncodeData();
-        entityTreeElementExtraEncodeData->elementCompleted = (_entityItems->size() == 0);
+        entityTreeElementExtraEncodeData->elementCompleted = (_entityItems.size() == 0);
         for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
             EntityTreeElement* child = getChildAtIndex(i);
             if (!child) {
@@ -84,8 +81,8 @@ void EntityTreeElement::initializeExtraEncodeData(EncodeBitstreamParams& params)
                 }
             }
         }
-        for (uint16_t i = 0; i < _entityItems->size(); i++) {
-            EntityItem* entity = (*_entityItems)[i];
+        for (uint16_t i = 0; i < _entityItems.size(); i++) {
+            EntityItem* entity = _entityItems[i];
             entityTreeElementExtraEncodeData->entities.insert(entity->getEntityItemID(), entity->getEntityProperties(params));
         }
         
@@ -248,7 +245,7 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
     } else {
         // if there wasn't one already, then create one
         entityTreeElementExtraEncodeData = new EntityTreeElementExtraEncodeData();
-        entityTreeElementExtraEncodeData->elementCompleted = (_entityItems->size() == 0);
+        entityTreeElementExtraEncodeData->elementCompleted = (_entityItems.size() == 0);
 
         for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
             EntityTreeElement* child = getChildAtIndex(i);
@@ -262,8 +259,8 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
                 }
             }
         }
-        for (uint16_t i = 0; i < _entityItems->size(); i++) {
-            EntityItem* entity = (*_entityItems)[i];
+        for (uint16_t i = 0; i < _entityItems.size(); i++) {
+            EntityItem* entity = _entityItems[i];
             entityTreeElementExtraEncodeData->entities.insert(entity->getEntityItemID(), entity->getEntityProperties(params));
         }
     }
@@ -283,8 +280,8 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
     // entities for encoding. This is needed because we encode the element data at the "parent" level, and so we 
     // need to handle the case where our sibling elements need encoding but we don't.
     if (!entityTreeElementExtraEncodeData->elementCompleted) {
-        for (uint16_t i = 0; i < _entityItems->size(); i++) {
-            EntityItem* entity = (*_entityItems)[i];
+        for (uint16_t i = 0; i < _entityItems.size(); i++) {
+            EntityItem* entity = _entityItems[i];
             bool includeThisEntity = true;
             
             if (!params.forceSendScene && entity->getLastChangedOnServer() < params.lastViewFrustumSent) {
@@ -315,15 +312,33 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
         }
     }
 
+    bool wantEncodeCache = _myTree && _myTree->wantEncodeCache();
+
     int numberOfEntitiesOffset = packetData->getUncompressedByteOffset();
     bool successAppendEntityCount = packetData->appendValue(numberOfEntities);
 
     if (successAppendEntityCount) {
         foreach (uint16_t i, indexesOfEntitiesToInclude) {
-            EntityItem* entity = (*_entityItems)[i];
+            EntityItem* entity = _entityItems[i];
             LevelDetails entityLevel = packetData->startLevel();
-            OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData, 
-                                                                        params, entityTreeElementExtraEncodeData);
+
+            // only an entity being sent with all of its properties can use or leave a cached encoding, not the rest
+            // of an entity that only partially fit in an earlier packet
+            bool canUseEncodeCache = wantEncodeCache && entityTreeElementExtraEncodeData->entities.value(
+                                            entity->getEntityItemID()) == entity->getEntityProperties(params);
+
+            OctreeElement::AppendState appendEntityState;
+            if (canUseEncodeCache && entity->appendCachedEntityData(packetData)) {
+                appendEntityState = OctreeElement::COMPLETED;
+            } else {
+                int entityDataOffset = packetData->getUncompressedByteOffset();
+                appendEntityState = entity->appendEntityData(packetData, params, entityTreeElementExtraEncodeData);
+
+                if (canUseEncodeCache && appendEntityState == OctreeElement::COMPLETED) {
+                    entity->cacheEntityData(packetData->getUncompressedData(entityDataOffset),
+                                            packetData->getUncompressedByteOffset() - entityDataOffset);
+                }
+            }
 
             // If none of this entity data was able to be appended, then discard it
             // and don't include it in our entity count
@@ -476,8 +491,8 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
     // only called if we do intersect our bounding cube, but find if we actually intersect with entities...
     int entityNumber = 0;
     
-    QList<EntityItem*>::iterator entityItr = _entityItems->begin();
-    QList<EntityItem*>::const_iterator entityEnd = _entityItems->end();
+    QList<EntityItem*>::iterator entityItr = _entityItems.begin();
+    QList<EntityItem*>::const_iterator entityEnd = _entityItems.end();
     bool somethingIntersected = false;
     
     //float bestEntityDistance = distance;
@@ -545,8 +560,8 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
 // TODO: change this to use better bounding shape for entity than sphere
 bool EntityTreeElement::findSpherePenetration(const glm::vec3& center, float radius,
                                     glm::vec3& penetration, void** penetratedObject) const {
-    QList<EntityItem*>::iterator entityItr = _entityItems->begin();
-    QList<EntityItem*>::const_iterator entityEnd = _entityItems->end();
+    QList<EntityItem*>::const_iterator entityItr = _entityItems.begin();
+    QList<EntityItem*>::const_iterator entityEnd = _entityItems.end();
     while(entityItr != entityEnd) {
         EntityItem* entity = (*entityItr);
         glm::vec3 entityCenter = entity->getPosition();
@@ -570,11 +585,11 @@ bool EntityTreeElement::findSpherePenetration(const glm::vec3& center, float rad
 const EntityItem* EntityTreeElement::getClosestEntity(glm::vec3 position) const {
     const EntityItem* closestEntity = NULL;
     float closestEntityDistance = FLT_MAX;
-    uint16_t numberOfEntities = _entityItems->size();
+    uint16_t numberOfEntities = _entityItems.size();
     for (uint16_t i = 0; i < numberOfEntities; i++) {
-        float distanceToEntity = glm::distance(position, (*_entityItems)[i]->getPosition());
+        float distanceToEntity = glm::distance(position, _entityItems[i]->getPosition());
         if (distanceToEntity < closestEntityDistance) {
-            closestEntity = (*_entityItems)[i];
+            closestEntity = _entityItems[i];
         }
     }
     return closestEntity;
@@ -582,9 +597,9 @@ const EntityItem* EntityTreeElement::getClosestEntity(glm::vec3 position) const
 
 // TODO: change this to use better bounding shape for entity than sphere
 void EntityTreeElement::getEntities(const glm::vec3& searchPosition, float searchRadius, QVector<const EntityItem*>& foundEntities) const {
-    uint16_t numberOfEntities = _entityItems->size();
+    uint16_t numberOfEntities = _entityItems.size();
     for (uint16_t i = 0; i < numberOfEntities; i++) {
-        const EntityItem* entity = (*_entityItems)[i];
+        const EntityItem* entity = _entityItems[i];
         float distance = glm::length(entity->getPosition() - searchPosition);
         if (distance < searchRadius + entity->getRadius()) {
             foundEntities.push_back(entity);
@@ -594,8 +609,8 @@ void EntityTreeElement::getEntities(const glm::vec3& searchPosition, float searc
 
 // TODO: change this to use better bounding shape for entity than sphere
 void EntityTreeElement::getEntities(const AACube& box, QVector<EntityItem*>& foundEntities) {
-    QList<EntityItem*>::iterator entityItr = _entityItems->begin();
-    QList<EntityItem*>::iterator entityEnd = _entityItems->end();
+    QList<EntityItem*>::iterator entityItr = _entityItems.begin();
+    QList<EntityItem*>::iterator entityEnd = _entityItems.end();
     AACube entityCube;
     while(entityItr != entityEnd) {
         EntityItem* entity = (*entityItr);
@@ -612,56 +627,33 @@ void EntityTreeElement::getEntities(const AACube& box, QVector<EntityItem*>& fou
 }
 
 const EntityItem* EntityTreeElement::getEntityWithEntityItemID(const EntityItemID& id) const {
-    const EntityItem* foundEntity = NULL;
-    uint16_t numberOfEntities = _entityItems->size();
-    for (uint16_t i = 0; i < numberOfEntities; i++) {
-        if ((*_entityItems)[i]->getEntityItemID() == id) {
-            foundEntity = (*_entityItems)[i];
-            break;
-        }
-    }
-    return foundEntity;
+    // the tree knows every entity by its ID, so there's no need to search our list for it
+    const EntityItem* foundEntity = _myTree ? _myTree->findEntityByEntityItemID(id) : NULL;
+    return (foundEntity && foundEntity->getElement() == this) ? foundEntity : NULL;
 }
-   
+
 EntityItem* EntityTreeElement::getEntityWithEntityItemID(const EntityItemID& id) {
-    EntityItem* foundEntity = NULL;
-    uint16_t numberOfEntities = _entityItems->size();
-    for (uint16_t i = 0; i < numberOfEntities; i++) {
-        if ((*_entityItems)[i]->getEntityItemID() == id) {
-            foundEntity = (*_entityItems)[i];
-            break;
-        }
-    }
-    return foundEntity;
+    EntityItem* foundEntity = _myTree ? _myTree->findEntityByEntityItemID(id) : NULL;
+    return (foundEntity && foundEntity->getElement() == this) ? foundEntity : NULL;
 }
 
 void EntityTreeElement::cleanupEntities() {
-    uint16_t numberOfEntities = _entityItems->size();
+    uint16_t numberOfEntities = _entityItems.size();
     for (uint16_t i = 0; i < numberOfEntities; i++) {
-        EntityItem* entity = (*_entityItems)[i];
+        EntityItem* entity = _entityItems[i];
         entity->_element = NULL;
         delete entity;
     }
-    _entityItems->clear();
+    _entityItems.clear();
 }
 
 bool EntityTreeElement::removeEntityWithEntityItemID(const EntityItemID& id) {
-    bool foundEntity = false;
-    uint16_t numberOfEntities = _entityItems->size();
-    for (uint16_t i = 0; i < numberOfEntities; i++) {
-        if ((*_entityItems)[i]->getEntityItemID() == id) {
-            foundEntity = true;
-            (*_entityItems)[i]->_element = NULL;
-            _entityItems->removeAt(i);
-            break;
-        }
-    }
-    return foundEntity;
+    EntityItem* entity = getEntityWithEntityItemID(id);
+    return entity ? removeEntityItem(entity) : false;
 }
 
 bool EntityTreeElement::removeEntityItem(EntityItem* entity) {
-    int numEntries = _entityItems->removeAll(entity);
-    if (numEntries > 0) {
+    if (_entityItems.removeOne(entity)) {
         assert(entity->_element == this);
         entity->_element = NULL;
         return true;
@@ -669,7 +661,6 @@ bool EntityTreeElement::removeEntityItem(EntityItem* entity) {
     return false;
 }
 
-
 // Things we want to accomplish as we read these entities from the data buffer.
 //
 // 1) correctly update the properties of the entity
@@ -740,7 +731,7 @@ int EntityTreeElement::readElementDataFromBuffer(const unsigned char* data, int
                             if (currentContainingElement != this) {
                                 currentContainingElement->removeEntityItem(entityItem);
                                 addEntityItem(entityItem);
-                                _myTree->setContainingElement(entityItemID, this);
+                                _myTree->setContainingElement(entityItem, this);
                             }
                         }
                     }
@@ -756,7 +747,7 @@ int EntityTreeElement::readElementDataFromBuffer(const unsigned char* data, int
                         bytesForThisEntity = entityItem->readEntityDataFromBuffer(dataAt, bytesLeftToRead, args);
                         addEntityItem(entityItem); // add this new entity to this elements entities
                         entityItemID = entityItem->getEntityItemID();
-                        _myTree->setContainingElement(entityItemID, this);
+                        _myTree->setContainingElement(entityItem, this);
                         _myTree->postAddEntity(entityItem);
                     }
                 }
@@ -774,7 +765,7 @@ int EntityTreeElement::readElementDataFromBuffer(const unsigned char* data, int
 void EntityTreeElement::addEntityItem(EntityItem* entity) {
     assert(entity);
     assert(entity->_element == NULL);
-    _entityItems->push_back(entity);
+    _entityItems.push_back(entity);
     entity->_element = this;
 }
 
@@ -807,9 +798,9 @@ bool EntityTreeElement::pruneChildren() {
 }
 
 void EntityTreeElement::expandExtentsToContents(Extents& extents) {
-    if (_entityItems->size()) {
-        for (uint16_t i = 0; i < _entityItems->size(); i++) {
-            EntityItem* entity = (*_entityItems)[i];
+    if (_entityItems.size()) {
+        for (uint16_t i = 0; i < _entityItems.size(); i++) {
+            EntityItem* entity = _entityItems[i];
             extents.add(entity->getAABox());
         }
     }
@@ -821,11 +812,11 @@ void EntityTreeElement::debugDump() {
     qCDebug(entities) << "EntityTreeElement...";
     qCDebug(entities) << "    cube:" << _cube;
     qCDebug(entities) << "    has child elements:" << getChildCount();
-    if (_entityItems->size()) {
-        qCDebug(entities) << "    has entities:" << _entityItems->size();
+    if (_entityItems.size()) {
+        qCDebug(entities) << "    has entities:" << _entityItems.size();
         qCDebug(entities) << "--------------------------------------------------";
-        for (uint16_t i = 0; i < _entityItems->size(); i++) {
-            EntityItem* entity = (*_entityItems)[i];
+        for (uint16_t i = 0; i < _entityItems.size(); i++) {
+            EntityItem* entity = _entityItems[i];
             entity->debugDump();
         }
         qCDebug(entities) << "--------------------------------------------------";
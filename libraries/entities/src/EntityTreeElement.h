@@ -142,9 +142,9 @@ public:
     virtual bool findSpherePenetration(const glm::vec3& center, float radius,
                         glm::vec3& penetration, void** penetratedObject) const;
 
-    const QList<EntityItem*>& getEntities() const { return *_entityItems; }
-    QList<EntityItem*>& getEntities() { return *_entityItems; }
-    bool hasEntities() const { return _entityItems ? _entityItems->size() > 0 : false; }
+    const QList<EntityItem*>& getEntities() const { return _entityItems; }
+    QList<EntityItem*>& getEntities() { return _entityItems; }
+    bool hasEntities() const { return _entityItems.size() > 0; }
 
     void setTree(EntityTree* tree) { _myTree = tree; }
 
@@ -198,7 +198,7 @@ public:
 protected:
     virtual void init(unsigned char * octalCode);
     EntityTree* _myTree;
-    QList<EntityItem*>* _entityItems;
+    QList<EntityItem*> _entityItems;
 };
 
 #endif // hifi_EntityTreeElement_h
@@ -0,0 +1,64 @@
+//
+//  EntityTreeSnapshot.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QDataStream>
+#include <QtScript/QScriptEngine>
+
+#include "EntityItem.h"
+#include "EntityTreeSnapshot.h"
+
+void EntityTreeSnapshot::addEntity(const EntityItem* entity) {
+    _entities << entity->getProperties();
+}
+
+qint64 EntityTreeSnapshot::getMemoryUsage() const {
+    return sizeof(EntityTreeSnapshot) + (qint64)_entities.capacity() * sizeof(EntityItemProperties)
+        + (qint64)_deletedEntities.capacity() * sizeof(EntityItemID);
+}
+
+bool EntityTreeSnapshot::writeToMap(QVariantMap& entityDescription, bool skipDefaultValues) const {
+    QScriptEngine scriptEngine;
+    QVariantList entitiesQList;
+    entitiesQList.reserve(_entities.size());
+
+    foreach (const EntityItemProperties& properties, _entities) {
+        QScriptValue qScriptValues;
+        if (skipDefaultValues) {
+            qScriptValues = EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, properties);
+        } else {
+            qScriptValues = EntityItemPropertiesToScriptValue(&scriptEngine, properties);
+        }
+        entitiesQList << qScriptValues.toVariant();
+    }
+
+    entityDescription["Entities"] = entitiesQList;
+    return true;
+}
+
+void EntityTreeSnapshot::writeToJournal(QByteArray& journal) const {
+    // each record is written as a QByteArray, so replaying can tell when the last one was cut short
+    QDataStream journalStream(&journal, QIODevice::Append);
+
+    foreach (const EntityItemID& entityID, _deletedEntities) {
+        QByteArray record;
+        QDataStream recordStream(&record, QIODevice::WriteOnly);
+        recordStream << (quint8)DeletedEntityRecord << (const QUuid&)entityID;
+        journalStream << record;
+    }
+
+    QScriptEngine scriptEngine;
+    foreach (const EntityItemProperties& properties, _entities) {
+        QByteArray record;
+        QDataStream recordStream(&record, QIODevice::WriteOnly);
+        recordStream << (quint8)ChangedEntityRecord
+            << EntityItemPropertiesToScriptValue(&scriptEngine, properties).toVariant().toMap();
+        journalStream << record;
+    }
+}
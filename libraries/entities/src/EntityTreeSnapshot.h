@@ -0,0 +1,46 @@
+//
+//  EntityTreeSnapshot.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeSnapshot_h
+#define hifi_EntityTreeSnapshot_h
+
+#include <QVector>
+
+#include <Octree.h>
+
+#include "EntityItemID.h"
+#include "EntityItemProperties.h"
+
+class EntityItem;
+
+/// The properties of a set of entities as they were when the snapshot was taken. Strings in the properties are
+/// implicitly shared, so they only cost memory once the entity changes them.
+/// It can also note entities that were deleted, for a snapshot of what changed in the tree.
+class EntityTreeSnapshot : public OctreeSnapshot {
+public:
+    enum JournalRecordType {
+        ChangedEntityRecord = 1,
+        DeletedEntityRecord
+    };
+
+    void addEntity(const EntityItem* entity);
+    void addDeletedEntity(const EntityItemID& entityID) { _deletedEntities << entityID; }
+
+    virtual int getItemCount() const { return _entities.size() + _deletedEntities.size(); }
+    virtual qint64 getMemoryUsage() const;
+    virtual bool writeToMap(QVariantMap& entityDescription, bool skipDefaultValues) const;
+    virtual void writeToJournal(QByteArray& journal) const;
+
+private:
+    QVector<EntityItemProperties> _entities;
+    QVector<EntityItemID> _deletedEntities;
+};
+
+#endif // hifi_EntityTreeSnapshot_h
@@ -193,7 +193,6 @@ bool MovingEntitiesOperator::preRecursion(OctreeElement* element) {
 
             // If this element is the best fit for the new bounds of this entity then add the entity to the element
             if (!details.newFound && entityTreeElement->bestFitBounds(details.newCube)) {
-                EntityItemID entityItemID = details.entity->getEntityItemID();
                 // remove from the old before adding
                 EntityTreeElement* oldElement = details.entity->getElement();
                 if (oldElement != entityTreeElement) {
@@ -201,7 +200,7 @@ bool MovingEntitiesOperator::preRecursion(OctreeElement* element) {
                         oldElement->removeEntityItem(details.entity);
                     }
                     entityTreeElement->addEntityItem(details.entity);
-                    _tree->setContainingElement(entityItemID, entityTreeElement);
+                    _tree->setContainingElement(details.entity, entityTreeElement);
                 }
                 _foundNewCount++;
                 //details.newFound = true; // TODO: would be nice to add this optimization
@@ -236,7 +236,7 @@ bool UpdateEntityOperator::preRecursion(OctreeElement* element) {
                 // NOTE: we know we haven't yet added it to its new element because _removeOld is true
                 EntityTreeElement* oldElement = _existingEntity->getElement();
                 oldElement->removeEntityItem(_existingEntity);
-                _tree->setContainingElement(_entityItemID, NULL);
+                _tree->setContainingElement(_existingEntity, NULL);
 
                 if (oldElement != _containingElement) {
                     qCDebug(entities) << "WARNING entity moved during UpdateEntityOperator recursion";
@@ -294,7 +294,7 @@ bool UpdateEntityOperator::preRecursion(OctreeElement* element) {
                     }
                 }
                 entityTreeElement->addEntityItem(_existingEntity);
-                _tree->setContainingElement(_entityItemID, entityTreeElement);
+                _tree->setContainingElement(_existingEntity, entityTreeElement);
 
                 _existingEntity->setProperties(_properties); // still need to update the properties!
                 if (_wantDebug) {
@@ -11,6 +11,7 @@
 
 #include "LimitedNodeList.h"
 
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
@@ -18,11 +19,17 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QThread>
 #include <QtCore/QUrl>
 #include <QtNetwork/QHostInfo>
 
 #include <tbb/parallel_for.h>
 
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
 #include <LogHandler.h>
 #include <NumericalConstants.h>
 #include <SharedUtil.h>
@@ -30,9 +37,13 @@
 #include "AccountManager.h"
 #include "Assignment.h"
 #include "HifiSockAddr.h"
+#include "OutboundPacket.h"
+#include "SharedPortReceiver.h"
 #include "UUID.h"
 #include "NetworkLogging.h"
 
+const int LARGER_BUFFER_SIZE = 1048576;
+
 const char SOLO_NODE_TYPES[2] = {
     NodeType::AvatarMixer,
     NodeType::AudioMixer
@@ -43,6 +54,8 @@ LimitedNodeList::LimitedNodeList(unsigned short socketListenPort, unsigned short
     _sessionUUID(),
     _nodeHash(),
     _nodeMutex(QReadWriteLock::Recursive),
+    _nodeSnapshotMutex(),
+    _nodeSnapshot(),
     _nodeSocket(this),
     _dtlsSocket(NULL),
     _localSockAddr(),
@@ -50,7 +63,8 @@ LimitedNodeList::LimitedNodeList(unsigned short socketListenPort, unsigned short
     _stunSockAddr(STUN_SERVER_HOSTNAME, STUN_SERVER_PORT),
     _packetStatTimer(),
     _thisNodeCanAdjustLocks(false),
-    _thisNodeCanRez(true)
+    _thisNodeCanRez(true),
+    _datagramBatchThread(NULL)
 {
     static bool firstCall = true;
     if (firstCall) {
@@ -72,7 +86,6 @@ LimitedNodeList::LimitedNodeList(unsigned short socketListenPort, unsigned short
         qCDebug(networking) << "NodeList DTLS socket is listening on" << _dtlsSocket->localPort();
     }
 
-    const int LARGER_BUFFER_SIZE = 1048576;
     changeSocketBufferSizes(LARGER_BUFFER_SIZE);
 
     // check for local socket updates every so often
@@ -183,12 +196,23 @@ bool LimitedNodeList::packetVersionAndHashMatch(const QByteArray& packet) {
         return false;
     }
 
-    if (!NON_VERIFIED_PACKETS.contains(checkType)) {
+    if (isVerifiedPacketType(checkType)) {
         // figure out which node this is from
         SharedNodePointer sendingNode = sendingNodeForPacket(packet);
         if (sendingNode) {
-            // check if the md5 hash in the header matches the hash we would expect
-            if (hashFromPacketHeader(packet) == hashForPacketAndConnectionUUID(packet, sendingNode->getConnectionSecret())) {
+            // check the hash we expect from this node first, then the other one in case it is an older node
+            // only sending MD5 hashes - once one of those verifies we send this node MD5 hashes too
+            const QUuid& connectionSecret = sendingNode->getConnectionSecret();
+            PacketHashType expectedHashType = sendingNode->getPacketHashType();
+            PacketHashType otherHashType = (expectedHashType == PacketHashSipHash) ? PacketHashMD5 : PacketHashSipHash;
+
+            if (packetHashMatches(packet, connectionSecret, expectedHashType, checkType)) {
+                return true;
+            } else if (packetHashMatches(packet, connectionSecret, otherHashType, checkType)) {
+                if (otherHashType == PacketHashMD5) {
+                    qCDebug(networking) << "Node" << sendingNode->getUUID() << "sends MD5 packet hashes, using those for it.";
+                    sendingNode->setPacketHashType(PacketHashMD5);
+                }
                 return true;
             } else {
                 static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
@@ -236,8 +260,17 @@ qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram, const HifiSock
     ++_numCollectedPackets;
     _numCollectedBytes += datagram.size();
 
-    qint64 bytesWritten = _nodeSocket.writeDatagram(datagram,
-                                                    destinationSockAddr.getAddress(), destinationSockAddr.getPort());
+    if (_datagramBatchThread.load() == QThread::currentThread()) {
+        BatchedDatagram batchedDatagram = { datagram, destinationSockAddr.getAddress(), destinationSockAddr.getPort() };
+        _datagramBatch.append(batchedDatagram);
+        return datagram.size();
+    }
+
+    return sendDatagram(datagram, destinationSockAddr.getAddress(), destinationSockAddr.getPort());
+}
+
+qint64 LimitedNodeList::sendDatagram(const QByteArray& datagram, const QHostAddress& address, quint16 port) {
+    qint64 bytesWritten = _nodeSocket.writeDatagram(datagram, address, port);
 
     if (bytesWritten < 0) {
         qCDebug(networking) << "ERROR in writeDatagram:" << _nodeSocket.error() << "-" << _nodeSocket.errorString();
@@ -246,13 +279,100 @@ qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram, const HifiSock
     return bytesWritten;
 }
 
+void LimitedNodeList::beginDatagramBatch() {
+    _datagramBatchThread.store(QThread::currentThread());
+}
+
+int LimitedNodeList::flushDatagramBatch() {
+    _datagramBatchThread.store(NULL);
+
+    int numDatagrams = _datagramBatch.size();
+    int numSent = 0;
+    int next = 0;
+
+#ifdef Q_OS_LINUX
+    // hand the kernel as many datagrams as we can per sendmmsg call
+    const int MAX_DATAGRAMS_PER_CALL = 64;
+    mmsghdr messages[MAX_DATAGRAMS_PER_CALL];
+    iovec vectors[MAX_DATAGRAMS_PER_CALL];
+    sockaddr_in addresses[MAX_DATAGRAMS_PER_CALL];
+
+    int socketDescriptor = _nodeSocket.socketDescriptor();
+
+    while (socketDescriptor != -1 && next < numDatagrams) {
+        int numMessages = std::min(numDatagrams - next, MAX_DATAGRAMS_PER_CALL);
+
+        memset(messages, 0, numMessages * sizeof(mmsghdr));
+        memset(addresses, 0, numMessages * sizeof(sockaddr_in));
+
+        for (int i = 0; i < numMessages; i++) {
+            const BatchedDatagram& batchedDatagram = _datagramBatch[next + i];
+
+            // the node socket is bound to an IPv4 address, so that's all we'll be sending to
+            addresses[i].sin_family = AF_INET;
+            addresses[i].sin_addr.s_addr = htonl(batchedDatagram.address.toIPv4Address());
+            addresses[i].sin_port = htons(batchedDatagram.port);
+
+            vectors[i].iov_base = const_cast<char*>(batchedDatagram.datagram.constData());
+            vectors[i].iov_len = batchedDatagram.datagram.size();
+
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int messagesSent = sendmmsg(socketDescriptor, messages, numMessages, 0);
+
+        if (messagesSent > 0) {
+            numSent += messagesSent;
+            next += messagesSent;
+        } else {
+            // the first datagram couldn't go out, let the socket have a go at it so the error gets reported
+            const BatchedDatagram& batchedDatagram = _datagramBatch[next++];
+            if (sendDatagram(batchedDatagram.datagram, batchedDatagram.address, batchedDatagram.port) >= 0) {
+                ++numSent;
+            }
+        }
+    }
+#endif
+
+    // anything sendmmsg didn't get to goes out one at a time
+    for (; next < numDatagrams; next++) {
+        const BatchedDatagram& batchedDatagram = _datagramBatch[next];
+        if (sendDatagram(batchedDatagram.datagram, batchedDatagram.address, batchedDatagram.port) >= 0) {
+            ++numSent;
+        }
+    }
+
+    // hand the buffers back to the pool, any that came from an OutboundPacket will be used again
+    for (int i = 0; i < numDatagrams; i++) {
+        PacketBufferPool::release(_datagramBatch[i].datagram);
+    }
+    _datagramBatch.clear();
+
+    return numSent;
+}
+
 qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram,
                                       const SharedNodePointer& destinationNode,
                                       const HifiSockAddr& overridenSockAddr) {
+    // the copy shares the caller's data until the hash is stamped into it
+    QByteArray datagramCopy = datagram;
+    return stampAndWriteDatagram(datagramCopy, destinationNode, overridenSockAddr);
+}
+
+qint64 LimitedNodeList::writePacket(OutboundPacket& packet, const SharedNodePointer& destinationNode,
+                                    const HifiSockAddr& overridenSockAddr) {
+    return stampAndWriteDatagram(packet.getDatagram(), destinationNode, overridenSockAddr);
+}
+
+qint64 LimitedNodeList::stampAndWriteDatagram(QByteArray& datagram, const SharedNodePointer& destinationNode,
+                                              const HifiSockAddr& overridenSockAddr) {
     if (destinationNode) {
         PacketType packetType = packetTypeForPacket(datagram);
 
-        if (NON_VERIFIED_PACKETS.contains(packetType)) {
+        if (!isVerifiedPacketType(packetType)) {
             return writeUnverifiedDatagram(datagram, destinationNode, overridenSockAddr);
         }
 
@@ -268,8 +388,6 @@ qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram,
             }
         }
 
-        QByteArray datagramCopy = datagram;
-
         // if we're here and the connection secret is null, debug out - this could be a problem
         if (destinationNode->getConnectionSecret().isNull()) {
             qDebug() << "LimitedNodeList::writeDatagram called for verified datagram with null connection secret for"
@@ -278,16 +396,17 @@ qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram,
         }
 
         // perform replacement of hash and optionally also sequence number in the header
-        if (SEQUENCE_NUMBERED_PACKETS.contains(packetType)) {
+        if (isSequenceNumberedPacketType(packetType)) {
             PacketSequenceNumber sequenceNumber = getNextSequenceNumberForPacket(destinationNode->getUUID(), packetType);
-            replaceHashAndSequenceNumberInPacket(datagramCopy, destinationNode->getConnectionSecret(),
-                                                 sequenceNumber, packetType);
+            replaceHashAndSequenceNumberInPacket(datagram, destinationNode->getConnectionSecret(),
+                                                 destinationNode->getPacketHashType(), sequenceNumber, packetType);
         } else {
-            replaceHashInPacket(datagramCopy, destinationNode->getConnectionSecret(), packetType);
+            replaceHashInPacket(datagram, destinationNode->getConnectionSecret(), destinationNode->getPacketHashType(),
+                                packetType);
         }
 
         emit dataSent(destinationNode->getType(), datagram.size());
-        auto bytesWritten = writeDatagram(datagramCopy, *destinationSockAddr);
+        auto bytesWritten = writeDatagram(datagram, *destinationSockAddr);
         // Keep track of per-destination-node bandwidth
         destinationNode->recordBytesSent(bytesWritten);
         return bytesWritten;
@@ -315,7 +434,7 @@ qint64 LimitedNodeList::writeUnverifiedDatagram(const QByteArray& datagram, cons
         PacketType packetType = packetTypeForPacket(datagram);
 
         // optionally peform sequence number replacement in the header
-        if (SEQUENCE_NUMBERED_PACKETS.contains(packetType)) {
+        if (isSequenceNumberedPacketType(packetType)) {
 
             QByteArray datagramCopy = datagram;
 
@@ -339,7 +458,14 @@ qint64 LimitedNodeList::writeUnverifiedDatagram(const QByteArray& datagram, cons
 
 qint64 LimitedNodeList::writeDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode,
                                const HifiSockAddr& overridenSockAddr) {
-    return writeDatagram(QByteArray(data, size), destinationNode, overridenSockAddr);
+    if (!isVerifiedPacketType(packetTypeForPacket(data))) {
+        // nothing may get stamped into these, so take our own copy before they can be held in a batch
+        return writeUnverifiedDatagram(QByteArray(data, size), destinationNode, overridenSockAddr);
+    }
+
+    // stamping the hash in makes the one copy of the caller's buffer we need
+    QByteArray datagram = QByteArray::fromRawData(data, size);
+    return stampAndWriteDatagram(datagram, destinationNode, overridenSockAddr);
 }
 
 qint64 LimitedNodeList::writeUnverifiedDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode,
@@ -373,7 +499,7 @@ int LimitedNodeList::updateNodeWithDataFromPacket(const SharedNodePointer& match
     // if this was a sequence numbered packet we should store the last seq number for
     // a packet of this type for this node
     PacketType packetType = packetTypeForPacket(packet);
-    if (SEQUENCE_NUMBERED_PACKETS.contains(packetType)) {
+    if (isSequenceNumberedPacketType(packetType)) {
         matchingNode->setLastSequenceNumberForPacketType(sequenceNumberFromHeader(packet, packetType), packetType);
     }
 
@@ -425,6 +551,7 @@ void LimitedNodeList::eraseAllNodes() {
     // iterate the current nodes, emit that they are dying and remove them from the hash
     _nodeMutex.lockForWrite();
     _nodeHash.clear();
+    publishNodeSnapshot();
     _nodeMutex.unlock();
 
     foreach(const SharedNodePointer& killedNode, killedNodes) {
@@ -447,6 +574,7 @@ void LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
 
         _nodeMutex.lockForWrite();
         _nodeHash.unsafe_erase(it);
+        publishNodeSnapshot();
         _nodeMutex.unlock();
 
         handleNodeKill(matchingNode);
@@ -468,6 +596,27 @@ void LimitedNodeList::handleNodeKill(const SharedNodePointer& node) {
     emit nodeKilled(node);
 }
 
+NodeSnapshot LimitedNodeList::getNodeSnapshot() const {
+    QMutexLocker locker(&_nodeSnapshotMutex);
+    return _nodeSnapshot;
+}
+
+void LimitedNodeList::publishNodeSnapshot() {
+    NodeSnapshot snapshot;
+    snapshot.reserve(_nodeHash.size());
+
+    for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
+        snapshot.append(it->second);
+    }
+
+    {
+        QMutexLocker locker(&_nodeSnapshotMutex);
+        _nodeSnapshot.swap(snapshot);
+    }
+
+    // the previous snapshot goes away here, outside the lock, unless a reader is still holding on to it
+}
+
 SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                                    const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                                    bool canAdjustLocks, bool canRez) {
@@ -487,7 +636,11 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         Node* newNode = new Node(uuid, nodeType, publicSocket, localSocket, canAdjustLocks, canRez);
         SharedNodePointer newNodePointer(newNode);
 
-        _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
+        {
+            QWriteLocker writeLock(&_nodeMutex);
+            _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
+            publishNodeSnapshot();
+        }
 
         qCDebug(networking) << "Added" << *newNode;
 
@@ -586,6 +739,11 @@ void LimitedNodeList::removeSilentNodes() {
         node->getMutex().unlock();
     });
 
+    if (!killedNodes.isEmpty()) {
+        QWriteLocker writeLock(&_nodeMutex);
+        publishNodeSnapshot();
+    }
+
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
     }
@@ -631,6 +789,69 @@ void LimitedNodeList::rebindNodeSocket() {
     _nodeSocket.bind(QHostAddress::AnyIPv4, oldPort);
 }
 
+int LimitedNodeList::openSharedPortReceivers(int numReceiveSockets) {
+    closeSharedPortReceivers();
+
+    if (numReceiveSockets < 2) {
+        return 0;
+    }
+
+    // every socket on the port has to ask for SO_REUSEPORT before it binds, the node socket included
+    quint16 port = _nodeSocket.localPort();
+    _nodeSocket.close();
+
+    int nodeSocketDescriptor = SharedPortReceiver::openSharedPortSocket(port, LARGER_BUFFER_SIZE);
+    if (nodeSocketDescriptor == -1) {
+        qCDebug(networking) << "Port" << port << "can't be shared, all datagrams will be read from the node socket.";
+        _nodeSocket.bind(QHostAddress::AnyIPv4, port);
+        changeSocketBufferSizes(LARGER_BUFFER_SIZE);
+        return 0;
+    }
+    _nodeSocket.setSocketDescriptor(nodeSocketDescriptor, QAbstractSocket::BoundState);
+
+    for (int i = 1; i < numReceiveSockets; i++) {
+        int socketDescriptor = SharedPortReceiver::openSharedPortSocket(port, LARGER_BUFFER_SIZE);
+        if (socketDescriptor == -1) {
+            break;
+        }
+
+        QThread* receiveThread = new QThread();
+        receiveThread->setObjectName(QString("Receive Socket %1").arg(i));
+
+        SharedPortReceiver* receiver = new SharedPortReceiver(socketDescriptor);
+        receiver->moveToThread(receiveThread);
+
+        connect(receiver, &SharedPortReceiver::packetRequiresProcessing,
+                this, &LimitedNodeList::sharedPortPacketReceived, Qt::DirectConnection);
+        connect(receiveThread, &QThread::started, receiver, &SharedPortReceiver::readDatagrams);
+
+        _sharedPortReceivers.append(receiver);
+        _sharedPortReceiveThreads.append(receiveThread);
+
+        receiveThread->start();
+    }
+
+    qCDebug(networking) << "Reading port" << port << "from" << _sharedPortReceivers.size() + 1 << "sockets";
+
+    return _sharedPortReceivers.size();
+}
+
+void LimitedNodeList::closeSharedPortReceivers() {
+    for (int i = 0; i < _sharedPortReceivers.size(); i++) {
+        _sharedPortReceivers[i]->stop();
+        _sharedPortReceiveThreads[i]->quit();
+    }
+
+    for (int i = 0; i < _sharedPortReceivers.size(); i++) {
+        _sharedPortReceiveThreads[i]->wait();
+        delete _sharedPortReceivers[i];
+        delete _sharedPortReceiveThreads[i];
+    }
+
+    _sharedPortReceivers.clear();
+    _sharedPortReceiveThreads.clear();
+}
+
 bool LimitedNodeList::processSTUNResponse(const QByteArray& packet) {
     // check the cookie to make sure this is actually a STUN response
     // and read the first attribute and make sure it is a XOR_MAPPED_ADDRESS
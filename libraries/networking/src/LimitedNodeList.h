@@ -21,10 +21,13 @@
 #include <unistd.h> // not on windows, not needed for mac or windows
 #endif
 
+#include <qatomic.h>
 #include <qelapsedtimer.h>
+#include <qmutex.h>
 #include <qreadwritelock.h>
 #include <qset.h>
 #include <qsharedpointer.h>
+#include <qvector.h>
 #include <QtNetwork/qudpsocket.h>
 #include <QtNetwork/qhostaddress.h>
 #include <QSharedMemory>
@@ -58,12 +61,18 @@ const QHostAddress DEFAULT_ASSIGNMENT_CLIENT_MONITOR_HOSTNAME = QHostAddress::Lo
 const QString USERNAME_UUID_REPLACEMENT_STATS_KEY = "$username";
 
 class HifiSockAddr;
+class OutboundPacket;
+class QThread;
+class SharedPortReceiver;
 
 typedef QSet<NodeType_t> NodeSet;
 
 typedef QSharedPointer<Node> SharedNodePointer;
 Q_DECLARE_METATYPE(SharedNodePointer)
 
+/// the nodes as they were after the last node was added or removed, copying one only bumps a reference count
+typedef QVector<SharedNodePointer> NodeSnapshot;
+
 using namespace tbb;
 typedef std::pair<QUuid, SharedNodePointer> UUIDNodePair;
 typedef concurrent_unordered_map<QUuid, SharedNodePointer, UUIDHasher> NodeHash;
@@ -92,6 +101,16 @@ public:
 
     void rebindNodeSocket();
     QUdpSocket& getNodeSocket() { return _nodeSocket; }
+
+    /// Rebinds the node socket so that its port can be shared (SO_REUSEPORT) and opens numReceiveSockets - 1 more
+    /// sockets on it, each read in batches by a thread of its own. The kernel picks the socket for a datagram by
+    /// hashing its sender's address, so each node's datagrams keep arriving in order on one thread. Datagrams read
+    /// by the extra sockets come out of sharedPortPacketReceived, connect to it first. Call this on the thread that
+    /// owns the node socket. Returns the number of extra sockets opened, which is 0 on platforms without SO_REUSEPORT.
+    int openSharedPortReceivers(int numReceiveSockets);
+
+    /// stops the receive threads and closes the extra sockets, the node socket keeps sharing its port until rebound
+    void closeSharedPortReceivers();
     QUdpSocket& getDTLSSocket();
 
     bool packetVersionAndHashMatch(const QByteArray& packet);
@@ -116,9 +135,20 @@ public:
     qint64 writeDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode,
                          const HifiSockAddr& overridenSockAddr = HifiSockAddr());
 
+    /// stamps the hash and sequence number into the room the packet left for them and sends it, without copying it
+    qint64 writePacket(OutboundPacket& packet, const SharedNodePointer& destinationNode,
+                       const HifiSockAddr& overridenSockAddr = HifiSockAddr());
+
     qint64 writeUnverifiedDatagram(const char* data, qint64 size, const SharedNodePointer& destinationNode,
                          const HifiSockAddr& overridenSockAddr = HifiSockAddr());
 
+    /// holds back the datagrams written from the calling thread until flushDatagramBatch is called, so that they
+    /// can go out in as few system calls as possible - datagrams written from any other thread are sent right away
+    void beginDatagramBatch();
+
+    /// sends the datagrams held back since beginDatagramBatch, returns the number of them that were sent
+    int flushDatagramBatch();
+
     void (*linkedDataCreateCallback)(Node *);
 
     int size() const { return _nodeHash.size(); }
@@ -155,32 +185,37 @@ public:
     void sendHeartbeatToIceServer(const HifiSockAddr& iceServerSockAddr,
                                   QUuid headerID = QUuid(), const QUuid& connectRequestID = QUuid());
 
+    /// Returns the current node snapshot. Iterating it takes no lock, so nodes can be added and removed meanwhile - a
+    /// node removed after the snapshot was taken is still in it, but stays alive for as long as the snapshot does.
+    NodeSnapshot getNodeSnapshot() const;
+
+    // the each* helpers below iterate the current node snapshot, so the functor can add or kill nodes
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        NodeSnapshot snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
+        for (NodeSnapshot::const_iterator it = snapshot.cbegin(); it != snapshot.cend(); ++it) {
+            functor(*it);
         }
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        NodeSnapshot snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        for (NodeSnapshot::const_iterator it = snapshot.cbegin(); it != snapshot.cend(); ++it) {
+            if (predicate(*it)) {
+                functor(*it);
             }
         }
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        NodeSnapshot snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
+        for (NodeSnapshot::const_iterator it = snapshot.cbegin(); it != snapshot.cend(); ++it) {
+            if (!functor(*it)) {
                 break;
             }
         }
@@ -188,11 +223,11 @@ public:
 
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
+        NodeSnapshot snapshot = getNodeSnapshot();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        for (NodeSnapshot::const_iterator it = snapshot.cbegin(); it != snapshot.cend(); ++it) {
+            if (predicate(*it)) {
+                return *it;
             }
         }
 
@@ -227,12 +262,18 @@ signals:
 
     void packetVersionMismatch();
 
+    /// emitted on the receiving socket's thread
+    void sharedPortPacketReceived(const QByteArray& receivedPacket, const HifiSockAddr& senderSockAddr);
+
 protected:
     LimitedNodeList(unsigned short socketListenPort = 0, unsigned short dtlsListenPort = 0);
     LimitedNodeList(LimitedNodeList const&); // Don't implement, needed to avoid copies of singleton
     void operator=(LimitedNodeList const&); // Don't implement, needed to avoid copies of singleton
 
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& destinationSockAddr);
+    qint64 sendDatagram(const QByteArray& datagram, const QHostAddress& address, quint16 port);
+    qint64 stampAndWriteDatagram(QByteArray& datagram, const SharedNodePointer& destinationNode,
+                                 const HifiSockAddr& overridenSockAddr);
 
     PacketSequenceNumber getNextSequenceNumberForPacket(const QUuid& nodeUUID, PacketType packetType);
 
@@ -240,9 +281,16 @@ protected:
 
     void handleNodeKill(const SharedNodePointer& node);
 
+    /// rebuilds the node snapshot from _nodeHash, call it with _nodeMutex locked for write after adding or removing nodes
+    void publishNodeSnapshot();
+
     QUuid _sessionUUID;
     NodeHash _nodeHash;
     QReadWriteLock _nodeMutex;
+
+    // only ever held to copy or swap _nodeSnapshot, never while iterating it
+    mutable QMutex _nodeSnapshotMutex;
+    NodeSnapshot _nodeSnapshot;
     QUdpSocket _nodeSocket;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
@@ -259,6 +307,19 @@ protected:
 
     std::unordered_map<QUuid, PacketTypeSequenceMap, UUIDHasher> _packetSequenceNumbers;
 
+    struct BatchedDatagram {
+        QByteArray datagram;
+        QHostAddress address;
+        quint16 port;
+    };
+
+    // the thread whose datagrams are currently being held back, only that thread touches _datagramBatch
+    QAtomicPointer<QThread> _datagramBatchThread;
+    QVector<BatchedDatagram> _datagramBatch;
+
+    QVector<SharedPortReceiver*> _sharedPortReceivers;
+    QVector<QThread*> _sharedPortReceiveThreads;
+
     template<typename IteratorLambda>
     void eachNodeHashIterator(IteratorLambda functor) {
         QWriteLocker writeLock(&_nodeMutex);
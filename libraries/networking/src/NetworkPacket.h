@@ -33,6 +33,9 @@ public:
     const SharedNodePointer& getNode() const { return _node; }
     const QByteArray& getByteArray() const { return _byteArray; }
 
+    /// exchanges contents with other without touching the reference counts of either
+    void swap(NetworkPacket& other) { _node.swap(other._node); _byteArray.swap(other._byteArray); }
+
 private:
     void copyContents(const SharedNodePointer& node, const QByteArray& byteArray);
 
@@ -0,0 +1,148 @@
+//
+//  NetworkPacketQueue.cpp
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include "NetworkPacketQueue.h"
+
+const int NetworkPacketQueue::DEFAULT_CAPACITY = 4096;
+
+NetworkPacketQueue::NetworkPacketQueue(int capacity, OverflowPolicy overflowPolicy) :
+    _ring(std::max(capacity, 1)),
+    _head(0),
+    _size(0),
+    _overflowPolicy(overflowPolicy),
+    _isStopped(false),
+    _droppedPacketCount(0)
+{
+}
+
+bool NetworkPacketQueue::enqueue(const SharedNodePointer& node, const QByteArray& packet, bool canWait) {
+    NetworkPacket networkPacket(node, packet);
+
+    // declared before the locker so that a dropped packet is released after we unlock
+    NetworkPacket droppedPacket;
+    QMutexLocker locker(&_mutex);
+
+    int capacity = _ring.size();
+    while (_size.load() == capacity) {
+        if (_overflowPolicy == DropOldest) {
+            droppedPacket.swap(_ring[_head]);
+            decrementNodeCount(droppedPacket);
+            _head = (_head + 1) % capacity;
+            _size.store(capacity - 1);
+            _droppedPacketCount++;
+        } else if (_overflowPolicy == Grow) {
+            grow();
+            capacity = _ring.size();
+        } else if (canWait && !_isStopped) {
+            _hasRoom.wait(&_mutex);
+        } else {
+            _droppedPacketCount++;
+            return false;
+        }
+    }
+
+    NetworkPacket& slot = _ring[(_head + _size.load()) % capacity];
+    slot.swap(networkPacket);
+    _size.store(_size.load() + 1);
+
+    if (!slot.getNode().isNull()) {
+        _nodePacketCounts[slot.getNode()->getUUID()]++;
+    }
+
+    _hasPackets.wakeOne();
+    return true;
+}
+
+int NetworkPacketQueue::dequeueBatch(std::vector<NetworkPacket>& batch, int maxPackets) {
+    // release the last batch and size this one before taking the lock, only we can make the queue shorter
+    batch.clear();
+    batch.resize(std::min(size(), maxPackets));
+
+    QMutexLocker locker(&_mutex);
+
+    int capacity = _ring.size();
+    int numPackets = std::min(_size.load(), (int)batch.size());
+    for (int i = 0; i < numPackets; i++) {
+        batch[i].swap(_ring[_head]);
+        decrementNodeCount(batch[i]);
+        _head = (_head + 1) % capacity;
+    }
+    _size.store(_size.load() - numPackets);
+
+    if (numPackets > 0) {
+        _hasRoom.wakeAll();
+    }
+    return numPackets;
+}
+
+int NetworkPacketQueue::getCapacity() const {
+    QMutexLocker locker(&_mutex);
+    return _ring.size();
+}
+
+bool NetworkPacketQueue::waitForPackets(unsigned long maxWait) {
+    QMutexLocker locker(&_mutex);
+    if (_size.load() == 0 && !_isStopped) {
+        _hasPackets.wait(&_mutex, maxWait);
+    }
+    return _size.load() > 0;
+}
+
+void NetworkPacketQueue::stop() {
+    QMutexLocker locker(&_mutex);
+    _isStopped = true;
+    _hasPackets.wakeAll();
+    _hasRoom.wakeAll();
+}
+
+bool NetworkPacketQueue::hasNode(const QUuid& nodeUUID) const {
+    QMutexLocker locker(&_mutex);
+    return _nodePacketCounts.contains(nodeUUID);
+}
+
+int NetworkPacketQueue::packetCountFrom(const QUuid& nodeUUID) const {
+    QMutexLocker locker(&_mutex);
+    return _nodePacketCounts.value(nodeUUID, 0);
+}
+
+void NetworkPacketQueue::removeNode(const QUuid& nodeUUID) {
+    QMutexLocker locker(&_mutex);
+    _nodePacketCounts.remove(nodeUUID);
+}
+
+quint64 NetworkPacketQueue::getDroppedPacketCount() const {
+    QMutexLocker locker(&_mutex);
+    return _droppedPacketCount;
+}
+
+void NetworkPacketQueue::grow() {
+    // unwrap the queued packets to the front of a ring twice the size
+    int capacity = _ring.size();
+    QVector<NetworkPacket> largerRing(capacity * 2);
+    for (int i = 0; i < capacity; i++) {
+        largerRing[i].swap(_ring[(_head + i) % capacity]);
+    }
+    _ring.swap(largerRing);
+    _head = 0;
+}
+
+void NetworkPacketQueue::decrementNodeCount(const NetworkPacket& packet) {
+    if (packet.getNode().isNull()) {
+        return;
+    }
+
+    // a node that was removed stays removed even if some of its packets were still queued
+    QHash<QUuid, int>::iterator count = _nodePacketCounts.find(packet.getNode()->getUUID());
+    if (count != _nodePacketCounts.end() && count.value() > 0) {
+        count.value()--;
+    }
+}
@@ -0,0 +1,93 @@
+//
+//  NetworkPacketQueue.h
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NetworkPacketQueue_h
+#define hifi_NetworkPacketQueue_h
+
+#include <climits>
+#include <vector>
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+#include "NetworkPacket.h"
+
+/// Queue of packets between any number of producer threads and a single consumer thread. Packets live in a ring that
+/// is allocated up front (and only reallocated if it has to Grow), producers only hold the lock long enough to swap a
+/// packet into its slot and the consumer takes a whole batch of packets each time it locks. The number of packets queued from each node is kept
+/// as packets come and go, so asking about a node doesn't walk the queue.
+class NetworkPacketQueue {
+public:
+    enum OverflowPolicy {
+        DropOldest, // a full queue makes room by dropping its oldest packet
+        Backpressure, // a full queue makes the producer wait until the consumer takes a batch
+        Grow // a full queue doubles its ring, so it never drops a packet or holds up a producer
+    };
+
+    static const int DEFAULT_CAPACITY;
+
+    NetworkPacketQueue(int capacity = DEFAULT_CAPACITY, OverflowPolicy overflowPolicy = DropOldest);
+
+    int getCapacity() const;
+    OverflowPolicy getOverflowPolicy() const { return _overflowPolicy; }
+
+    /// Adds a packet to the back of the queue. Returns false if the packet was not queued, which only happens with
+    /// Backpressure when the queue is full and the caller can't wait (or the queue was stopped).
+    bool enqueue(const SharedNodePointer& node, const QByteArray& packet, bool canWait = true);
+
+    /// Moves up to maxPackets of the oldest packets into batch (which is cleared first), returns the number taken.
+    /// Packets taken no longer count towards their node.
+    int dequeueBatch(std::vector<NetworkPacket>& batch, int maxPackets = INT_MAX);
+
+    /// Waits until there are packets or maxWait msecs have passed, returns true if there are packets.
+    bool waitForPackets(unsigned long maxWait = ULONG_MAX);
+
+    /// Wakes every waiting thread and stops any later waits from blocking, call this when shutting down.
+    void stop();
+
+    bool isEmpty() const { return _size.load() == 0; }
+    int size() const { return _size.load(); }
+
+    /// Has a packet from this node been queued since it was last removed?
+    bool hasNode(const QUuid& nodeUUID) const;
+
+    /// How many packets from this node are waiting in the queue
+    int packetCountFrom(const QUuid& nodeUUID) const;
+
+    /// Forgets the node's packet count, its packets still in the queue are left there.
+    void removeNode(const QUuid& nodeUUID);
+
+    /// The number of packets dropped or refused because the queue was full
+    quint64 getDroppedPacketCount() const;
+
+private:
+    void grow();
+    void decrementNodeCount(const NetworkPacket& packet);
+
+    mutable QMutex _mutex;
+    QWaitCondition _hasPackets;
+    QWaitCondition _hasRoom;
+
+    QVector<NetworkPacket> _ring;
+    int _head;
+    QAtomicInt _size;
+
+    QHash<QUuid, int> _nodePacketCounts;
+
+    OverflowPolicy _overflowPolicy;
+    bool _isStopped;
+    quint64 _droppedPacketCount;
+};
+
+#endif // hifi_NetworkPacketQueue_h
@@ -48,6 +48,7 @@ Node::Node(const QUuid& uuid, NodeType_t type, const HifiSockAddr& publicSocket,
     _activeSocket(NULL),
     _symmetricSocket(),
     _connectionSecret(),
+    _packetHashType(PacketHashSipHash),
     _linkedData(NULL),
     _isAlive(true),
     _pingMs(-1),  // "Uninitialized"
@@ -15,6 +15,7 @@
 #include <ostream>
 #include <stdint.h>
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QDebug>
 #include <QtCore/QMutex>
 #include <QtCore/QUuid>
@@ -58,6 +59,11 @@ public:
     const QUuid& getConnectionSecret() const { return _connectionSecret; }
     void setConnectionSecret(const QUuid& connectionSecret) { _connectionSecret = connectionSecret; }
 
+    /// we hash packets to a node with SipHash until an MD5 hashed packet from it tells us it is an older node
+    /// the datagram thread can change this while other threads are sending to the node
+    PacketHashType getPacketHashType() const { return (PacketHashType)_packetHashType.load(); }
+    void setPacketHashType(PacketHashType packetHashType) { _packetHashType.store(packetHashType); }
+
     NodeData* getLinkedData() const { return _linkedData; }
     void setLinkedData(NodeData* linkedData) { _linkedData = linkedData; }
 
@@ -106,6 +112,7 @@ private:
     HifiSockAddr _symmetricSocket;
     
     QUuid _connectionSecret;
+    QAtomicInt _packetHashType;
     NodeData* _linkedData;
     bool _isAlive;
     int _pingMs;
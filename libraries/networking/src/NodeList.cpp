@@ -36,7 +36,12 @@ NodeList::NodeList(char newOwnerType, unsigned short socketListenPort, unsigned
     _numNoReplyDomainCheckIns(0),
     _assignmentServerSocket(),
     _hasCompletedInitialSTUNFailure(false),
-    _stunRequestsSinceSuccess(0)
+    _stunRequestsSinceSuccess(0),
+    _domainListVersion(0),
+    _pendingDomainListFromVersion(0),
+    _pendingDomainListToVersion(0),
+    _pendingDomainListPackets(),
+    _isProcessingDomainList(false)
 {
     static bool firstCall = true;
     if (firstCall) {
@@ -72,6 +77,9 @@ NodeList::NodeList(char newOwnerType, unsigned short socketListenPort, unsigned
 
     // clear our NodeList when logout is requested
     connect(&AccountManager::getInstance(), &AccountManager::logoutComplete , this, &NodeList::reset);
+
+    // a node we kill that the domain-server didn't tell us about has to come back in a full domain list
+    connect(this, &LimitedNodeList::nodeKilled, this, &NodeList::handleKilledNode, Qt::DirectConnection);
 }
 
 qint64 NodeList::sendStats(const QJsonObject& statsObject, const HifiSockAddr& destination) {
@@ -247,6 +255,8 @@ void NodeList::reset() {
     LimitedNodeList::reset();
 
     _numNoReplyDomainCheckIns = 0;
+    _domainListVersion = 0;
+    _pendingDomainListPackets.clear();
 
     // refresh the owner UUID to the NULL UUID
     setSessionUUID(QUuid());
@@ -264,10 +274,20 @@ void NodeList::reset() {
 
 void NodeList::addNodeTypeToInterestSet(NodeType_t nodeTypeToAdd) {
     _nodeTypesOfInterest << nodeTypeToAdd;
+
+    // the domain list we have doesn't have any nodes of the new type
+    _domainListVersion = 0;
 }
 
 void NodeList::addSetOfNodeTypesToNodeInterestSet(const NodeSet& setOfNodeTypes) {
     _nodeTypesOfInterest.unite(setOfNodeTypes);
+    _domainListVersion = 0;
+}
+
+void NodeList::handleKilledNode() {
+    if (!_isProcessingDomainList) {
+        _domainListVersion = 0;
+    }
 }
 
 
@@ -365,6 +385,11 @@ void NodeList::sendDomainServerCheckIn() {
         // pack our data to send to the domain-server
         packetStream << _ownerType << _publicSockAddr << _localSockAddr << _nodeTypesOfInterest.toList();
 
+        if (domainPacketType == PacketTypeDomainListRequest) {
+            // the domain-server only sends us what changed since the version of the list we have
+            packetStream << _domainListVersion;
+        }
+
 
         // if this is a connect request, and we can present a username signature, send it along
         if (!_domainHandler.isConnected()) {
@@ -550,6 +575,23 @@ int NodeList::processDomainServerList(const QByteArray& packet) {
     packetStream >> thisNodeCanRez;
     setThisNodeCanRez(thisNodeCanRez);
 
+    // the versions of the list this packet takes us from (0 for the whole list) and to, and which of the packets
+    // for that change it is
+    quint32 fromVersion, toVersion;
+    quint16 packetNumber, numPackets;
+    packetStream >> fromVersion >> toVersion >> packetNumber >> numPackets;
+
+    _isProcessingDomainList = true;
+
+    // kill the nodes that left the domain since the version we have
+    quint16 numRemovedNodes;
+    packetStream >> numRemovedNodes;
+    for (quint16 i = 0; i < numRemovedNodes; i++) {
+        QUuid removedNodeUUID;
+        packetStream >> removedNodeUUID;
+        killNodeWithUUID(removedNodeUUID);
+    }
+
     // pull each node in the packet
     while(packetStream.device()->pos() < packet.size()) {
         // setup variables to read into from QDataStream
@@ -574,6 +616,25 @@ int NodeList::processDomainServerList(const QByteArray& packet) {
         node->setConnectionSecret(connectionUUID);
     }
 
+    _isProcessingDomainList = false;
+
+    // applying a packet twice does no harm, but we only hold the new version once we've had every packet for it.
+    // Until then we keep asking for what changed since the version we had.
+    if (fromVersion == 0 || fromVersion == _domainListVersion) {
+        if (fromVersion != _pendingDomainListFromVersion || toVersion != _pendingDomainListToVersion) {
+            _pendingDomainListFromVersion = fromVersion;
+            _pendingDomainListToVersion = toVersion;
+            _pendingDomainListPackets.clear();
+        }
+
+        _pendingDomainListPackets.insert(packetNumber);
+
+        if (_pendingDomainListPackets.size() >= numPackets) {
+            _domainListVersion = toVersion;
+            _pendingDomainListPackets.clear();
+        }
+    }
+
     // ping inactive nodes in conjunction with receipt of list from domain-server
     // this makes it happen every second and also pings any newly added nodes
     pingInactiveNodes();
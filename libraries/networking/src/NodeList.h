@@ -57,7 +57,7 @@ public:
     const NodeSet& getNodeInterestSet() const { return _nodeTypesOfInterest; }
     void addNodeTypeToInterestSet(NodeType_t nodeTypeToAdd);
     void addSetOfNodeTypesToNodeInterestSet(const NodeSet& setOfNodeTypes);
-    void resetNodeInterestSet() { _nodeTypesOfInterest.clear(); }
+    void resetNodeInterestSet() { _nodeTypesOfInterest.clear(); _domainListVersion = 0; }
 
     void processNodeData(const HifiSockAddr& senderSockAddr, const QByteArray& packet);
 
@@ -76,6 +76,7 @@ signals:
     void limitOfSilentDomainCheckInsReached();
 private slots:
     void sendPendingDSPathQuery();
+    void handleKilledNode();
 private:
     NodeList() : LimitedNodeList(0, 0) { assert(false); } // Not implemented, needed for DependencyManager templates compile
     NodeList(char ownerType, unsigned short socketListenPort = 0, unsigned short dtlsListenPort = 0);
@@ -104,6 +105,13 @@ private:
     bool _hasCompletedInitialSTUNFailure;
     unsigned int _stunRequestsSinceSuccess;
 
+    // the version of the domain list we hold all of, and the packets we have of the one we're receiving
+    quint32 _domainListVersion;
+    quint32 _pendingDomainListFromVersion;
+    quint32 _pendingDomainListToVersion;
+    QSet<quint16> _pendingDomainListPackets;
+    bool _isProcessingDomainList;
+
     friend class Application;
 };
 
@@ -0,0 +1,63 @@
+//
+//  OutboundPacket.cpp
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QMutexLocker>
+
+#include "OutboundPacket.h"
+
+// enough for a busy frame of every mixer, anything past this is freed as it comes back
+const int MAX_POOLED_PACKET_BUFFERS = 1024;
+
+QMutex PacketBufferPool::_mutex;
+QVector<QByteArray> PacketBufferPool::_buffers;
+
+QByteArray PacketBufferPool::acquire() {
+    {
+        QMutexLocker locker(&_mutex);
+        if (!_buffers.isEmpty()) {
+            QByteArray buffer = _buffers.last();
+            _buffers.removeLast();
+            return buffer;
+        }
+    }
+
+    QByteArray buffer;
+    buffer.reserve(MAX_PACKET_SIZE);
+    return buffer;
+}
+
+void PacketBufferPool::release(QByteArray& buffer) {
+    // a buffer that is still shared (say by a datagram batch waiting to go out) will come back later, or not at all
+    if (!buffer.isDetached() || buffer.capacity() < MAX_PACKET_SIZE) {
+        buffer = QByteArray();
+        return;
+    }
+
+    // with its capacity reserved, emptying the buffer keeps its memory
+    buffer.resize(0);
+
+    QMutexLocker locker(&_mutex);
+    if (_buffers.size() < MAX_POOLED_PACKET_BUFFERS) {
+        _buffers.append(buffer);
+    }
+    buffer = QByteArray();
+}
+
+OutboundPacket::OutboundPacket(PacketType type, const QUuid& connectionUUID) :
+    _type(type),
+    _datagram(PacketBufferPool::acquire())
+{
+    _datagram.resize(numBytesForPacketHeaderGivenPacketType(type));
+    populatePacketHeaderWithUUID(_datagram.data(), type, connectionUUID);
+}
+
+OutboundPacket::~OutboundPacket() {
+    PacketBufferPool::release(_datagram);
+}
@@ -0,0 +1,69 @@
+//
+//  OutboundPacket.h
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OutboundPacket_h
+#define hifi_OutboundPacket_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMutex>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+#include "LimitedNodeList.h"
+#include "PacketHeaders.h"
+
+/// MTU sized buffers for outbound datagrams, shared by every thread that sends. Each buffer has room reserved for
+/// MAX_PACKET_SIZE bytes, so filling it never reallocates.
+class PacketBufferPool {
+public:
+    /// \return an empty buffer with room for MAX_PACKET_SIZE bytes
+    static QByteArray acquire();
+
+    /// takes the buffer back for reuse, unless something else still shares it (then it is just let go)
+    static void release(QByteArray& buffer);
+
+private:
+    static QMutex _mutex;
+    static QVector<QByteArray> _buffers;
+};
+
+/// A datagram that is built where it will be sent from. The header goes in first with room left for the hash and
+/// sequence number, the sender writes its payload straight after it, and LimitedNodeList::writePacket stamps the hash
+/// and sequence number into the room left for them - the datagram is never copied on its way to the socket.
+class OutboundPacket {
+public:
+    OutboundPacket(PacketType type, const QUuid& connectionUUID);
+    ~OutboundPacket();
+
+    PacketType getType() const { return _type; }
+
+    /// the whole datagram, header included
+    QByteArray& getDatagram() { return _datagram; }
+    int getSize() const { return _datagram.size(); }
+
+    /// \return where the next byte of payload goes, there is room for getBytesAvailable() bytes there
+    char* getPayloadAt() { return _datagram.data() + _datagram.size(); }
+    int getBytesAvailable() const { return MAX_PACKET_SIZE - _datagram.size(); }
+
+    /// adds numBytes written at getPayloadAt() to the payload
+    void advancePayload(int numBytes) { _datagram.resize(_datagram.size() + numBytes); }
+
+    void append(const char* data, int numBytes) { _datagram.append(data, numBytes); }
+
+private:
+    // there is no reason to copy a packet that exists to avoid copies
+    OutboundPacket(const OutboundPacket&);
+    OutboundPacket& operator= (const OutboundPacket&);
+
+    PacketType _type;
+    QByteArray _datagram;
+};
+
+#endif // hifi_OutboundPacket_h
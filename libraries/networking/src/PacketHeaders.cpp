@@ -12,8 +12,12 @@
 #include "PacketHeaders.h"
 
 #include <math.h>
+#include <string.h>
 
 #include <QtCore/QDebug>
+#include <QtCore/QtEndian>
+
+#include <SipHash.h>
 
 int arithmeticCodingValueFromBuffer(const char* checkValue) {
     if (((uchar) *checkValue) < 255) {
@@ -43,102 +47,100 @@ int packArithmeticallyCodedValue(int value, char* destination) {
     }
 }
 
+const bool VERIFIED = true;
+const bool UNVERIFIED = false;
+const bool SEQUENCED = true;
+const bool UNSEQUENCED = false;
+
+// the arithmetic coded type, the version and the UUID, then the hash and sequence number if the type has them
+#define PACKET_HEADER_BYTES(packetType, isVerified, isSequenceNumbered) \
+    ((packetType + 254) / 255 + NUM_STATIC_HEADER_BYTES + ((isVerified) ? NUM_BYTES_MD5_HASH : 0) \
+     + ((isSequenceNumbered) ? (int)sizeof(PacketSequenceNumber) : 0))
+
+#define PACKET_TYPE_INFO_ENTRY(packetType, version, isVerified, isSequenceNumbered) \
+    { version, isVerified, isSequenceNumbered, PACKET_HEADER_BYTES(packetType, isVerified, isSequenceNumbered), #packetType }
+
+#define UNUSED_PACKET_TYPE_INFO_ENTRY(packetType) \
+    { 0, VERIFIED, UNSEQUENCED, PACKET_HEADER_BYTES(packetType, VERIFIED, UNSEQUENCED), NULL }
+
+// built from constants only, so it is in place before any code runs and a lookup is one load from it
+const PacketTypeInfo PACKET_TYPE_INFO[] = {
+    PACKET_TYPE_INFO_ENTRY(PacketTypeUnknown, 0, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeStunResponse, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeDomainList, 6, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypePing, 0, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypePingReply, 0, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeKillAvatar, 0, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeAvatarData, 7, VERIFIED, SEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeInjectAudio, 2, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeMixedAudio, 2, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeMicrophoneAudioNoEcho, 3, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeMicrophoneAudioWithEcho, 3, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeBulkAvatarData, 1, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeSilentAudioFrame, 5, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeEnvironmentData, 2, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeDomainListRequest, 6, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeRequestAssignment, 2, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeCreateAssignment, 2, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeDomainConnectionDenied, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeMuteEnvironment, 0, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeAudioStreamStats, 1, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeDataServerConfirm, 0, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeDomainServerPathQuery, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeDomainServerPathResponse, 0, UNVERIFIED, UNSEQUENCED),
+    UNUSED_PACKET_TYPE_INFO_ENTRY(UNUSED_3),
+    UNUSED_PACKET_TYPE_INFO_ENTRY(UNUSED_4),
+    UNUSED_PACKET_TYPE_INFO_ENTRY(UNUSED_5),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeOctreeStats, 1, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeJurisdiction, 0, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeJurisdictionRequest, 0, VERIFIED, UNSEQUENCED),
+    UNUSED_PACKET_TYPE_INFO_ENTRY(UNUSED_6),
+    UNUSED_PACKET_TYPE_INFO_ENTRY(UNUSED_7),
+    UNUSED_PACKET_TYPE_INFO_ENTRY(UNUSED_8),
+    UNUSED_PACKET_TYPE_INFO_ENTRY(UNUSED_9),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeNoisyMute, 0, VERIFIED, UNSEQUENCED),
+    UNUSED_PACKET_TYPE_INFO_ENTRY(UNUSED_10),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeAvatarIdentity, 1, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeAvatarBillboard, 0, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeDomainConnectRequest, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeDomainServerRequireDTLS, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeNodeJsonStats, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeEntityQuery, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeEntityData, VERSION_NO_ENTITY_ID_SWAP, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeEntityAdd, VERSION_NO_ENTITY_ID_SWAP, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeEntityErase, 2, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeEntityEdit, VERSION_NO_ENTITY_ID_SWAP, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeOctreeDataNack, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeStopNode, 1, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeAudioEnvironment, 0, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeEntityEditNack, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeSignedTransactionPayment, 0, VERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeIceServerHeartbeat, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeIceServerHeartbeatResponse, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeUnverifiedPing, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeUnverifiedPingReply, 0, UNVERIFIED, UNSEQUENCED),
+    PACKET_TYPE_INFO_ENTRY(PacketTypeParticleEntitiesFix, 0, VERIFIED, UNSEQUENCED)
+};
+
+static_assert(sizeof(PACKET_TYPE_INFO) / sizeof(PACKET_TYPE_INFO[0]) == NUM_PACKET_TYPES,
+              "PACKET_TYPE_INFO needs exactly one entry for each PacketType");
+
+// numBytesForPacketHeaderGivenPacketType works out the header size for types past the end of the table
+const PacketTypeInfo UNKNOWN_PACKET_TYPE_INFO = { 0, VERIFIED, UNSEQUENCED, 0, NULL };
+
 PacketVersion versionForPacketType(PacketType packetType) {
-    switch (packetType) {
-        case PacketTypeMicrophoneAudioNoEcho:
-        case PacketTypeMicrophoneAudioWithEcho:
-            return 2;
-        case PacketTypeSilentAudioFrame:
-            return 4;
-        case PacketTypeMixedAudio:
-            return 1;
-        case PacketTypeInjectAudio:
-            return 1;
-        case PacketTypeAvatarData:
-            return 6;
-        case PacketTypeAvatarIdentity:
-            return 1;
-        case PacketTypeEnvironmentData:
-            return 2;
-        case PacketTypeDomainList:
-        case PacketTypeDomainListRequest:
-            return 5;
-        case PacketTypeCreateAssignment:
-        case PacketTypeRequestAssignment:
-            return 2;
-        case PacketTypeOctreeStats:
-            return 1;
-        case PacketTypeStopNode:
-            return 1;
-        case PacketTypeEntityAdd:
-        case PacketTypeEntityEdit:
-        case PacketTypeEntityData:
-            return VERSION_NO_ENTITY_ID_SWAP;
-        case PacketTypeEntityErase:
-            return 2;
-        case PacketTypeAudioStreamStats:
-            return 1;
-        default:
-            return 0;
-    }
+    return infoForPacketType(packetType).version;
 }
 
-#define PACKET_TYPE_NAME_LOOKUP(x) case x:  return QString(#x);
-
 QString nameForPacketType(PacketType packetType) {
-    switch (packetType) {
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeUnknown);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeStunResponse);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeDomainList);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypePing);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypePingReply);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeKillAvatar);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeAvatarData);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeInjectAudio);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeMixedAudio);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeMicrophoneAudioNoEcho);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeMicrophoneAudioWithEcho);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeBulkAvatarData);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeSilentAudioFrame);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeEnvironmentData);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeDomainListRequest);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeRequestAssignment);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeCreateAssignment);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeDomainConnectionDenied);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeMuteEnvironment);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeAudioStreamStats);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeDataServerConfirm);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeOctreeStats);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeJurisdiction);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeJurisdictionRequest);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeAvatarIdentity);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeAvatarBillboard);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeDomainConnectRequest);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeDomainServerRequireDTLS);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeNodeJsonStats);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeEntityQuery);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeEntityData);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeEntityErase);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeOctreeDataNack);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeStopNode);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeAudioEnvironment);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeEntityEditNack);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeSignedTransactionPayment);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeIceServerHeartbeat);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeIceServerHeartbeatResponse);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeUnverifiedPing);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeUnverifiedPingReply);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeEntityAdd);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeEntityEdit);
-            PACKET_TYPE_NAME_LOOKUP(PacketTypeParticleEntitiesFix);
-        default:
-            return QString("Type: ") + QString::number((int)packetType);
+    const char* name = infoForPacketType(packetType).name;
+    if (name) {
+        return QString(name);
+    } else {
+        return QString("Type: ") + QString::number((int)packetType);
     }
-    return QString("unexpected");
 }
 
-
-
 QByteArray byteArrayWithUUIDPopulatedHeader(PacketType packetType, const QUuid& connectionUUID) {
     QByteArray freshByteArray(MAX_PACKET_HEADER_BYTES, 0);
     freshByteArray.resize(populatePacketHeaderWithUUID(freshByteArray, packetType, connectionUUID));
@@ -163,13 +165,13 @@ int populatePacketHeaderWithUUID(char* packet, PacketType packetType, const QUui
     memcpy(position, rfcUUID.constData(), NUM_BYTES_RFC4122_UUID);
     position += NUM_BYTES_RFC4122_UUID;
     
-    if (!NON_VERIFIED_PACKETS.contains(packetType)) {
+    if (isVerifiedPacketType(packetType)) {
         // pack 16 bytes of zeros where the md5 hash will be placed once data is packed
         memset(position, 0, NUM_BYTES_MD5_HASH);
         position += NUM_BYTES_MD5_HASH;
     }
     
-    if (SEQUENCE_NUMBERED_PACKETS.contains(packetType)) {
+    if (isSequenceNumberedPacketType(packetType)) {
         // Pack zeros for the number of bytes that the sequence number requires.
         // The LimitedNodeList will handle packing in the sequence number when sending out the packet.
         memset(position, 0, sizeof(PacketSequenceNumber));
@@ -195,6 +197,10 @@ int numBytesForArithmeticCodedPacketType(PacketType packetType) {
 }
 
 int numBytesForPacketHeaderGivenPacketType(PacketType packetType) {
+    if ((unsigned int)packetType < (unsigned int)NUM_PACKET_TYPES) {
+        return PACKET_TYPE_INFO[packetType].numHeaderBytes;
+    }
+
     return numBytesForArithmeticCodedPacketType(packetType)
     + numHashBytesForType(packetType)
     + numSequenceNumberBytesForType(packetType)
@@ -202,11 +208,11 @@ int numBytesForPacketHeaderGivenPacketType(PacketType packetType) {
 }
 
 int numHashBytesForType(PacketType packetType) {
-    return (NON_VERIFIED_PACKETS.contains(packetType) ? 0 : NUM_BYTES_MD5_HASH);
+    return isVerifiedPacketType(packetType) ? NUM_BYTES_MD5_HASH : 0;
 }
 
 int numSequenceNumberBytesForType(PacketType packetType) {
-    return (SEQUENCE_NUMBERED_PACKETS.contains(packetType) ? sizeof(PacketSequenceNumber) : 0);
+    return isSequenceNumberedPacketType(packetType) ? sizeof(PacketSequenceNumber) : 0;
 }
 
 QUuid uuidFromPacketHeader(const QByteArray& packet) {
@@ -231,6 +237,48 @@ QByteArray hashForPacketAndConnectionUUID(const QByteArray& packet, const QUuid&
                                     QCryptographicHash::Md5);
 }
 
+// the RFC 4122 bytes of the connection secret, without the allocation of QUuid::toRfc4122
+static void rfc4122BytesForUUID(const QUuid& uuid, uchar bytes[NUM_BYTES_RFC4122_UUID]) {
+    qToBigEndian<quint32>(uuid.data1, bytes);
+    qToBigEndian<quint16>(uuid.data2, bytes + sizeof(quint32));
+    qToBigEndian<quint16>(uuid.data3, bytes + sizeof(quint32) + sizeof(quint16));
+    memcpy(bytes + sizeof(quint32) + 2 * sizeof(quint16), uuid.data4, sizeof(uuid.data4));
+}
+
+void computePacketHash(const char* packet, int packetSize, PacketType packetType, const QUuid& connectionUUID,
+                       PacketHashType hashType, char* hash) {
+    int numHeaderBytes = numBytesForPacketHeaderGivenPacketType(packetType);
+    const char* payload = packet + numHeaderBytes;
+    int payloadSize = packetSize - numHeaderBytes;
+
+    uchar secret[NUM_BYTES_RFC4122_UUID];
+    rfc4122BytesForUUID(connectionUUID, secret);
+
+    if (hashType == PacketHashSipHash) {
+        sipHash128(payload, payloadSize, secret, reinterpret_cast<uchar*>(hash));
+    } else {
+        QCryptographicHash md5(QCryptographicHash::Md5);
+        md5.addData(payload, payloadSize);
+        md5.addData(reinterpret_cast<const char*>(secret), NUM_BYTES_RFC4122_UUID);
+        memcpy(hash, md5.result().constData(), NUM_BYTES_MD5_HASH);
+    }
+}
+
+bool packetHashMatches(const QByteArray& packet, const QUuid& connectionUUID, PacketHashType hashType,
+                       PacketType packetType) {
+    if (packetType == PacketTypeUnknown) {
+        packetType = packetTypeForPacket(packet);
+    }
+
+    if (packet.size() < numBytesForPacketHeaderGivenPacketType(packetType)) {
+        return false;
+    }
+
+    char expectedHash[NUM_BYTES_MD5_HASH];
+    computePacketHash(packet.constData(), packet.size(), packetType, connectionUUID, hashType, expectedHash);
+    return memcmp(packet.constData() + hashOffsetForPacketType(packetType), expectedHash, NUM_BYTES_MD5_HASH) == 0;
+}
+
 PacketSequenceNumber sequenceNumberFromHeader(const QByteArray& packet, PacketType packetType) {
     if (packetType == PacketTypeUnknown) {
         packetType = packetTypeForPacket(packet);
@@ -238,20 +286,22 @@ PacketSequenceNumber sequenceNumberFromHeader(const QByteArray& packet, PacketTy
     
     PacketSequenceNumber result = DEFAULT_SEQUENCE_NUMBER;
     
-    if (SEQUENCE_NUMBERED_PACKETS.contains(packetType)) {
+    if (isSequenceNumberedPacketType(packetType)) {
         memcpy(&result, packet.data() + sequenceNumberOffsetForPacketType(packetType), sizeof(PacketSequenceNumber));
     }
     
     return result;
 }
 
-void replaceHashInPacket(QByteArray& packet, const QUuid& connectionUUID, PacketType packetType) {
+void replaceHashInPacket(QByteArray& packet, const QUuid& connectionUUID, PacketHashType hashType, PacketType packetType) {
     if (packetType == PacketTypeUnknown) {
         packetType = packetTypeForPacket(packet);
     }
-    
-    packet.replace(hashOffsetForPacketType(packetType), NUM_BYTES_MD5_HASH,
-                   hashForPacketAndConnectionUUID(packet, connectionUUID));
+
+    // data() detaches once if the buffer is shared, after that the hash goes straight into the header
+    char* packetData = packet.data();
+    computePacketHash(packetData, packet.size(), packetType, connectionUUID, hashType,
+                      packetData + hashOffsetForPacketType(packetType));
 }
 
 void replaceSequenceNumberInPacket(QByteArray& packet, PacketSequenceNumber sequenceNumber, PacketType packetType) {
@@ -263,13 +313,13 @@ void replaceSequenceNumberInPacket(QByteArray& packet, PacketSequenceNumber sequ
                    sizeof(PacketSequenceNumber), reinterpret_cast<char*>(&sequenceNumber), sizeof(PacketSequenceNumber));
 }
 
-void replaceHashAndSequenceNumberInPacket(QByteArray& packet, const QUuid& connectionUUID, PacketSequenceNumber sequenceNumber,
-                                          PacketType packetType) {
+void replaceHashAndSequenceNumberInPacket(QByteArray& packet, const QUuid& connectionUUID, PacketHashType hashType,
+                                          PacketSequenceNumber sequenceNumber, PacketType packetType) {
     if (packetType == PacketTypeUnknown) {
         packetType = packetTypeForPacket(packet);
     }
     
-    replaceHashInPacket(packet, connectionUUID, packetType);
+    replaceHashInPacket(packet, connectionUUID, hashType, packetType);
     replaceSequenceNumberInPacket(packet, sequenceNumber, packetType);
 }
 
@@ -24,7 +24,7 @@
 #include "UUID.h"
 
 // NOTE: if adding a new packet packetType, you can replace one marked usable or add at the end
-// NOTE: if you want the name of the packet packetType to be available for debugging or logging, update nameForPacketType() as well
+// NOTE: every packet packetType needs an entry in PACKET_TYPE_INFO in PacketHeaders.cpp, in the same order
 enum PacketType {
     PacketTypeUnknown, // 0
     PacketTypeStunResponse,
@@ -80,7 +80,8 @@ enum PacketType {
     PacketTypeIceServerHeartbeatResponse,
     PacketTypeUnverifiedPing,
     PacketTypeUnverifiedPingReply,
-    PacketTypeParticleEntitiesFix
+    PacketTypeParticleEntitiesFix,
+    NUM_PACKET_TYPES
 };
 
 typedef char PacketVersion;
@@ -90,23 +91,38 @@ const PacketSequenceNumber DEFAULT_SEQUENCE_NUMBER = 0;
 
 typedef std::map<PacketType, PacketSequenceNumber> PacketTypeSequenceMap;
 
-const QSet<PacketType> NON_VERIFIED_PACKETS = QSet<PacketType>()
-<< PacketTypeDomainServerRequireDTLS << PacketTypeDomainConnectRequest
-<< PacketTypeDomainList << PacketTypeDomainListRequest << PacketTypeDomainConnectionDenied
-<< PacketTypeCreateAssignment << PacketTypeRequestAssignment << PacketTypeStunResponse
-<< PacketTypeNodeJsonStats << PacketTypeEntityQuery
-<< PacketTypeOctreeDataNack << PacketTypeEntityEditNack
-<< PacketTypeIceServerHeartbeat << PacketTypeIceServerHeartbeatResponse
-<< PacketTypeUnverifiedPing << PacketTypeUnverifiedPingReply << PacketTypeStopNode
-<< PacketTypeDomainServerPathQuery << PacketTypeDomainServerPathResponse;
-
-const QSet<PacketType> SEQUENCE_NUMBERED_PACKETS = QSet<PacketType>()
-<< PacketTypeAvatarData;
-
+// verified packets carry a hash of their payload and the connection secret in this many bytes of their header
 const int NUM_BYTES_MD5_HASH = 16;
 const int NUM_STATIC_HEADER_BYTES = sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID;
 const int MAX_PACKET_HEADER_BYTES = sizeof(PacketType) + NUM_BYTES_MD5_HASH + NUM_STATIC_HEADER_BYTES;
 
+enum PacketHashType {
+    PacketHashMD5 = 0, // MD5 of the payload followed by the connection secret, the only hash older nodes understand
+    PacketHashSipHash // SipHash-2-4-128 of the payload keyed by the connection secret
+};
+
+/// what the header of each packet type looks like, the table is indexed by PacketType
+struct PacketTypeInfo {
+    PacketVersion version;
+    bool isVerified; // the header carries a hash of the payload and the connection secret
+    bool isSequenceNumbered;
+    int numHeaderBytes;
+    const char* name; // NULL for the unused types
+};
+
+extern const PacketTypeInfo PACKET_TYPE_INFO[];
+
+// what header parsing has always assumed about a type we don't know
+extern const PacketTypeInfo UNKNOWN_PACKET_TYPE_INFO;
+
+inline const PacketTypeInfo& infoForPacketType(PacketType packetType) {
+    return ((unsigned int)packetType < (unsigned int)NUM_PACKET_TYPES)
+        ? PACKET_TYPE_INFO[packetType] : UNKNOWN_PACKET_TYPE_INFO;
+}
+
+inline bool isVerifiedPacketType(PacketType packetType) { return infoForPacketType(packetType).isVerified; }
+inline bool isSequenceNumberedPacketType(PacketType packetType) { return infoForPacketType(packetType).isSequenceNumbered; }
+
 PacketType packetTypeForPacket(const QByteArray& packet);
 PacketType packetTypeForPacket(const char* packet);
 
@@ -135,18 +151,27 @@ int sequenceNumberOffsetForPacketType(PacketType packetType);
 QByteArray hashFromPacketHeader(const QByteArray& packet);
 QByteArray hashForPacketAndConnectionUUID(const QByteArray& packet, const QUuid& connectionUUID);
 
-// NOTE: The following four methods accept a PacketType which defaults to PacketTypeUnknown.
+/// writes the NUM_BYTES_MD5_HASH byte hash of the payload of a packet with a header for packetType to hash
+void computePacketHash(const char* packet, int packetSize, PacketType packetType, const QUuid& connectionUUID,
+                       PacketHashType hashType, char* hash);
+
+// NOTE: The following five methods accept a PacketType which defaults to PacketTypeUnknown.
 // If the caller has already looked at the packet type and can provide it then the methods below won't have to look it up.
 
 PacketSequenceNumber sequenceNumberFromHeader(const QByteArray& packet, PacketType packetType = PacketTypeUnknown);
 
-void replaceHashInPacket(QByteArray& packet, const QUuid& connectionUUID, PacketType packetType = PacketTypeUnknown);
+/// compares the hash in the header with the one we expect without making copies of the packet
+bool packetHashMatches(const QByteArray& packet, const QUuid& connectionUUID, PacketHashType hashType,
+                       PacketType packetType = PacketTypeUnknown);
+
+void replaceHashInPacket(QByteArray& packet, const QUuid& connectionUUID, PacketHashType hashType,
+                         PacketType packetType = PacketTypeUnknown);
 
 void replaceSequenceNumberInPacket(QByteArray& packet, PacketSequenceNumber sequenceNumber,
                                    PacketType packetType = PacketTypeUnknown);
 
-void replaceHashAndSequenceNumberInPacket(QByteArray& packet, const QUuid& connectionUUID, PacketSequenceNumber sequenceNumber,
-                                          PacketType packetType = PacketTypeUnknown);
+void replaceHashAndSequenceNumberInPacket(QByteArray& packet, const QUuid& connectionUUID, PacketHashType hashType,
+                                          PacketSequenceNumber sequenceNumber, PacketType packetType = PacketTypeUnknown);
 
 int arithmeticCodingValueFromBuffer(const char* checkValue);
 int numBytesArithmeticCodingFromBuffer(const char* checkValue);
@@ -28,11 +28,12 @@ const int PacketSender::MINIMAL_SLEEP_INTERVAL = (USECS_PER_SECOND / TARGET_FPS)
 
 const int AVERAGE_CALL_TIME_SAMPLES = 10;
 
-PacketSender::PacketSender(int packetsPerSecond) :
+PacketSender::PacketSender(int packetsPerSecond, int initialQueueCapacity) :
     _packetsPerSecond(packetsPerSecond),
     _usecsPerProcessCallHint(0),
     _lastProcessCallTime(0),
     _averageProcessCallTime(AVERAGE_CALL_TIME_SAMPLES),
+    _packets(initialQueueCapacity, NetworkPacketQueue::Grow),
     _lastSendTime(0), // Note: we set this to 0 to indicate we haven't yet sent something
     _lastPPSCheck(0),
     _packetsOverCheckInterval(0),
@@ -49,15 +50,10 @@ PacketSender::~PacketSender() {
 
 
 void PacketSender::queuePacketForSending(const SharedNodePointer& destinationNode, const QByteArray& packet) {
-    NetworkPacket networkPacket(destinationNode, packet);
-    lock();
-    _packets.push_back(networkPacket);
-    unlock();
+    // this wakes our actual processing thread because it now has packets to process
+    _packets.enqueue(destinationNode, packet);
     _totalPacketsQueued++;
     _totalBytesQueued += packet.size();
-
-    // Make sure to  wake our actual processing thread because we  now have packets for it to process.
-    _hasPackets.wakeAll();
 }
 
 void PacketSender::setPacketsPerSecond(int packetsPerSecond) {
@@ -73,7 +69,7 @@ bool PacketSender::process() {
 }
 
 void PacketSender::terminating() {
-    _hasPackets.wakeAll();
+    _packets.stop();
 }
 
 bool PacketSender::threadedProcess() {
@@ -84,7 +80,7 @@ bool PacketSender::threadedProcess() {
     }
 
     // in threaded mode, we keep running and just empty our packet queue sleeping enough to keep our PPS on target
-    while (_packets.size() > 0) {
+    while (!_packets.isEmpty()) {
         // Recalculate our SEND_INTERVAL_USECS each time, in case the caller has changed it on us..
         int packetsPerSecondTarget = (_packetsPerSecond > MINIMUM_PACKETS_PER_SECOND)
                                             ? _packetsPerSecond : MINIMUM_PACKETS_PER_SECOND;
@@ -118,10 +114,8 @@ bool PacketSender::threadedProcess() {
 
     // if threaded and we haven't slept? We want to wait for our consumer to signal us with new packets
     if (!hasSlept) {
-        // wait till we have packets        
-        _waitingOnPacketsMutex.lock();
-        _hasPackets.wait(&_waitingOnPacketsMutex);
-        _waitingOnPacketsMutex.unlock();
+        // wait till we have packets
+        _packets.waitForPackets();
     }
 
     return isStillRunning();
@@ -163,7 +157,7 @@ bool PacketSender::nonThreadedProcess() {
         averageCallTime = _usecsPerProcessCallHint;
     }
 
-    if (_packets.size() == 0) {
+    if (_packets.isEmpty()) {
         // in non-threaded mode, if there's nothing to do, just return, keep running till they terminate us
         return isStillRunning();
     }
@@ -178,7 +172,6 @@ bool PacketSender::nonThreadedProcess() {
 
 
     float averagePacketsPerCall = 0;  // might be less than 1, if our caller calls us more frequently than the target PPS
-    int packetsSentThisCall = 0;
     int packetsToSendThisCall = 0;
 
     // Since we're in non-threaded mode, we need to determine how many packets to send per call to process
@@ -259,27 +252,25 @@ bool PacketSender::nonThreadedProcess() {
         }
     }
 
-    int packetsLeft = _packets.size();
+    // Now that we know how many packets to send this call to process, take them from the queue at once and send them.
+    if (packetsToSendThisCall > 0) {
+        _packets.dequeueBatch(_batch, packetsToSendThisCall);
+    }
 
-    // Now that we know how many packets to send this call to process, just send them.
-    while ((packetsSentThisCall < packetsToSendThisCall) && (packetsLeft > 0)) {
-        lock();
-        NetworkPacket& packet = _packets.front();
-        NetworkPacket temporary = packet; // make a copy
-        _packets.erase(_packets.begin());
-        packetsLeft = _packets.size();
-        unlock();
+    auto nodeList = DependencyManager::get<NodeList>();
+    for (size_t i = 0; i < _batch.size(); i++) {
+        const NetworkPacket& packet = _batch[i];
 
         // send the packet through the NodeList...
-        DependencyManager::get<NodeList>()->writeDatagram(temporary.getByteArray(), temporary.getNode());
-        packetsSentThisCall++;
+        nodeList->writeDatagram(packet.getByteArray(), packet.getNode());
         _packetsOverCheckInterval++;
         _totalPacketsSent++;
-        _totalBytesSent += temporary.getByteArray().size();
-        
-        emit packetSent(temporary.getByteArray().size());
-        
+        _totalBytesSent += packet.getByteArray().size();
+
+        emit packetSent(packet.getByteArray().size());
+
         _lastSendTime = now;
     }
+    _batch.clear();
     return isStillRunning();
 }
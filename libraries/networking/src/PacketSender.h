@@ -14,10 +14,11 @@
 #ifndef hifi_PacketSender_h
 #define hifi_PacketSender_h
 
-#include <QWaitCondition>
+#include <vector>
 
 #include "GenericThread.h"
 #include "NetworkPacket.h"
+#include "NetworkPacketQueue.h"
 #include "NodeList.h"
 #include "SharedUtil.h"
 
@@ -35,10 +36,12 @@ public:
     static const int MINIMUM_PACKETS_PER_SECOND;
     static const int MINIMAL_SLEEP_INTERVAL;
 
-    PacketSender(int packetsPerSecond = DEFAULT_PACKETS_PER_SECOND);
+    PacketSender(int packetsPerSecond = DEFAULT_PACKETS_PER_SECOND,
+                 int initialQueueCapacity = NetworkPacketQueue::DEFAULT_CAPACITY);
     ~PacketSender();
 
-    /// Add packet to outbound queue.
+    /// Add packet to outbound queue. The queue grows rather than hold up the caller or drop the packet, the packets
+    /// queued here (edits among them) are the only copy there is.
     void queuePacketForSending(const SharedNodePointer& destinationNode, const QByteArray& packet);
 
     void setPacketsPerSecond(int packetsPerSecond);
@@ -48,7 +51,7 @@ public:
     virtual void terminating();
 
     /// are there packets waiting in the send queue to be sent
-    bool hasPacketsToSend() const { return _packets.size() > 0; }
+    bool hasPacketsToSend() const { return !_packets.isEmpty(); }
 
     /// how many packets are there in the send queue waiting to be sent
     int packetsToSendCount() const { return _packets.size(); }
@@ -91,6 +94,7 @@ public:
 
     /// returns the total bytes queued by this object over its lifetime
     quint64 getLifetimeBytesQueued() const { return _totalBytesQueued; }
+
 signals:
     void packetSent(quint64);
 protected:
@@ -100,7 +104,8 @@ protected:
     SimpleMovingAverage _averageProcessCallTime;
 
 private:
-    std::vector<NetworkPacket> _packets;
+    NetworkPacketQueue _packets;
+    std::vector<NetworkPacket> _batch;
     quint64 _lastSendTime;
 
     bool threadedProcess();
@@ -115,9 +120,6 @@ private:
 
     quint64 _totalPacketsQueued;
     quint64 _totalBytesQueued;
-
-    QWaitCondition _hasPackets;
-    QMutex _waitingOnPacketsMutex;
 };
 
 #endif // hifi_PacketSender_h
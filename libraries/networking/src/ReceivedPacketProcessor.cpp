@@ -9,54 +9,69 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <NumericalConstants.h>
+
+#include "NetworkLogging.h"
 #include "NodeList.h"
 #include "ReceivedPacketProcessor.h"
 #include "SharedUtil.h"
 
+// packets from a node are only counted while they are in the queue, so we take them a few at a time to keep the
+// counts close to what is still waiting to be processed
+const int ReceivedPacketProcessor::MAX_PACKETS_PER_BATCH = 64;
+
+// dropped packets are logged at most this often, so a storm of them doesn't become a storm of log lines
+const quint64 DROPPED_PACKETS_LOG_INTERVAL = 10 * USECS_PER_SECOND;
+
+ReceivedPacketProcessor::ReceivedPacketProcessor(int maxQueuedPackets, NetworkPacketQueue::OverflowPolicy overflowPolicy) :
+    _packets(maxQueuedPackets, overflowPolicy),
+    _lastDropLogTime(0),
+    _lastLoggedDroppedPacketCount(0)
+{
+    _batch.reserve(MAX_PACKETS_PER_BATCH);
+}
+
 void ReceivedPacketProcessor::terminating() {
-    _hasPackets.wakeAll();
+    _packets.stop();
 }
 
 void ReceivedPacketProcessor::queueReceivedPacket(const SharedNodePointer& sendingNode, const QByteArray& packet) {
     // Make sure our Node and NodeList knows we've heard from this node.
     sendingNode->setLastHeardMicrostamp(usecTimestampNow());
 
-    NetworkPacket networkPacket(sendingNode, packet);
-    lock();
-    _packets.push_back(networkPacket);
-    _nodePacketCounts[sendingNode->getUUID()]++;
-    unlock();
-    
-    // Make sure to  wake our actual processing thread because we  now have packets for it to process.
-    _hasPackets.wakeAll();
+    // this wakes our actual processing thread because it now has packets to process
+    _packets.enqueue(sendingNode, packet);
 }
 
 bool ReceivedPacketProcessor::process() {
 
-    if (_packets.size() == 0) {
-        _waitingOnPacketsMutex.lock();
-        _hasPackets.wait(&_waitingOnPacketsMutex, getMaxWait());
-        _waitingOnPacketsMutex.unlock();
+    if (_packets.isEmpty()) {
+        _packets.waitForPackets(getMaxWait());
     }
     preProcess();
-    while (_packets.size() > 0) {
-        lock(); // lock to make sure nothing changes on us
-        NetworkPacket& packet = _packets.front(); // get the oldest packet
-        NetworkPacket temporary = packet; // make a copy of the packet in case the vector is resized on us
-        _packets.erase(_packets.begin()); // remove the oldest packet
-        if (!temporary.getNode().isNull()) {
-            _nodePacketCounts[temporary.getNode()->getUUID()]--;
+    while (_packets.dequeueBatch(_batch, MAX_PACKETS_PER_BATCH) > 0) {
+        for (size_t i = 0; i < _batch.size(); i++) {
+            processPacket(_batch[i].getNode(), _batch[i].getByteArray());
+            midProcess();
         }
-        unlock(); // let others add to the packets
-        processPacket(temporary.getNode(), temporary.getByteArray()); // process our temporary copy
-        midProcess();
     }
+    _batch.clear();
+
+    quint64 droppedPacketCount = _packets.getDroppedPacketCount();
+    if (droppedPacketCount > _lastLoggedDroppedPacketCount) {
+        quint64 now = usecTimestampNow();
+        if (now - _lastDropLogTime > DROPPED_PACKETS_LOG_INTERVAL) {
+            qCDebug(networking) << "Dropped" << (droppedPacketCount - _lastLoggedDroppedPacketCount)
+                << "received packets because the queue was full," << droppedPacketCount << "in total";
+            _lastDropLogTime = now;
+            _lastLoggedDroppedPacketCount = droppedPacketCount;
+        }
+    }
+
     postProcess();
     return isStillRunning();  // keep running till they terminate us
 }
 
 void ReceivedPacketProcessor::nodeKilled(SharedNodePointer node) {
-    lock();
-    _nodePacketCounts.remove(node->getUUID());
-    unlock();
+    _packets.removeNode(node->getUUID());
 }
@@ -12,26 +12,30 @@
 #ifndef hifi_ReceivedPacketProcessor_h
 #define hifi_ReceivedPacketProcessor_h
 
-#include <QWaitCondition>
+#include <vector>
 
 #include "GenericThread.h"
 #include "NetworkPacket.h"
+#include "NetworkPacketQueue.h"
 
 /// Generalized threaded processor for handling received inbound packets. 
 class ReceivedPacketProcessor : public GenericThread {
     Q_OBJECT
 public:
-    ReceivedPacketProcessor() { }
+    static const int MAX_PACKETS_PER_BATCH;
+
+    ReceivedPacketProcessor(int maxQueuedPackets = NetworkPacketQueue::DEFAULT_CAPACITY,
+                            NetworkPacketQueue::OverflowPolicy overflowPolicy = NetworkPacketQueue::DropOldest);
 
     /// Add packet from network receive thread to the processing queue.
     void queueReceivedPacket(const SharedNodePointer& sendingNode, const QByteArray& packet);
 
     /// Are there received packets waiting to be processed
-    bool hasPacketsToProcess() const { return _packets.size() > 0; }
+    bool hasPacketsToProcess() const { return !_packets.isEmpty(); }
 
     /// Is a specified node still alive?
     bool isAlive(const QUuid& nodeUUID) const {
-        return _nodePacketCounts.contains(nodeUUID);
+        return _packets.hasNode(nodeUUID);
     }
 
     /// Are there received packets waiting to be processed from a specified node
@@ -41,12 +45,15 @@ public:
 
     /// Are there received packets waiting to be processed from a specified node
     bool hasPacketsToProcessFrom(const QUuid& nodeUUID) const {
-        return _nodePacketCounts[nodeUUID] > 0;
+        return _packets.packetCountFrom(nodeUUID) > 0;
     }
 
     /// How many received packets waiting are to be processed
     int packetsToProcessCount() const { return _packets.size(); }
 
+    /// How many received packets were dropped because the queue was full
+    quint64 getDroppedPacketCount() const { return _packets.getDroppedPacketCount(); }
+
     virtual void terminating();
 
 public slots:
@@ -75,11 +82,14 @@ protected:
 
 protected:
 
-    QVector<NetworkPacket> _packets;
-    QHash<QUuid, int> _nodePacketCounts;
+    /// by default a full queue drops its oldest packets rather than holding up the thread that receives them
+    NetworkPacketQueue _packets;
+
+    quint64 _lastDropLogTime;
+    quint64 _lastLoggedDroppedPacketCount;
 
-    QWaitCondition _hasPackets;
-    QMutex _waitingOnPacketsMutex;
+    /// the packets taken from the queue that are being processed, kept to reuse its storage
+    std::vector<NetworkPacket> _batch;
 };
 
 #endif // hifi_ReceivedPacketProcessor_h
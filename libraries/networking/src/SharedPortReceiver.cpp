@@ -0,0 +1,125 @@
+//
+//  SharedPortReceiver.cpp
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SharedPortReceiver.h"
+
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "NetworkLogging.h"
+
+// how often a receiver waiting on a quiet socket wakes up to check if it has been stopped
+const int RECEIVE_TIMEOUT_MSECS = 100;
+
+// nothing we send comes close to this, but a datagram that doesn't fit is dropped instead of read in part
+const int MAX_RECEIVED_DATAGRAM_BYTES = 8192;
+const int MAX_DATAGRAMS_PER_CALL = 32;
+
+SharedPortReceiver::SharedPortReceiver(int socketDescriptor) :
+    _socketDescriptor(socketDescriptor),
+    _isStopped(0)
+{
+
+}
+
+SharedPortReceiver::~SharedPortReceiver() {
+#ifdef Q_OS_LINUX
+    if (_socketDescriptor != -1) {
+        close(_socketDescriptor);
+    }
+#endif
+}
+
+int SharedPortReceiver::openSharedPortSocket(quint16 port, int bufferBytes) {
+#if defined(Q_OS_LINUX) && defined(SO_REUSEPORT)
+    int socketDescriptor = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socketDescriptor == -1) {
+        return -1;
+    }
+
+    int reusePort = 1;
+    timeval receiveTimeout = { 0, RECEIVE_TIMEOUT_MSECS * 1000 };
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    if (setsockopt(socketDescriptor, SOL_SOCKET, SO_REUSEPORT, &reusePort, sizeof(reusePort)) == -1
+        || setsockopt(socketDescriptor, SOL_SOCKET, SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout)) == -1
+        || bind(socketDescriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        qCDebug(networking) << "Could not open a socket sharing port" << port << "-" << strerror(errno);
+        close(socketDescriptor);
+        return -1;
+    }
+
+    // same as the node socket, a burst shouldn't overflow the socket before its thread gets to it
+    setsockopt(socketDescriptor, SOL_SOCKET, SO_RCVBUF, &bufferBytes, sizeof(bufferBytes));
+    setsockopt(socketDescriptor, SOL_SOCKET, SO_SNDBUF, &bufferBytes, sizeof(bufferBytes));
+
+    return socketDescriptor;
+#else
+    Q_UNUSED(port);
+    Q_UNUSED(bufferBytes);
+    return -1;
+#endif
+}
+
+void SharedPortReceiver::readDatagrams() {
+#ifdef Q_OS_LINUX
+    QByteArray buffers(MAX_DATAGRAMS_PER_CALL * MAX_RECEIVED_DATAGRAM_BYTES, 0);
+    mmsghdr messages[MAX_DATAGRAMS_PER_CALL];
+    iovec vectors[MAX_DATAGRAMS_PER_CALL];
+    sockaddr_in addresses[MAX_DATAGRAMS_PER_CALL];
+
+    while (!_isStopped.load()) {
+        memset(messages, 0, sizeof(messages));
+
+        for (int i = 0; i < MAX_DATAGRAMS_PER_CALL; i++) {
+            vectors[i].iov_base = buffers.data() + i * MAX_RECEIVED_DATAGRAM_BYTES;
+            vectors[i].iov_len = MAX_RECEIVED_DATAGRAM_BYTES;
+
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        // blocks until there is at least one datagram (or the receive timeout passes), then takes whatever is queued
+        int numMessages = recvmmsg(_socketDescriptor, messages, MAX_DATAGRAMS_PER_CALL, MSG_WAITFORONE, NULL);
+
+        if (numMessages == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                qCDebug(networking) << "Error reading shared port socket -" << strerror(errno);
+            }
+            continue;
+        }
+
+        for (int i = 0; i < numMessages; i++) {
+            if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                continue;
+            }
+
+            QByteArray receivedPacket(static_cast<const char*>(vectors[i].iov_base), messages[i].msg_len);
+            HifiSockAddr senderSockAddr(reinterpret_cast<const sockaddr*>(&addresses[i]));
+
+            emit packetRequiresProcessing(receivedPacket, senderSockAddr);
+        }
+    }
+#endif
+}
@@ -0,0 +1,48 @@
+//
+//  SharedPortReceiver.h
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SharedPortReceiver_h
+#define hifi_SharedPortReceiver_h
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QByteArray>
+#include <QtCore/QObject>
+
+#include "HifiSockAddr.h"
+
+/// Reads one of several UDP sockets bound to the same port with SO_REUSEPORT, where the kernel spreads the datagrams
+/// for the port across the sockets by hashing the sender's address. readDatagrams blocks, so each receiver gets a
+/// thread of its own. Only Linux can share a port this way, everywhere else openSharedPortSocket always fails.
+class SharedPortReceiver : public QObject {
+    Q_OBJECT
+public:
+    /// takes over a socket returned by openSharedPortSocket, it is closed when the receiver is deleted
+    SharedPortReceiver(int socketDescriptor);
+    ~SharedPortReceiver();
+
+    /// opens a UDP socket bound to port that other SO_REUSEPORT sockets can share, returns -1 if it can't
+    static int openSharedPortSocket(quint16 port, int bufferBytes);
+
+    /// asks readDatagrams to return, safe to call from any thread
+    void stop() { _isStopped.store(1); }
+
+public slots:
+    /// reads datagrams in batches until stop is called
+    void readDatagrams();
+
+signals:
+    void packetRequiresProcessing(const QByteArray& receivedPacket, const HifiSockAddr& senderSockAddr);
+
+private:
+    int _socketDescriptor;
+    QAtomicInt _isStopped;
+};
+
+#endif // hifi_SharedPortReceiver_h
@@ -46,6 +46,8 @@ void ThreadedAssignment::setFinished(bool isFinished) {
             // this ensures we won't process a domain list while we are going down
             auto nodeList = DependencyManager::get<NodeList>();
             disconnect(&nodeList->getNodeSocket(), 0, this, 0);
+            disconnect(nodeList.data(), &LimitedNodeList::sharedPortPacketReceived, this, 0);
+            nodeList->closeSharedPortReceivers();
 
             // call our virtual aboutToFinish method - this gives the ThreadedAssignment subclass a chance to cleanup
             aboutToFinish();
@@ -26,6 +26,7 @@
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QNetworkAccessManager>
+#include <QScopedPointer>
 #include <QVector>
 #include <QFile>
 #include <QJsonDocument>
@@ -55,6 +56,11 @@ float boundaryDistanceForRenderLevel(unsigned int renderLevel, float voxelSizeSc
     return voxelSizeScale / powf(2, renderLevel);
 }
 
+OctreeSnapshot::OctreeSnapshot() :
+    _takenAt(usecTimestampNow())
+{
+}
+
 Octree::Octree(bool shouldReaverage) :
     _rootElement(NULL),
     _isDirty(true),
@@ -62,7 +68,12 @@ Octree::Octree(bool shouldReaverage) :
     _stopImport(false),
     _lock(QReadWriteLock::Recursive),
     _isViewing(false),
-    _isServer(false)
+    _isServer(false),
+    _lastSnapshotTakenAt(0),
+    _lastSnapshotLockTime(0),
+    _lastSnapshotAge(0),
+    _lastSnapshotItemCount(0),
+    _lastSnapshotMemoryUsage(0)
 {
 }
 
@@ -2068,22 +2079,22 @@ bool Octree::readJSONFromStream(unsigned long streamLength, QDataStream& inputSt
     return true;
 }
 
-void Octree::writeToFile(const char* fileName, OctreeElement* element, QString persistAsFileType) {
+bool Octree::writeToFile(const char* fileName, OctreeElement* element, QString persistAsFileType) {
     // make the sure file extension makes sense
     QString qFileName = fileNameWithoutExtension(QString(fileName), PERSIST_EXTENSIONS) + "." + persistAsFileType;
     QByteArray byteArray = qFileName.toUtf8();
     const char* cFileName = byteArray.constData();
 
     if (persistAsFileType == "svo") {
-        writeToSVOFile(fileName, element);
+        return writeToSVOFile(fileName, element);
     } else if (persistAsFileType == "json") {
-        writeToJSONFile(cFileName, element);
-    } else {
-        qCDebug(octree) << "unable to write octree to file of type" << persistAsFileType;
+        return writeToJSONFile(cFileName, element);
     }
+    qCDebug(octree) << "unable to write octree to file of type" << persistAsFileType;
+    return false;
 }
 
-void Octree::writeToJSONFile(const char* fileName, OctreeElement* element) {
+bool Octree::writeToJSONFile(const char* fileName, OctreeElement* element) {
     QFile persistFile(fileName);
     QVariantMap entityDescription;
 
@@ -2096,15 +2107,34 @@ void Octree::writeToJSONFile(const char* fileName, OctreeElement* element) {
         top = _rootElement;
     }
 
-    bool entityDescriptionSuccess = writeToMap(entityDescription, top, true);
+    // only copying the content needs the lock, building the description and writing it out happen after edits can
+    // get back into the tree
+    quint64 lockStart = usecTimestampNow();
+    lockForRead();
+    QScopedPointer<OctreeSnapshot> snapshot(takeSnapshot(top));
+    unlock();
+    quint64 lockEnd = usecTimestampNow();
+
+    bool success = false;
+    bool entityDescriptionSuccess = snapshot->writeToMap(entityDescription, true);
     if (entityDescriptionSuccess && persistFile.open(QIODevice::WriteOnly)) {
-        persistFile.write(QJsonDocument::fromVariant(entityDescription).toJson());
-    } else {
+        QByteArray json = QJsonDocument::fromVariant(entityDescription).toJson();
+        success = persistFile.write(json) == json.size() && persistFile.flush();
+        persistFile.close();
+    }
+    if (!success) {
         qCritical("Could not write to JSON description of entities.");
     }
+
+    _lastSnapshotTakenAt = snapshot->getTakenAt();
+    _lastSnapshotLockTime = lockEnd - lockStart;
+    _lastSnapshotAge = usecTimestampNow() - snapshot->getTakenAt();
+    _lastSnapshotItemCount = snapshot->getItemCount();
+    _lastSnapshotMemoryUsage = snapshot->getMemoryUsage();
+    return success;
 }
 
-void Octree::writeToSVOFile(const char* fileName, OctreeElement* element) {
+bool Octree::writeToSVOFile(const char* fileName, OctreeElement* element) {
     std::ofstream file(fileName, std::ios::out|std::ios::binary);
 
     if(file.is_open()) {
@@ -2183,7 +2213,13 @@ void Octree::writeToSVOFile(const char* fileName, OctreeElement* element) {
         
         releaseSceneEncodeData(&extraEncodeData);
     }
-    file.close();
+    file.close(); // flushes, so a failed write shows up below
+
+    if (file.fail()) {
+        qCDebug(octree, "Could not write binary SVO to file %s", fileName);
+        return false;
+    }
+    return true;
 }
 
 unsigned long Octree::getOctreeElementsCount() {
@@ -214,6 +214,30 @@ public:
     {}
 };
 
+/// A copy of a tree's content taken while the tree is locked, so that it can be written out after the lock is released
+/// without holding up edits. Implement this alongside Octree::takeSnapshot() in your tree class.
+class OctreeSnapshot {
+public:
+    OctreeSnapshot();
+    virtual ~OctreeSnapshot() { }
+
+    quint64 getTakenAt() const { return _takenAt; }
+
+    /// how many items (entities) were copied into the snapshot
+    virtual int getItemCount() const = 0;
+
+    /// roughly how many bytes the snapshot holds beyond what it still shares with the tree
+    virtual qint64 getMemoryUsage() const = 0;
+
+    virtual bool writeToMap(QVariantMap& entityDescription, bool skipDefaultValues) const = 0;
+
+    /// Appends records of the snapshot's items to a change journal, see Octree::replayJournal()
+    virtual void writeToJournal(QByteArray& journal) const = 0;
+
+private:
+    quint64 _takenAt;
+};
+
 class Octree : public QObject {
     Q_OBJECT
 public:
@@ -328,10 +352,35 @@ public:
     void loadOctreeFile(const char* fileName, bool wantColorRandomizer);
 
     // Octree exporters
-    void writeToFile(const char* filename, OctreeElement* element = NULL, QString persistAsFileType = "svo");
-    void writeToJSONFile(const char* filename, OctreeElement* element = NULL);
-    void writeToSVOFile(const char* filename, OctreeElement* element = NULL);
-    virtual bool writeToMap(QVariantMap& entityDescription, OctreeElement* element, bool skipDefaultValues) = 0;
+    /// \return false if the file could not be completely written
+    bool writeToFile(const char* filename, OctreeElement* element = NULL, QString persistAsFileType = "svo");
+    bool writeToJSONFile(const char* filename, OctreeElement* element = NULL);
+    bool writeToSVOFile(const char* filename, OctreeElement* element = NULL);
+
+    /// Copies element (or the whole tree if element is NULL) into a snapshot, the caller must hold the tree lock.
+    virtual OctreeSnapshot* takeSnapshot(OctreeElement* element) = 0;
+
+    // A tree that can tell what changed in it can be persisted by appending those changes to a journal between full
+    // writes, and copied by replaying them. Each journal keeps its own changes, so the persist thread and the version
+    // publisher can each take theirs. The caller must hold the tree lock for each of these, for writing when starting
+    // a journal or replaying one.
+
+    /// Returns -1 if this tree can't keep track of its changes, otherwise the ID of a journal that does from now on
+    virtual int startChangeJournal() { return -1; }
+
+    /// Snapshots everything that changed since the journal was started or last taken from. Returns NULL if the changes
+    /// were lost (the tree was erased), in which case the whole tree has to be written instead.
+    virtual OctreeSnapshot* takeChangesSnapshot(int journalID) { return NULL; }
+
+    /// Applies the records in journal in order, returns how many bytes of complete records were applied
+    virtual int replayJournal(const QByteArray& journal) { return 0; }
+
+    // about the last snapshot a JSON file was written from
+    quint64 getLastSnapshotTakenAt() const { return _lastSnapshotTakenAt; }
+    quint64 getLastSnapshotLockTime() const { return _lastSnapshotLockTime; } /// usecs the tree was locked to take it
+    quint64 getLastSnapshotAge() const { return _lastSnapshotAge; } /// usecs from taking it to its file being written
+    int getLastSnapshotItemCount() const { return _lastSnapshotItemCount; }
+    qint64 getLastSnapshotMemoryUsage() const { return _lastSnapshotMemoryUsage; }
 
     // Octree importers
     bool readFromFile(const char* filename);
@@ -403,6 +452,12 @@ protected:
     
     bool _isViewing; 
     bool _isServer;
+
+    quint64 _lastSnapshotTakenAt;
+    quint64 _lastSnapshotLockTime;
+    quint64 _lastSnapshotAge;
+    int _lastSnapshotItemCount;
+    qint64 _lastSnapshotMemoryUsage;
 };
 
 float boundaryDistanceForRenderLevel(unsigned int renderLevel, float voxelSizeScale);
@@ -9,11 +9,21 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include "OctreeElementBag.h"
 #include <OctalCode.h>
 
+// how much lower elements outside of the view rank than ones of the same size in it
+const float OUT_OF_VIEW_PRIORITY_SCALE = 0.1f;
+
+// how much higher elements that changed rank than ones of the same size that didn't
+const float CHANGED_PRIORITY_SCALE = 2.0f;
+
 OctreeElementBag::OctreeElementBag() : 
-    _bagElements()
+    _bagElements(),
+    _priorityView(NULL),
+    _changedSince(0)
 {
     OctreeElement::addDeleteHook(this);
     _hooked = true;
@@ -38,16 +48,34 @@ void OctreeElementBag::elementDeleted(OctreeElement* element) {
 
 void OctreeElementBag::deleteAll() {
     _bagElements.clear();
+    _priorityQueue.clear();
 }
 
 
 void OctreeElementBag::insert(OctreeElement* element) {
+    if (_priorityView && !_bagElements.contains(element)) {
+        _priorityQueue.push_back(PrioritizedElement(priorityOf(element), element));
+        std::push_heap(_priorityQueue.begin(), _priorityQueue.end());
+    }
     _bagElements.insert(element);
 }
 
 OctreeElement* OctreeElementBag::extract() {
     OctreeElement* result = NULL;
 
+    if (_priorityView) {
+        // skip over anything that was removed from the bag after it was queued
+        while (!_priorityQueue.empty()) {
+            std::pop_heap(_priorityQueue.begin(), _priorityQueue.end());
+            OctreeElement* element = _priorityQueue.back().second;
+            _priorityQueue.pop_back();
+
+            if (_bagElements.remove(element)) {
+                return element;
+            }
+        }
+    }
+
     if (_bagElements.size() > 0) {
         QSet<OctreeElement*>::iterator front = _bagElements.begin();
         result = *front;
@@ -61,5 +89,41 @@ bool OctreeElementBag::contains(OctreeElement* element) {
 }
 
 void OctreeElementBag::remove(OctreeElement* element) {
-    _bagElements.remove(element);
+    // the element stays queued until it is skipped, but don't let those pile up
+    if (_bagElements.remove(element) && _priorityQueue.size() > 2 * (size_t)_bagElements.size() + 1) {
+        reprioritize();
+    }
+}
+
+void OctreeElementBag::setPriorityView(const ViewFrustum* viewFrustum, quint64 changedSince) {
+    if (viewFrustum != _priorityView || changedSince != _changedSince) {
+        _priorityView = viewFrustum;
+        _changedSince = changedSince;
+        reprioritize();
+    }
+}
+
+void OctreeElementBag::reprioritize() {
+    _priorityQueue.clear();
+    if (_priorityView) {
+        _priorityQueue.reserve(_bagElements.size());
+        foreach (OctreeElement* element, _bagElements) {
+            _priorityQueue.push_back(PrioritizedElement(priorityOf(element), element));
+        }
+        std::make_heap(_priorityQueue.begin(), _priorityQueue.end());
+    }
+}
+
+float OctreeElementBag::priorityOf(const OctreeElement* element) const {
+    // roughly how big the element looks from the view, an element the view is inside of is as big as it gets
+    float scale = element->getScale();
+    float priority = scale / std::max(element->distanceToCamera(*_priorityView), scale);
+
+    if (!element->isInView(*_priorityView)) {
+        priority *= OUT_OF_VIEW_PRIORITY_SCALE;
+    }
+    if (element->getLastChanged() > _changedSince) {
+        priority *= CHANGED_PRIORITY_SCALE;
+    }
+    return priority;
 }
@@ -16,6 +16,9 @@
 #ifndef hifi_OctreeElementBag_h
 #define hifi_OctreeElementBag_h
 
+#include <utility>
+#include <vector>
+
 #include "OctreeElement.h"
 
 class OctreeElementBag : public OctreeElementDeleteHook {
@@ -25,7 +28,7 @@ public:
     ~OctreeElementBag();
     
     void insert(OctreeElement* element); // put a element into the bag
-    OctreeElement* extract(); // pull a element out of the bag (could come in any order)
+    OctreeElement* extract(); // pull a element out of the bag (in any order, unless the bag has a priority view)
     bool contains(OctreeElement* element); // is this element in the bag?
     void remove(OctreeElement* element); // remove a specific element from the bag
     bool isEmpty() const { return _bagElements.isEmpty(); }
@@ -36,9 +39,24 @@ public:
 
     void unhookNotifications();
 
+    /// Once the bag has a view, extract() hands out the elements that look biggest from it first. Elements in view come
+    /// before ones outside of it, and elements changed since changedSince are moved ahead of unchanged ones.
+    void setPriorityView(const ViewFrustum* viewFrustum, quint64 changedSince);
+
+    /// Ranks the elements in the bag again, call this when the priority view has moved
+    void reprioritize();
+
 private:
+    typedef std::pair<float, OctreeElement*> PrioritizedElement;
+
+    float priorityOf(const OctreeElement* element) const;
+
     QSet<OctreeElement*> _bagElements;
     bool _hooked;
+
+    const ViewFrustum* _priorityView;
+    quint64 _changedSince;
+    std::vector<PrioritizedElement> _priorityQueue; // a heap, it can still hold elements removed from the bag since
 };
 
 typedef QMap<const OctreeElement*,void*> OctreeElementExtraEncodeData;
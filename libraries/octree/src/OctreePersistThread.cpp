@@ -9,18 +9,22 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 #include <time.h>
 
+#include <QDataStream>
 #include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include <QScopedPointer>
 
 #include <NumericalConstants.h>
 #include <PerfStat.h>
@@ -31,6 +35,20 @@
 
 const int OctreePersistThread::DEFAULT_PERSIST_INTERVAL = 1000 * 30; // every 30 seconds
 
+const quint32 JOURNAL_FILE_VERSION = 1;
+
+// the whole tree is written out again once the journal is bigger than the persist file and at least this big
+const qint64 MIN_JOURNAL_BYTES_TO_COMPACT = 1024 * 1024;
+
+// replaces toName with fromName in one step, so a reader sees either the old file or the new one
+static bool replaceFile(const QString& fromName, const QString& toName) {
+#ifdef Q_OS_WIN
+    // rename() won't replace an existing file on windows, this is as close as we get
+    QFile::remove(toName);
+#endif
+    return rename(qPrintable(fromName), qPrintable(toName)) == 0;
+}
+
 OctreePersistThread::OctreePersistThread(Octree* tree, const QString& filename, int persistInterval, 
                                          bool wantBackup, const QJsonObject& settings, bool debugTimestampNow,
                                          QString persistAsFileType) :
@@ -43,13 +61,18 @@ OctreePersistThread::OctreePersistThread(Octree* tree, const QString& filename,
     _wantBackup(wantBackup),
     _debugTimestampNow(debugTimestampNow),
     _lastTimeDebug(0),
-    _persistAsFileType(persistAsFileType)
+    _persistAsFileType(persistAsFileType),
+    _journalID(-1),
+    _isJournaling(false),
+    _journalSize(0)
 {
     parseSettings(settings);
 
     // in case the persist filename has an extension that doesn't match the file type
     QString sansExt = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS);
     _filename = sansExt + "." + _persistAsFileType;
+    _tempFilename = sansExt + ".tmp." + _persistAsFileType;
+    _journalFilename = _filename + ".journal";
 }
 
 void OctreePersistThread::parseSettings(const QJsonObject& settings) {
@@ -150,7 +173,15 @@ bool OctreePersistThread::process() {
             }
 
             persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+
+            // then apply whatever was journaled since that file was written
+            bool journalReplayed = replayJournal();
             _tree->pruneTree();
+
+            _journalID = _tree->startChangeJournal();
+            if (canJournal()) {
+                _isJournaling = journalReplayed || resetJournal();
+            }
         }
         _tree->unlock();
 
@@ -232,37 +263,145 @@ void OctreePersistThread::aboutToFinish() {
 }
 
 void OctreePersistThread::persist() {
-    if (_tree->isDirty()) {
-        _tree->lockForWrite();
-        {
-            qCDebug(octree) << "pruning Octree before saving...";
-            _tree->pruneTree();
-            qCDebug(octree) << "DONE pruning Octree before saving...";
+    // a backup has to include what is only in the journal, so a backup that is due forces a full write
+    bool backupIsDue = isBackupDue();
+    bool hasJournaledChanges = _isJournaling && _journalSize > 0;
+    if (!_tree->isDirty() && !(backupIsDue && hasJournaledChanges)) {
+        return;
+    }
+
+    qint64 compactionSize = std::max(QFileInfo(_filename).size(), MIN_JOURNAL_BYTES_TO_COMPACT);
+    if (!backupIsDue && _isJournaling && _journalSize < compactionSize && appendChangesToJournal()) {
+        return;
+    }
+
+    _tree->lockForWrite();
+    {
+        qCDebug(octree) << "pruning Octree before saving...";
+        _tree->pruneTree();
+        qCDebug(octree) << "DONE pruning Octree before saving...";
+
+        // the whole tree is about to be written, so the next journal only needs what changes from here on
+        delete _tree->takeChangesSnapshot(_journalID);
+        _tree->clearDirtyBit(); // edits made while we write will dirty it again
+    }
+    _tree->unlock();
+
+    // write to a temporary file and swap it in, so a save that doesn't finish leaves the last one intact
+    if (_tree->writeToFile(qPrintable(_tempFilename), NULL, _persistAsFileType)
+        && replaceFile(_tempFilename, _filename)) {
+        time(&_lastPersistTime);
+        qCDebug(octree) << "DONE saving Octree to file...";
+
+        if (canJournal()) {
+            _isJournaling = resetJournal();
         }
-        _tree->unlock();
 
         qCDebug(octree) << "persist operation calling backup...";
-        backup(); // handle backup if requested        
+        backup(); // handle backup if requested
         qCDebug(octree) << "persist operation DONE with backup...";
+    } else {
+        qCDebug(octree) << "unable to save" << _filename << "-- keeping the last good file";
+        QFile::remove(_tempFilename);
+        _tree->setDirtyBit(); // try again next time, the journal doesn't have what was just written
+        _isJournaling = false;
+    }
+}
 
+bool OctreePersistThread::isBackupDue() const {
+    if (!_wantBackup) {
+        return false;
+    }
 
-        // create our "lock" file to indicate we're saving.
-        QString lockFileName = _filename + ".lock";
-        std::ofstream lockFile(qPrintable(lockFileName), std::ios::out|std::ios::binary);
-        if(lockFile.is_open()) {
-            qCDebug(octree) << "saving Octree lock file created at:" << lockFileName;
+    quint64 now = usecTimestampNow();
+    const quint64 SECS_TO_USECS = 1000 * 1000;
+    foreach (const BackupRule& rule, _backupRules) {
+        if (rule.maxBackupVersions > 0 && now - rule.lastBackup > rule.interval * SECS_TO_USECS) {
+            return true;
+        }
+    }
+    return false;
+}
 
-            _tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType);
-            time(&_lastPersistTime);
-            _tree->clearDirtyBit(); // tree is clean after saving
-            qCDebug(octree) << "DONE saving Octree to file...";
+bool OctreePersistThread::appendChangesToJournal() {
+    // the lock is only held while the changed items are copied
+    _tree->lockForRead();
+    QScopedPointer<OctreeSnapshot> changes(_tree->takeChangesSnapshot(_journalID));
+    _tree->clearDirtyBit();
+    _tree->unlock();
 
-            lockFile.close();
-            qCDebug(octree) << "saving Octree lock file closed:" << lockFileName;
-            remove(qPrintable(lockFileName));
-            qCDebug(octree) << "saving Octree lock file removed:" << lockFileName;
-        }
+    if (!changes) {
+        return false;
+    }
+
+    QByteArray journal;
+    changes->writeToJournal(journal);
+
+    QFile journalFile(_journalFilename);
+    if (!journalFile.open(QIODevice::WriteOnly | QIODevice::Append) || journalFile.write(journal) != journal.size()) {
+        qCDebug(octree) << "unable to append to journal" << _journalFilename << "-- writing the whole tree instead";
+        _isJournaling = false;
+        return false;
+    }
+    journalFile.close();
+
+    _journalSize += journal.size();
+    time(&_lastPersistTime);
+    qCDebug(octree) << "journaled" << changes->getItemCount() << "changes," << _journalSize << "bytes since last save";
+    return true;
+}
+
+qint64 OctreePersistThread::getPersistFileModifiedTime() const {
+    QFileInfo persistFileInfo(_filename);
+    return persistFileInfo.exists() ? persistFileInfo.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+bool OctreePersistThread::replayJournal() {
+    QFile journalFile(_journalFilename);
+    if (!journalFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // the journal is only good for the persist file that was current when it was started
+    quint32 version;
+    qint64 persistFileModifiedTime;
+    QDataStream headerStream(&journalFile);
+    headerStream >> version >> persistFileModifiedTime;
+    if (headerStream.status() != QDataStream::Ok || version != JOURNAL_FILE_VERSION
+        || persistFileModifiedTime != getPersistFileModifiedTime()) {
+        qCDebug(octree) << "Ignoring journal" << _journalFilename << "it doesn't follow" << _filename;
+        return false;
+    }
+
+    qint64 headerSize = journalFile.pos();
+    QByteArray journal = journalFile.readAll();
+    journalFile.close();
+
+    int bytesReplayed = _tree->replayJournal(journal);
+    qCDebug(octree) << "Replayed" << bytesReplayed << "bytes of journal" << _journalFilename;
+
+    if (bytesReplayed < journal.size()) {
+        // drop the record that was cut short, so new records follow the complete ones
+        QFile::resize(_journalFilename, headerSize + bytesReplayed);
+    }
+    _journalSize = bytesReplayed;
+    return true;
+}
+
+bool OctreePersistThread::resetJournal() {
+    QString tempJournalFilename = _journalFilename + ".tmp";
+    QFile journalFile(tempJournalFilename);
+    if (!journalFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCDebug(octree) << "unable to start journal" << _journalFilename;
+        return false;
     }
+
+    QDataStream headerStream(&journalFile);
+    headerStream << JOURNAL_FILE_VERSION << getPersistFileModifiedTime();
+    journalFile.close();
+
+    _journalSize = 0;
+    return replaceFile(tempJournalFilename, _journalFilename);
 }
 
 void OctreePersistThread::restoreFromMostRecentBackup() {
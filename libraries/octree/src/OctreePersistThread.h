@@ -50,6 +50,12 @@ protected:
     virtual bool process();
     
     void persist();
+    bool appendChangesToJournal();
+    qint64 getPersistFileModifiedTime() const;
+    bool replayJournal(); /// the caller must hold the tree lock for writing
+    bool resetJournal();
+    bool canJournal() const { return _journalID >= 0; }
+    bool isBackupDue() const;
     void backup();
     void rollOldBackupVersions(const BackupRule& rule);
     void restoreFromMostRecentBackup();
@@ -74,6 +80,13 @@ private:
     quint64 _lastTimeDebug;
 
     QString _persistAsFileType;
+
+    // between full writes, the changes made to the tree are appended to a journal that follows the persist file
+    QString _tempFilename;
+    QString _journalFilename;
+    int _journalID; // -1 if the tree can't journal its changes
+    bool _isJournaling;
+    qint64 _journalSize; // bytes of records in the journal
 };
 
 #endif // hifi_OctreePersistThread_h
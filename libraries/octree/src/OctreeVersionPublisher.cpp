@@ -0,0 +1,230 @@
+//
+//  OctreeVersionPublisher.cpp
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QMutexLocker>
+#include <QScopedPointer>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "OctreeLogging.h"
+#include "OctreeVersionPublisher.h"
+
+const quint64 PUBLISH_INTERVAL_USECS = 100 * USECS_PER_MSEC;
+
+// how long a newer version waits before readers of an older one are told to move on, this bounds how long the
+// publisher can be kept from reusing the older copy
+const quint64 MAX_OUTDATED_VERSION_USECS = 2 * USECS_PER_SECOND;
+
+OctreeVersion::OctreeVersion(Octree* tree) :
+    _tree(tree),
+    _number(0),
+    _takenAt(0),
+    _publishedAt(0),
+    _elementCount(0),
+    _numReaders(0),
+    _needsWholeTree(true)
+{
+}
+
+OctreeVersion::~OctreeVersion() {
+    delete _tree;
+}
+
+OctreeVersionPublisher::OctreeVersionPublisher(Octree* tree, const QVector<Octree*>& copies) :
+    _tree(tree),
+    _latest(NULL),
+    _isEnabled(true),
+    _journalID(-1),
+    _nextVersionNumber(1),
+    _lastChangesTakenAt(0),
+    _hasUnpublishedChanges(false),
+    _publishCount(0),
+    _busySkipCount(0),
+    _lastLockTime(0),
+    _lastPublishTime(0)
+{
+    foreach (Octree* copy, copies) {
+        _versions << new OctreeVersion(copy);
+    }
+}
+
+OctreeVersionPublisher::~OctreeVersionPublisher() {
+    foreach (OctreeVersion* version, _versions) {
+        if (version->_numReaders > 0) {
+            qCDebug(octree) << "deleting version" << version->_number << "while it still has readers";
+        }
+        delete version;
+    }
+}
+
+OctreeVersion* OctreeVersionPublisher::acquireLatest() {
+    QMutexLocker locker(&_versionsMutex);
+    if (_latest) {
+        _latest->_numReaders++;
+    }
+    return _latest;
+}
+
+void OctreeVersionPublisher::release(OctreeVersion* version) {
+    if (version) {
+        QMutexLocker locker(&_versionsMutex);
+        version->_numReaders--;
+    }
+}
+
+bool OctreeVersionPublisher::isOutdated(const OctreeVersion* version) {
+    QMutexLocker locker(&_versionsMutex);
+    return version != _latest && usecTimestampNow() - _latest->_publishedAt > MAX_OUTDATED_VERSION_USECS;
+}
+
+bool OctreeVersionPublisher::process() {
+    if (isStillRunning()) {
+        usleep(PUBLISH_INTERVAL_USECS);
+        publish();
+    }
+    return isStillRunning() && _isEnabled; // keep running till they terminate us
+}
+
+bool OctreeVersionPublisher::takeChanges() {
+    quint64 lockStart = usecTimestampNow();
+    QScopedPointer<OctreeSnapshot> changes;
+    bool isWholeTree = false;
+
+    if (_journalID < 0) {
+        // the first time, the copies start from the whole tree and follow its journal from then on
+        _tree->lockForWrite();
+        _journalID = _tree->startChangeJournal();
+        if (_journalID >= 0) {
+            changes.reset(_tree->takeSnapshot(NULL));
+            isWholeTree = true;
+        }
+    } else {
+        _tree->lockForRead();
+        changes.reset(_tree->takeChangesSnapshot(_journalID));
+        if (!changes) {
+            // the tree was erased, so the copies have to start over from the whole tree
+            changes.reset(_tree->takeSnapshot(NULL));
+            isWholeTree = true;
+        }
+    }
+    _tree->unlock();
+    _lastLockTime = usecTimestampNow() - lockStart;
+
+    if (_journalID < 0) {
+        qCDebug(octree) << "tree can't journal its changes, no versions will be published";
+        _isEnabled = false;
+        return false;
+    }
+
+    QByteArray records;
+    changes->writeToJournal(records);
+    if (records.isEmpty() && !isWholeTree) {
+        return false;
+    }
+
+    // every copy but the one that gets updated next has to hold on to these until its turn
+    QMutexLocker locker(&_versionsMutex);
+    foreach (OctreeVersion* version, _versions) {
+        if (isWholeTree) {
+            version->_pendingChanges.clear();
+            version->_needsWholeTree = true;
+        }
+        version->_pendingChanges.append(records);
+    }
+    _lastChangesTakenAt = changes->getTakenAt();
+    _hasUnpublishedChanges = true;
+    return true;
+}
+
+void OctreeVersionPublisher::updateCopy(OctreeVersion* version) {
+    // nobody can acquire a version that isn't the latest, so the copy is ours until it's published
+    Octree* copy = version->_tree;
+    copy->lockForWrite();
+    if (version->_needsWholeTree) {
+        copy->eraseAllOctreeElements();
+    }
+    copy->replayJournal(version->_pendingChanges);
+    copy->pruneTree();
+    unsigned long elementCount = copy->getOctreeElementsCount();
+    copy->unlock();
+
+    QMutexLocker locker(&_versionsMutex);
+    version->_pendingChanges.clear();
+    version->_needsWholeTree = false;
+    version->_number = _nextVersionNumber++;
+    version->_takenAt = _lastChangesTakenAt;
+    version->_publishedAt = usecTimestampNow();
+    version->_elementCount = elementCount;
+    _latest = version;
+}
+
+bool OctreeVersionPublisher::publish() {
+    if (!_isEnabled) {
+        return false;
+    }
+
+    takeChanges();
+    if (!_hasUnpublishedChanges) {
+        return false;
+    }
+
+    OctreeVersion* versionToUpdate = NULL;
+    {
+        QMutexLocker locker(&_versionsMutex);
+        foreach (OctreeVersion* version, _versions) {
+            if (version != _latest && version->_numReaders == 0) {
+                versionToUpdate = version;
+                break;
+            }
+        }
+    }
+    if (!versionToUpdate) {
+        // the changes keep piling up in the copies until readers move on from the older ones
+        _busySkipCount++;
+        return false;
+    }
+
+    quint64 publishStart = usecTimestampNow();
+    updateCopy(versionToUpdate);
+    _lastPublishTime = usecTimestampNow() - publishStart;
+
+    _hasUnpublishedChanges = false;
+    _publishCount++;
+    return true;
+}
+
+int OctreeVersionPublisher::getLatestVersionNumber() {
+    QMutexLocker locker(&_versionsMutex);
+    return _latest ? _latest->_number : 0;
+}
+
+quint64 OctreeVersionPublisher::getLatestVersionTakenAt() {
+    QMutexLocker locker(&_versionsMutex);
+    return _latest ? _latest->_takenAt : 0;
+}
+
+unsigned long OctreeVersionPublisher::getCopiesElementCount() {
+    QMutexLocker locker(&_versionsMutex);
+    unsigned long elementCount = 0;
+    foreach (OctreeVersion* version, _versions) {
+        elementCount += version->_elementCount;
+    }
+    return elementCount;
+}
+
+qint64 OctreeVersionPublisher::getPendingChangesSize() {
+    QMutexLocker locker(&_versionsMutex);
+    qint64 pendingChangesSize = 0;
+    foreach (OctreeVersion* version, _versions) {
+        pendingChangesSize += version->_pendingChanges.size();
+    }
+    return pendingChangesSize;
+}
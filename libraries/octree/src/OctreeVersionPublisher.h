@@ -0,0 +1,110 @@
+//
+//  OctreeVersionPublisher.h
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Keeps read-only copies of a tree up to date from its change journal, so senders can encode from a version that
+//  edits never touch
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeVersionPublisher_h
+#define hifi_OctreeVersionPublisher_h
+
+#include <QMutex>
+#include <QVector>
+
+#include <GenericThread.h>
+
+#include "Octree.h"
+
+/// One published copy of a tree. Its content and fields don't change while anyone holds it.
+class OctreeVersion {
+public:
+    OctreeVersion(Octree* tree);
+    ~OctreeVersion();
+
+    Octree* getTree() const { return _tree; }
+    int getNumber() const { return _number; }
+    quint64 getTakenAt() const { return _takenAt; } /// when the live tree looked like this copy
+    quint64 getPublishedAt() const { return _publishedAt; }
+    unsigned long getElementCount() const { return _elementCount; }
+
+private:
+    friend class OctreeVersionPublisher;
+
+    Octree* _tree;
+    int _number;
+    quint64 _takenAt;
+    quint64 _publishedAt;
+    unsigned long _elementCount;
+
+    int _numReaders; // guarded by the publisher's mutex
+    QByteArray _pendingChanges; // journal records the copy hasn't had replayed yet
+    bool _needsWholeTree; // the pending changes start from an empty tree
+};
+
+/// Publishes versions of a tree that can journal its changes. Writers never wait on readers: the live tree is only
+/// locked long enough to take what changed, and the changes are replayed into a copy that nobody is reading. A reader
+/// acquires the latest version and releases it when it's done, which it should do as soon as the version is outdated.
+class OctreeVersionPublisher : public GenericThread {
+    Q_OBJECT
+public:
+    /// copies must be empty trees of the same type as tree, the publisher owns them. Two are enough for readers that
+    /// move to the latest version regularly.
+    OctreeVersionPublisher(Octree* tree, const QVector<Octree*>& copies);
+    virtual ~OctreeVersionPublisher();
+
+    /// false if the tree can't journal its changes, in which case nothing is ever published
+    bool isEnabled() const { return _isEnabled; }
+
+    /// Returns the latest version, which has to be given back to release(), or NULL if none is published yet
+    OctreeVersion* acquireLatest();
+    void release(OctreeVersion* version);
+
+    /// true once a newer version has been waiting long enough that whoever holds this one should move on
+    bool isOutdated(const OctreeVersion* version);
+
+    /// Brings a copy up to date with the tree and makes it the latest version, returns false if there were no changes
+    /// or every copy was being read
+    bool publish();
+
+    // stats
+    int getLatestVersionNumber();
+    quint64 getLatestVersionTakenAt();
+    int getPublishCount() const { return _publishCount; }
+    int getBusySkipCount() const { return _busySkipCount; } /// publishes skipped since every copy was being read
+    quint64 getLastLockTime() const { return _lastLockTime; } /// usecs the tree was locked to take its changes
+    quint64 getLastPublishTime() const { return _lastPublishTime; } /// usecs to replay the changes into a copy
+    unsigned long getCopiesElementCount(); /// elements held by the copies
+    qint64 getPendingChangesSize(); /// bytes of changes waiting for copies to be free
+
+protected:
+    /// Implements generic processing behavior for this thread.
+    virtual bool process();
+
+private:
+    bool takeChanges();
+    void updateCopy(OctreeVersion* version);
+
+    Octree* _tree;
+    QVector<OctreeVersion*> _versions;
+    OctreeVersion* _latest; // guarded by _versionsMutex, along with each version's reader count
+    QMutex _versionsMutex;
+
+    bool _isEnabled;
+    int _journalID;
+    int _nextVersionNumber;
+    quint64 _lastChangesTakenAt;
+    bool _hasUnpublishedChanges;
+
+    int _publishCount;
+    int _busySkipCount;
+    quint64 _lastLockTime;
+    quint64 _lastPublishTime;
+};
+
+#endif // hifi_OctreeVersionPublisher_h
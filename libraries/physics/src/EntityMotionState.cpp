@@ -332,7 +332,7 @@ bool EntityMotionState::shouldSendUpdate(uint32_t simulationStep, const QUuid& s
     return false;
 }
 
-void EntityMotionState::sendUpdate(OctreeEditPacketSender* packetSender, const QUuid& sessionID, uint32_t step) {
+EntityItemProperties EntityMotionState::prepareUpdate(const QUuid& sessionID, uint32_t step) {
     assert(_entity);
 
     bool active = _body->isActive();
@@ -405,7 +405,7 @@ void EntityMotionState::sendUpdate(OctreeEditPacketSender* packetSender, const Q
 
     #ifdef WANT_DEBUG
         quint64 now = usecTimestampNow();
-        qCDebug(physics) << "EntityMotionState::sendUpdate()";
+        qCDebug(physics) << "EntityMotionState::prepareUpdate()";
         qCDebug(physics) << "        EntityItemId:" << _entity->getEntityItemID()
                          << "---------------------------------------------";
         qCDebug(physics) << "       lastSimulated:" << debugTime(lastSimulated, now);
@@ -426,6 +426,13 @@ void EntityMotionState::sendUpdate(OctreeEditPacketSender* packetSender, const Q
         properties.setSimulatorID(sessionID);
     }
 
+    _lastStep = step;
+    return properties;
+}
+
+void EntityMotionState::sendUpdate(OctreeEditPacketSender* packetSender, const QUuid& sessionID, uint32_t step) {
+    EntityItemProperties properties = prepareUpdate(sessionID, step);
+
     if (EntityItem::getSendPhysicsUpdates()) {
         EntityItemID id(_entity->getID());
         EntityEditPacketSender* entityPacketSender = static_cast<EntityEditPacketSender*>(packetSender);
@@ -440,8 +447,6 @@ void EntityMotionState::sendUpdate(OctreeEditPacketSender* packetSender, const Q
             qCDebug(physics) << "EntityMotionState::sendUpdate()... NOT sending update as requested.";
         #endif
     }
-
-    _lastStep = step;
 }
 
 uint32_t EntityMotionState::getAndClearIncomingDirtyFlags() const { 
@@ -48,6 +48,9 @@ public:
     bool isCandidateForOwnership(const QUuid& sessionID) const;
     bool remoteSimulationOutOfSync(uint32_t simulationStep);
     bool shouldSendUpdate(uint32_t simulationStep, const QUuid& sessionID);
+
+    /// settles the entity's outgoing physics properties and returns them flagged for packing
+    EntityItemProperties prepareUpdate(const QUuid& sessionID, uint32_t step);
     void sendUpdate(OctreeEditPacketSender* packetSender, const QUuid& sessionID, uint32_t step);
 
     virtual uint32_t getAndClearIncomingDirtyFlags() const;
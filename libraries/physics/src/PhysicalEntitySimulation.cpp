@@ -36,7 +36,7 @@ void PhysicalEntitySimulation::init(
     assert(shapeManager);
     _shapeManager = shapeManager;
 
-    assert(packetSender);
+    // without a packetSender we're simulating the entity server's own tree, see handleOutgoingChanges()
     _entityPacketSender = packetSender;
 }
 
@@ -215,18 +215,30 @@ void PhysicalEntitySimulation::handleOutgoingChanges(VectorOfMotionStates& motio
         }
 
         // send outgoing packets
+        QVector<EntityMotionState*> statesToApply;
         QSet<EntityMotionState*>::iterator stateItr = _outgoingChanges.begin();
         while (stateItr != _outgoingChanges.end()) {
             EntityMotionState* state = *stateItr;
             if (!state->isCandidateForOwnership(sessionID)) {
                 stateItr = _outgoingChanges.erase(stateItr);
             } else if (state->shouldSendUpdate(numSubsteps, sessionID)) {
-                state->sendUpdate(_entityPacketSender, sessionID, numSubsteps);
+                if (_entityPacketSender) {
+                    state->sendUpdate(_entityPacketSender, sessionID, numSubsteps);
+                } else {
+                    statesToApply.push_back(state);
+                }
                 ++stateItr;
             } else {
                 ++stateItr;
             }
         }
+
+        // the entity server's tree is the authority, so rather than sending edits we apply them as the server's
+        // own edits which go out to every node with the next entity data packets
+        foreach (EntityMotionState* state, statesToApply) {
+            EntityItemProperties properties = state->prepareUpdate(sessionID, numSubsteps);
+            _entityTree->updateEntity(state->getEntity(), properties);
+        }
     }
 }
 
@@ -33,6 +33,8 @@ public:
     PhysicalEntitySimulation();
     ~PhysicalEntitySimulation();
 
+    /// Without a packetSender outgoing changes are applied to the tree itself, which is how the entity server
+    /// simulates physics. handleOutgoingChanges() must then be called with the tree locked for write.
     void init(EntityTree* tree, PhysicsEngine* engine, ShapeManager* shapeManager, EntityEditPacketSender* packetSender);
 
 protected: // only called by EntitySimulation
@@ -54,6 +54,14 @@ void PhysicsEngine::init() {
         // default gravity of the world is zero, so each object must specify its own gravity
         // TODO: set up gravity zones
         _dynamicsWorld->setGravity(btVector3(0.0f, 0.0f, 0.0f));
+        _dynamicsWorld->setNumSynchronizeThreads(_numSynchronizeThreads);
+    }
+}
+
+void PhysicsEngine::setNumSynchronizeThreads(int numThreads) {
+    _numSynchronizeThreads = numThreads;
+    if (_dynamicsWorld) {
+        _dynamicsWorld->setNumSynchronizeThreads(numThreads);
     }
 }
 
@@ -93,6 +93,9 @@ public:
 
     void dumpNextStats() { _dumpNextStats = true; }
 
+    /// \param numThreads how many threads synchronize the MotionStates of active bodies, 1 keeps it on our thread
+    void setNumSynchronizeThreads(int numThreads);
+
     static bool physicsInfoIsActive(void* physicsInfo);
     static bool getBodyLocation(void* physicsInfo, glm::vec3& positionReturn, glm::quat& rotationReturn);
 
@@ -120,6 +123,7 @@ private:
 
     bool _dumpNextStats = false;
     bool _hasOutgoingChanges = false;
+    int _numSynchronizeThreads = 1;
 
     QUuid _sessionID;
     CollisionEvents _collisionEvents;
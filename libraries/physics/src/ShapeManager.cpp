@@ -43,9 +43,20 @@ btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
     DoubleHashKey key = info.getHash();
     ShapeReference* shapeRef = _shapeMap.find(key);
     if (shapeRef) {
+        if (shapeRef->refCount == 0) {
+            // the shape was waiting to be collected, it's wanted again so it's no longer garbage
+            for (int i = 0; i < _pendingGarbage.size(); ++i) {
+                if (_pendingGarbage[i].equals(key)) {
+                    removePendingGarbageAt(i);
+                    break;
+                }
+            }
+        }
         shapeRef->refCount++;
+        _numHits++;
         return shapeRef->shape;
     }
+    _numMisses++;
     btCollisionShape* shape = ShapeInfoUtil::createShapeFromInfo(info);
     if (shape) {
         ShapeReference newRef;
@@ -64,10 +75,12 @@ bool ShapeManager::releaseShape(const DoubleHashKey& key) {
         if (shapeRef->refCount > 0) {
             shapeRef->refCount--;
             if (shapeRef->refCount == 0) {
+                // keep the most recently released shapes around, the same models tend to be added again
                 _pendingGarbage.push_back(key);
                 const int MAX_GARBAGE_CAPACITY = 127;
                 if (_pendingGarbage.size() > MAX_GARBAGE_CAPACITY) {
-                    collectGarbage();
+                    deleteShape(_pendingGarbage[0]);
+                    removePendingGarbageAt(0);
                 }
             }
             return true;
@@ -100,24 +113,38 @@ bool ShapeManager::releaseShape(const btCollisionShape* shape) {
 void ShapeManager::collectGarbage() {
     int numShapes = _pendingGarbage.size();
     for (int i = 0; i < numShapes; ++i) {
-        DoubleHashKey& key = _pendingGarbage[i];
-        ShapeReference* shapeRef = _shapeMap.find(key);
-        if (shapeRef && shapeRef->refCount == 0) {
-            // if the shape we're about to delete is compound, delete the children first.
-            if (shapeRef->shape->getShapeType() == COMPOUND_SHAPE_PROXYTYPE) {
-                const btCompoundShape* compoundShape = static_cast<const btCompoundShape*>(shapeRef->shape);
-                const int numChildShapes = compoundShape->getNumChildShapes();
-                for (int i = 0; i < numChildShapes; i ++) {
-                    const btCollisionShape* childShape = compoundShape->getChildShape(i);
-                    delete childShape;
-                }
-            }
+        deleteShape(_pendingGarbage[i]);
+    }
+    _pendingGarbage.clear();
+}
 
-            delete shapeRef->shape;
-            _shapeMap.remove(key);
+// private helper method
+void ShapeManager::deleteShape(const DoubleHashKey& key) {
+    ShapeReference* shapeRef = _shapeMap.find(key);
+    if (shapeRef && shapeRef->refCount == 0) {
+        // if the shape we're about to delete is compound, delete the children first.
+        if (shapeRef->shape->getShapeType() == COMPOUND_SHAPE_PROXYTYPE) {
+            const btCompoundShape* compoundShape = static_cast<const btCompoundShape*>(shapeRef->shape);
+            const int numChildShapes = compoundShape->getNumChildShapes();
+            for (int i = 0; i < numChildShapes; i ++) {
+                const btCollisionShape* childShape = compoundShape->getChildShape(i);
+                delete childShape;
+            }
         }
+
+        delete shapeRef->shape;
+        _shapeMap.remove(key);
     }
-    _pendingGarbage.clear();
+}
+
+// private helper method
+void ShapeManager::removePendingGarbageAt(int index) {
+    // keep the order of release, the array is short
+    int last = _pendingGarbage.size() - 1;
+    for (int i = index; i < last; ++i) {
+        _pendingGarbage[i] = _pendingGarbage[i + 1];
+    }
+    _pendingGarbage.pop_back();
 }
 
 int ShapeManager::getNumReferences(const ShapeInfo& info) const {
@@ -41,8 +41,19 @@ public:
     int getNumReferences(const btCollisionShape* shape) const;
     bool hasShape(const btCollisionShape* shape) const; 
 
+    /// \return number of shapes with zero references that are kept around in case they are wanted again
+    int getNumUnreferencedShapes() const { return _pendingGarbage.size(); }
+
+    /// \return number of getShape() calls answered with a shape we already had
+    quint64 getNumHits() const { return _numHits; }
+
+    /// \return number of getShape() calls that had to build a new shape
+    quint64 getNumMisses() const { return _numMisses; }
+
 private:
     bool releaseShape(const DoubleHashKey& key);
+    void deleteShape(const DoubleHashKey& key);
+    void removePendingGarbageAt(int index);
 
     struct ShapeReference {
         int refCount;
@@ -52,7 +63,10 @@ private:
     };
 
     btHashMap<DoubleHashKey, ShapeReference> _shapeMap;
-    btAlignedObjectArray<DoubleHashKey> _pendingGarbage;
+    btAlignedObjectArray<DoubleHashKey> _pendingGarbage; // unreferenced shapes, least recently released first
+
+    quint64 _numHits = 0;
+    quint64 _numMisses = 0;
 };
 
 #endif // hifi_ShapeManager_h
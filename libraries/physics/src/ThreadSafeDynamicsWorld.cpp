@@ -15,11 +15,29 @@
  * Copied and modified from btDiscreteDynamicsWorld.cpp by AndrewMeadows on 2014.11.12.
  * */
 
+#include <algorithm>
+
+#include <QRunnable>
+#include <QThreadPool>
+
 #include <LinearMath/btQuickprof.h>
 
 #include "ObjectMotionState.h"
 #include "ThreadSafeDynamicsWorld.h"
 
+// below this many bodies per thread handing the work out costs more than it saves
+const int MIN_BODIES_PER_SYNCHRONIZE_TASK = 256;
+
+class ThreadSafeDynamicsWorld::SynchronizeTask : public QRunnable {
+public:
+    SynchronizeTask(ThreadSafeDynamicsWorld* world, int begin, int end) : _world(world), _begin(begin), _end(end) { }
+    virtual void run() { _world->synchronizeActiveMotionStates(_begin, _end); }
+private:
+    ThreadSafeDynamicsWorld* _world;
+    int _begin;
+    int _end;
+};
+
 ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
         btDispatcher* dispatcher,
         btBroadphaseInterface* pairCache,
@@ -28,6 +46,24 @@ ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
     :   btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration) {
 }
 
+ThreadSafeDynamicsWorld::~ThreadSafeDynamicsWorld() {
+    delete _synchronizePool;
+}
+
+void ThreadSafeDynamicsWorld::setNumSynchronizeThreads(int numThreads) {
+    _numSynchronizeThreads = std::max(numThreads, 1);
+    if (_numSynchronizeThreads > 1) {
+        if (!_synchronizePool) {
+            _synchronizePool = new QThreadPool();
+        }
+        // the calling thread takes a share of the bodies itself
+        _synchronizePool->setMaxThreadCount(_numSynchronizeThreads - 1);
+    } else {
+        delete _synchronizePool;
+        _synchronizePool = nullptr;
+    }
+}
+
 int ThreadSafeDynamicsWorld::stepSimulation( btScalar timeStep, int maxSubSteps, btScalar fixedTimeStep) {
     BT_PROFILE("stepSimulation");
     int subSteps = 0;
@@ -101,6 +137,26 @@ void ThreadSafeDynamicsWorld::synchronizeMotionStates() {
                 }
             }
         }
+    } else if (_synchronizePool && m_nonStaticRigidBodies.size() >= 2 * MIN_BODIES_PER_SYNCHRONIZE_TASK) {
+        // each body's MotionState only touches its own object, so the bodies can be split between threads as long
+        // as the changed list comes out in the same order as the serial loop below would make it
+        int numBodies = m_nonStaticRigidBodies.size();
+        int numTasks = std::min(_numSynchronizeThreads, numBodies / MIN_BODIES_PER_SYNCHRONIZE_TASK);
+        _synchronizedStates.resize(numBodies);
+
+        // the pool deletes the tasks it runs, the first share is done right here
+        for (int i = 1; i < numTasks; i++) {
+            _synchronizePool->start(new SynchronizeTask(this, (i * numBodies) / numTasks,
+                                                        ((i + 1) * numBodies) / numTasks));
+        }
+        synchronizeActiveMotionStates(0, numBodies / numTasks);
+        _synchronizePool->waitForDone();
+
+        for (int i = 0; i < numBodies; i++) {
+            if (_synchronizedStates[i]) {
+                _changedMotionStates.push_back(_synchronizedStates[i]);
+            }
+        }
     } else  {       
         //iterate over all active rigid bodies
         for (int i=0;i<m_nonStaticRigidBodies.size();i++) {
@@ -113,5 +169,17 @@ void ThreadSafeDynamicsWorld::synchronizeMotionStates() {
             }
         }
     }   
+}
+
+void ThreadSafeDynamicsWorld::synchronizeActiveMotionStates(int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        btRigidBody* body = m_nonStaticRigidBodies[i];
+        ObjectMotionState* motionState = NULL;
+        if (body->isActive() && body->getMotionState()) {
+            synchronizeSingleMotionState(body);
+            motionState = static_cast<ObjectMotionState*>(body->getMotionState());
+        }
+        _synchronizedStates[i] = motionState;
+    }
 }       
 
@@ -18,11 +18,15 @@
 #ifndef hifi_ThreadSafeDynamicsWorld_h
 #define hifi_ThreadSafeDynamicsWorld_h
 
+#include <vector>
+
 #include <BulletDynamics/Dynamics/btRigidBody.h>
 #include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
 
 #include "PhysicsTypedefs.h"
 
+class QThreadPool;
+
 ATTRIBUTE_ALIGNED16(class) ThreadSafeDynamicsWorld : public btDiscreteDynamicsWorld {
 public:
     BT_DECLARE_ALIGNED_ALLOCATOR();
@@ -32,6 +36,7 @@ public:
             btBroadphaseInterface* pairCache,
             btConstraintSolver* constraintSolver,
             btCollisionConfiguration* collisionConfiguration);
+    ~ThreadSafeDynamicsWorld();
 
     // virtual overrides from btDiscreteDynamicsWorld
     int stepSimulation( btScalar timeStep, int maxSubSteps=1, btScalar fixedTimeStep=btScalar(1.)/btScalar(60.));
@@ -44,8 +49,21 @@ public:
 
     VectorOfMotionStates& getChangedMotionStates() { return _changedMotionStates; }
 
+    /// With more than one thread synchronizeMotionStates() splits the active bodies of big scenes across that many
+    /// threads. The default of one keeps all of it on the calling thread, which is what tests should use.
+    void setNumSynchronizeThreads(int numThreads);
+    int getNumSynchronizeThreads() const { return _numSynchronizeThreads; }
+
 private:
+    class SynchronizeTask;
+
+    void synchronizeActiveMotionStates(int begin, int end);
+
     VectorOfMotionStates _changedMotionStates;
+
+    int _numSynchronizeThreads = 1;
+    QThreadPool* _synchronizePool = nullptr;
+    std::vector<ObjectMotionState*> _synchronizedStates; // one slot per non-static body, filled by parallel synchronizes
 };
 
 #endif // hifi_ThreadSafeDynamicsWorld_h
@@ -17,6 +17,7 @@
 #include <QtNetwork/QNetworkReply>
 #include <QScriptEngine>
 
+#include <AudioCodec.h>
 #include <AudioConstants.h>
 #include <AudioEffectOptions.h>
 #include <AvatarData.h>
@@ -559,6 +560,9 @@ void ScriptEngine::run() {
                     glm::quat headOrientation = _avatarData->getHeadOrientation();
                     packetStream.writeRawData(reinterpret_cast<const char*>(&headOrientation), sizeof(glm::quat));
 
+                    // the codec we want mixed audio in
+                    packetStream << (quint8)AudioCodec::DEFAULT_CODEC;
+
                 } else if (nextSoundOutput) {
                     // assume scripted avatar audio is mono and set channel flag to zero
                     packetStream << (quint8)0;
@@ -568,8 +572,14 @@ void ScriptEngine::run() {
                     glm::quat headOrientation = _avatarData->getHeadOrientation();
                     packetStream.writeRawData(reinterpret_cast<const char*>(&headOrientation), sizeof(glm::quat));
 
-                    // write the raw audio data
-                    packetStream.writeRawData(reinterpret_cast<const char*>(nextSoundOutput), numAvailableSamples * sizeof(int16_t));
+                    // the codec we want mixed audio in
+                    packetStream << (quint8)AudioCodec::DEFAULT_CODEC;
+
+                    // write the encoded audio data
+                    QByteArray encodedFrame(AudioCodec::maxEncodedFrameBytes(numAvailableSamples), 0);
+                    int numEncodedBytes = AudioCodec::encodeFrame(AudioCodec::DEFAULT_CODEC, nextSoundOutput,
+                                                                  numAvailableSamples, 1, encodedFrame.data());
+                    packetStream.writeRawData(encodedFrame.constData(), numEncodedBytes);
                 }
                 
                 // write audio packet to AudioMixer nodes
@@ -112,6 +112,65 @@ int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatO
     return sizeof(quatParts);
 }
 
+const int SMALLEST_THREE_COMPONENT_BITS = 15;
+const float SMALLEST_THREE_COMPONENT_MAX = (float)((1 << SMALLEST_THREE_COMPONENT_BITS) - 1);
+const float SMALLEST_THREE_COMPONENT_RANGE = 1.0f / sqrtf(2.0f);
+
+int packOrientationQuatToSixBytes(unsigned char* buffer, const glm::quat& quatInput) {
+    glm::quat quatNormalized = glm::normalize(quatInput);
+    float components[4] = { quatNormalized.x, quatNormalized.y, quatNormalized.z, quatNormalized.w };
+
+    int largestIndex = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(components[i]) > fabsf(components[largestIndex])) {
+            largestIndex = i;
+        }
+    }
+
+    // q and -q are the same rotation, flip the quat so that the component we drop is positive
+    float sign = (components[largestIndex] < 0.0f) ? -1.0f : 1.0f;
+
+    quint64 packed = largestIndex;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestIndex) {
+            float normalized = glm::clamp(sign * components[i] / SMALLEST_THREE_COMPONENT_RANGE, -1.0f, 1.0f);
+            quint64 part = (quint64)lrintf((normalized + 1.0f) * 0.5f * SMALLEST_THREE_COMPONENT_MAX);
+            packed = (packed << SMALLEST_THREE_COMPONENT_BITS) | part;
+        }
+    }
+
+    for (int i = 0; i < SMALLEST_THREE_QUAT_BYTES; i++) {
+        buffer[i] = (unsigned char)(packed >> (i * BITS_IN_BYTE));
+    }
+    return SMALLEST_THREE_QUAT_BYTES;
+}
+
+int unpackOrientationQuatFromSixBytes(const unsigned char* buffer, glm::quat& quatOutput) {
+    quint64 packed = 0;
+    for (int i = 0; i < SMALLEST_THREE_QUAT_BYTES; i++) {
+        packed |= (quint64)buffer[i] << (i * BITS_IN_BYTE);
+    }
+
+    const quint64 COMPONENT_MASK = (1 << SMALLEST_THREE_COMPONENT_BITS) - 1;
+    int largestIndex = (int)(packed >> (3 * SMALLEST_THREE_COMPONENT_BITS)) & 3;
+
+    float components[4];
+    float sumOfSquares = 0.0f;
+    int shift = 2 * SMALLEST_THREE_COMPONENT_BITS;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestIndex) {
+            float part = (float)((packed >> shift) & COMPONENT_MASK);
+            components[i] = ((part / SMALLEST_THREE_COMPONENT_MAX) * 2.0f - 1.0f) * SMALLEST_THREE_COMPONENT_RANGE;
+            sumOfSquares += components[i] * components[i];
+            shift -= SMALLEST_THREE_COMPONENT_BITS;
+        }
+    }
+    components[largestIndex] = sqrtf(glm::max(0.0f, 1.0f - sumOfSquares));
+
+    quatOutput = glm::quat(components[3], components[0], components[1], components[2]);
+    return SMALLEST_THREE_QUAT_BYTES;
+}
+
 //  Safe version of glm::eulerAngles; uses the factorization method described in David Eberly's
 //  http://www.geometrictools.com/Documentation/EulerAngles.pdf (via Clyde,
 // https://github.com/threerings/clyde/blob/master/src/main/java/com/threerings/math/Quaternion.java)
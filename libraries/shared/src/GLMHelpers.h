@@ -53,6 +53,13 @@ int unpackFloatAngleFromTwoByte(const uint16_t* byteAnglePointer, float* destina
 int packOrientationQuatToBytes(unsigned char* buffer, const glm::quat& quatInput);
 int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatOutput);
 
+// Smallest three: the largest component of a normalized quat can be rebuilt from the other three, which all lie
+// between -1/sqrt(2) and 1/sqrt(2). We send the index of the largest in two bits and the others in 15 bits each,
+// six bytes in all with slightly better accuracy than packOrientationQuatToBytes
+const int SMALLEST_THREE_QUAT_BYTES = 6;
+int packOrientationQuatToSixBytes(unsigned char* buffer, const glm::quat& quatInput);
+int unpackOrientationQuatFromSixBytes(const unsigned char* buffer, glm::quat& quatOutput);
+
 // Ratios need the be highly accurate when less than 10, but not very accurate above 10, and they
 // are never greater than 1000 to 1, this allows us to encode each component in 16bits
 int packFloatRatioToTwoByte(unsigned char* buffer, float ratio);
@@ -0,0 +1,78 @@
+//
+//  SipHash.cpp
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHash.h"
+
+static inline quint64 rotateLeft(quint64 value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline quint64 readLittleEndian64(const uchar* bytes) {
+    quint64 value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+static inline void writeLittleEndian64(quint64 value, uchar* bytes) {
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = (uchar)(value >> (8 * i));
+    }
+}
+
+static inline void sipRounds(quint64& v0, quint64& v1, quint64& v2, quint64& v3, int numRounds) {
+    for (int i = 0; i < numRounds; i++) {
+        v0 += v1; v1 = rotateLeft(v1, 13); v1 ^= v0; v0 = rotateLeft(v0, 32);
+        v2 += v3; v3 = rotateLeft(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotateLeft(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotateLeft(v1, 17); v1 ^= v2; v2 = rotateLeft(v2, 32);
+    }
+}
+
+const int COMPRESSION_ROUNDS = 2;
+const int FINALIZATION_ROUNDS = 4;
+
+void sipHash128(const char* data, int numBytes, const uchar key[NUM_BYTES_SIPHASH_KEY], uchar hash[NUM_BYTES_SIPHASH_128]) {
+    quint64 k0 = readLittleEndian64(key);
+    quint64 k1 = readLittleEndian64(key + sizeof(quint64));
+
+    quint64 v0 = k0 ^ 0x736f6d6570736575ULL;
+    quint64 v1 = k1 ^ 0x646f72616e646f6dULL ^ 0xee;
+    quint64 v2 = k0 ^ 0x6c7967656e657261ULL;
+    quint64 v3 = k1 ^ 0x7465646279746573ULL;
+
+    const uchar* position = reinterpret_cast<const uchar*>(data);
+    const uchar* blocksEnd = position + (numBytes & ~7);
+
+    for (; position != blocksEnd; position += sizeof(quint64)) {
+        quint64 block = readLittleEndian64(position);
+        v3 ^= block;
+        sipRounds(v0, v1, v2, v3, COMPRESSION_ROUNDS);
+        v0 ^= block;
+    }
+
+    // the last block holds the leftover bytes with the message length in its top byte
+    quint64 lastBlock = (quint64)numBytes << 56;
+    for (int i = (numBytes & 7) - 1; i >= 0; i--) {
+        lastBlock |= (quint64)position[i] << (8 * i);
+    }
+    v3 ^= lastBlock;
+    sipRounds(v0, v1, v2, v3, COMPRESSION_ROUNDS);
+    v0 ^= lastBlock;
+
+    v2 ^= 0xee;
+    sipRounds(v0, v1, v2, v3, FINALIZATION_ROUNDS);
+    writeLittleEndian64(v0 ^ v1 ^ v2 ^ v3, hash);
+
+    v1 ^= 0xdd;
+    sipRounds(v0, v1, v2, v3, FINALIZATION_ROUNDS);
+    writeLittleEndian64(v0 ^ v1 ^ v2 ^ v3, hash + sizeof(quint64));
+}
@@ -0,0 +1,23 @@
+//
+//  SipHash.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SipHash_h
+#define hifi_SipHash_h
+
+#include <QtCore/QtGlobal>
+
+const int NUM_BYTES_SIPHASH_KEY = 16;
+const int NUM_BYTES_SIPHASH_128 = 16;
+
+/// SipHash-2-4 with a 128-bit result (Aumasson and Bernstein), a keyed MAC that costs a fraction of an MD5 on the
+/// short messages we send. Runs straight over data in one pass, so callers never have to copy what they hash.
+void sipHash128(const char* data, int numBytes, const uchar key[NUM_BYTES_SIPHASH_KEY], uchar hash[NUM_BYTES_SIPHASH_128]);
+
+#endif // hifi_SipHash_h
@@ -0,0 +1,134 @@
+//
+//  AudioCodecTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+
+#include <AudioConstants.h>
+#include <SharedUtil.h>
+
+#include "AudioCodecTests.h"
+
+const int NUM_TEST_ITERATIONS = 1000;
+
+static int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+static int16_t decoded[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+static char encoded[AudioCodec::FRAME_HEADER_BYTES + AudioConstants::NETWORK_FRAME_BYTES_STEREO];
+
+enum SignalType {
+    Silence,
+    Tone,
+    Noise,
+    FullScaleSquare,
+    NUM_SIGNAL_TYPES
+};
+
+static void fillSamples(SignalType signal, int numSamples) {
+    float frequency = randFloatInRange(0.01f, 0.2f);
+    for (int i = 0; i < numSamples; i++) {
+        switch (signal) {
+            case Silence:
+                samples[i] = 0;
+                break;
+            case Tone:
+                samples[i] = (int16_t)(8000.0f * sinf(i * frequency)) + randIntInRange(-50, 50);
+                break;
+            case Noise:
+                samples[i] = randIntInRange(AudioConstants::MIN_SAMPLE_VALUE, AudioConstants::MAX_SAMPLE_VALUE);
+                break;
+            default:
+                samples[i] = (i % 2) ? AudioConstants::MAX_SAMPLE_VALUE : AudioConstants::MIN_SAMPLE_VALUE;
+                break;
+        }
+    }
+}
+
+void AudioCodecTests::roundTripTest() {
+    for (int codecID = 0; codecID < AudioCodec::NUM_BUILT_IN_CODECS; codecID++) {
+        for (int T = 0; T < NUM_TEST_ITERATIONS; T++) {
+            SignalType signal = (SignalType)(T % NUM_SIGNAL_TYPES);
+            int numSamples = randIntInRange(0, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+            int numChannels = randIntInRange(1, 2);
+            fillSamples(signal, numSamples);
+
+            int encodedBytes = AudioCodec::encodeFrame(codecID, samples, numSamples, numChannels, encoded);
+            if (encodedBytes > AudioCodec::maxEncodedFrameBytes(numSamples)) {
+                qDebug("roundTripTest failed with %s!  Encoded %d samples into %d bytes",
+                       AudioCodec::getCodec(codecID)->getName(), numSamples, encodedBytes);
+                return;
+            }
+
+            if (AudioCodec::samplesInFrame(encoded, encodedBytes) != numSamples) {
+                qDebug("roundTripTest failed with %s!  Frame claims %d samples, expected %d",
+                       AudioCodec::getCodec(codecID)->getName(), AudioCodec::samplesInFrame(encoded, encodedBytes),
+                       numSamples);
+                return;
+            }
+
+            int decodedBytes = AudioCodec::decodeFrame(encoded, encodedBytes, decoded,
+                                                       AudioConstants::NETWORK_FRAME_SAMPLES_STEREO, numChannels);
+            if (decodedBytes != encodedBytes) {
+                qDebug("roundTripTest failed with %s!  Read %d of %d encoded bytes",
+                       AudioCodec::getCodec(codecID)->getName(), decodedBytes, encodedBytes);
+                return;
+            }
+
+            for (int i = 0; i < numSamples; i++) {
+                if (samples[i] != decoded[i]) {
+                    qDebug("roundTripTest failed with %s at sample %d!  Expected: %d  Actual: %d",
+                           AudioCodec::getCodec(codecID)->getName(), i, samples[i], decoded[i]);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+void AudioCodecTests::compressionTest() {
+    const int numSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+
+    fillSamples(Tone, numSamples);
+    int toneBytes = AudioCodec::encodeFrame(AudioCodec::DeltaRice, samples, numSamples, 2, encoded);
+    if (AudioCodec::codecForFrame(encoded, toneBytes) != AudioCodec::DeltaRice
+        || toneBytes >= AudioConstants::NETWORK_FRAME_BYTES_STEREO) {
+        qDebug("compressionTest failed!  A tone took %d bytes, PCM takes %d", toneBytes,
+               AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+    }
+
+    // white noise can't be compressed, the frame should fall back to PCM instead of growing
+    fillSamples(Noise, numSamples);
+    int noiseBytes = AudioCodec::encodeFrame(AudioCodec::DeltaRice, samples, numSamples, 2, encoded);
+    if (AudioCodec::codecForFrame(encoded, noiseBytes) != AudioCodec::PCM) {
+        qDebug("compressionTest failed!  Noise was not sent as PCM");
+    }
+}
+
+void AudioCodecTests::truncatedFrameTest() {
+    const int numSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+
+    for (int T = 0; T < NUM_TEST_ITERATIONS; T++) {
+        fillSamples((SignalType)(T % NUM_SIGNAL_TYPES), numSamples);
+        int encodedBytes = AudioCodec::encodeFrame(AudioCodec::DeltaRice, samples, numSamples, 2, encoded);
+        int truncatedBytes = randIntInRange(0, encodedBytes - 1);
+
+        // a frame cut short has to be rejected, not read past its end
+        if (AudioCodec::decodeFrame(encoded, truncatedBytes, decoded, numSamples, 2) >= 0) {
+            qDebug("truncatedFrameTest failed!  Decoded a frame cut from %d to %d bytes", encodedBytes, truncatedBytes);
+            return;
+        }
+    }
+}
+
+void AudioCodecTests::runAllTests() {
+    roundTripTest();
+    compressionTest();
+    truncatedFrameTest();
+
+    qDebug() << "PASSED";
+}
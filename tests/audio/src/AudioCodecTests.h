@@ -0,0 +1,25 @@
+//
+//  AudioCodecTests.h
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioCodecTests_h
+#define hifi_AudioCodecTests_h
+
+#include "AudioCodec.h"
+
+namespace AudioCodecTests {
+
+    void runAllTests();
+
+    void roundTripTest();
+    void compressionTest();
+    void truncatedFrameTest();
+};
+
+#endif // hifi_AudioCodecTests_h
@@ -0,0 +1,181 @@
+//
+//  AudioMixKernelsTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+
+#include <AudioConstants.h>
+#include <SharedUtil.h>
+
+#include "AudioMixKernelsTests.h"
+
+// room for a frame plus the extra channel sample the vector kernels add zero to
+const int NUM_TEST_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + 64;
+const int NUM_TEST_ITERATIONS = 1000;
+
+// loud enough to push a good part of the mix bus well past the limiter's knee
+const float MAX_TEST_BUS_SAMPLE = 4.0f;
+
+static int16_t source[NUM_TEST_SAMPLES];
+static float busSource[NUM_TEST_SAMPLES];
+static float expectedBus[NUM_TEST_SAMPLES];
+static float actualBus[NUM_TEST_SAMPLES];
+static int16_t expected[NUM_TEST_SAMPLES];
+static int16_t actual[NUM_TEST_SAMPLES];
+
+static void randomizeBuffers() {
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        source[i] = randIntInRange(AudioConstants::MIN_SAMPLE_VALUE, AudioConstants::MAX_SAMPLE_VALUE);
+        busSource[i] = randFloatInRange(-MAX_TEST_BUS_SAMPLE, MAX_TEST_BUS_SAMPLE);
+        expectedBus[i] = actualBus[i] = randFloatInRange(-MAX_TEST_BUS_SAMPLE, MAX_TEST_BUS_SAMPLE);
+    }
+}
+
+static bool busesMatch(const char* testName, AudioMixKernels::InstructionSet instructionSet) {
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        if (expectedBus[i] != actualBus[i]) {
+            qDebug("%s failed with %s kernels at sample %d!  Expected: %f  Actual: %f", testName,
+                   AudioMixKernels::getInstructionSetName(instructionSet), i, expectedBus[i], actualBus[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool samplesMatch(const char* testName, AudioMixKernels::InstructionSet instructionSet, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        if (expected[i] != actual[i]) {
+            qDebug("%s failed with %s kernels at sample %d!  Expected: %d  Actual: %d", testName,
+                   AudioMixKernels::getInstructionSetName(instructionSet), i, expected[i], actual[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+void AudioMixKernelsTests::monoToStereoChannelTest() {
+    for (int set = AudioMixKernels::Scalar; set <= AudioMixKernels::getSupportedInstructionSet(); set++) {
+        AudioMixKernels::InstructionSet instructionSet = (AudioMixKernels::InstructionSet) set;
+        AudioMixKernels::setInstructionSet(instructionSet);
+
+        for (int T = 0; T < NUM_TEST_ITERATIONS; T++) {
+            randomizeBuffers();
+            int numSamples = randIntInRange(0, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+            int channel = randIntInRange(0, 1);
+            float gain = randFloat();
+
+            for (int i = 0; i < numSamples; i++) {
+                expectedBus[channel + (i * 2)] += source[i] * (gain * SAMPLE_TO_MIX_BUS_SCALE);
+            }
+            AudioMixKernels::accumulateMonoToStereoChannel(actualBus + channel, source, numSamples, gain);
+
+            if (!busesMatch("monoToStereoChannelTest", instructionSet)) {
+                return;
+            }
+        }
+    }
+}
+
+void AudioMixKernelsTests::gainTest() {
+    for (int set = AudioMixKernels::Scalar; set <= AudioMixKernels::getSupportedInstructionSet(); set++) {
+        AudioMixKernels::InstructionSet instructionSet = (AudioMixKernels::InstructionSet) set;
+        AudioMixKernels::setInstructionSet(instructionSet);
+
+        for (int T = 0; T < NUM_TEST_ITERATIONS; T++) {
+            randomizeBuffers();
+            int numSamples = randIntInRange(0, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+            float gain = randFloat() * 2.0f;
+
+            for (int i = 0; i < numSamples; i++) {
+                expectedBus[i] += source[i] * (gain * SAMPLE_TO_MIX_BUS_SCALE);
+            }
+            AudioMixKernels::accumulateWithGain(actualBus, source, numSamples, gain);
+
+            if (!busesMatch("gainTest", instructionSet)) {
+                return;
+            }
+        }
+    }
+}
+
+void AudioMixKernelsTests::accumulateTest() {
+    for (int set = AudioMixKernels::Scalar; set <= AudioMixKernels::getSupportedInstructionSet(); set++) {
+        AudioMixKernels::InstructionSet instructionSet = (AudioMixKernels::InstructionSet) set;
+        AudioMixKernels::setInstructionSet(instructionSet);
+
+        for (int T = 0; T < NUM_TEST_ITERATIONS; T++) {
+            randomizeBuffers();
+            int numSamples = randIntInRange(0, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+
+            for (int i = 0; i < numSamples; i++) {
+                expectedBus[i] += busSource[i];
+            }
+            AudioMixKernels::accumulate(actualBus, busSource, numSamples);
+
+            if (!busesMatch("accumulateTest", instructionSet)) {
+                return;
+            }
+        }
+    }
+}
+
+void AudioMixKernelsTests::limiterTest() {
+    // a ramp through the whole test range, so we can check that the curve never folds back on itself
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        busSource[i] = -MAX_TEST_BUS_SAMPLE + (2.0f * MAX_TEST_BUS_SAMPLE * i) / (NUM_TEST_SAMPLES - 1);
+    }
+
+    AudioMixKernels::setInstructionSet(AudioMixKernels::Scalar);
+    AudioMixKernels::limitToSamples(expected, busSource, NUM_TEST_SAMPLES);
+
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        if (fabsf(busSource[i]) <= MIX_BUS_LIMITER_THRESHOLD
+            && expected[i] != (int16_t)(busSource[i] * MIX_BUS_TO_SAMPLE_SCALE)) {
+            qDebug("limiterTest failed, %f is below the threshold but was changed to %d", busSource[i], expected[i]);
+            return;
+        }
+        if (i > 0 && expected[i] < expected[i - 1]) {
+            qDebug("limiterTest failed, %f limited to %d which is less than %d for %f", busSource[i], expected[i],
+                   expected[i - 1], busSource[i - 1]);
+            return;
+        }
+    }
+
+    for (int set = AudioMixKernels::Scalar; set <= AudioMixKernels::getSupportedInstructionSet(); set++) {
+        AudioMixKernels::InstructionSet instructionSet = (AudioMixKernels::InstructionSet) set;
+
+        for (int T = 0; T < NUM_TEST_ITERATIONS; T++) {
+            randomizeBuffers();
+            int numSamples = randIntInRange(0, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+
+            AudioMixKernels::setInstructionSet(AudioMixKernels::Scalar);
+            AudioMixKernels::limitToSamples(expected, busSource, numSamples);
+
+            AudioMixKernels::setInstructionSet(instructionSet);
+            AudioMixKernels::limitToSamples(actual, busSource, numSamples);
+
+            if (!samplesMatch("limiterTest", instructionSet, numSamples)) {
+                return;
+            }
+        }
+    }
+}
+
+void AudioMixKernelsTests::runAllTests() {
+    AudioMixKernels::InstructionSet selectedInstructionSet = AudioMixKernels::getInstructionSet();
+
+    monoToStereoChannelTest();
+    gainTest();
+    accumulateTest();
+    limiterTest();
+
+    AudioMixKernels::setInstructionSet(selectedInstructionSet);
+
+    qDebug() << "PASSED";
+}
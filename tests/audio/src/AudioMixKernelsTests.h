@@ -0,0 +1,26 @@
+//
+//  AudioMixKernelsTests.h
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernelsTests_h
+#define hifi_AudioMixKernelsTests_h
+
+#include "AudioMixKernels.h"
+
+namespace AudioMixKernelsTests {
+
+    void runAllTests();
+
+    void monoToStereoChannelTest();
+    void gainTest();
+    void accumulateTest();
+    void limiterTest();
+};
+
+#endif // hifi_AudioMixKernelsTests_h
@@ -0,0 +1,123 @@
+//
+//  AudioRingBufferStressTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QThread>
+
+#include "AudioRingBufferStressTests.h"
+
+const int STRESS_FRAME_SAMPLES = 240;
+const int STRESS_FRAME_CAPACITY = 10;
+const int MAX_CHUNK_SAMPLES = 3 * STRESS_FRAME_SAMPLES;
+const int NUM_STRESS_SAMPLES = 20000000;
+
+/// writes a counting sequence of samples into the ring buffer in random sized chunks
+class StressWriter : public QThread {
+public:
+    StressWriter(AudioRingBuffer& ringBuffer, bool waitForRoom) : _ringBuffer(ringBuffer), _waitForRoom(waitForRoom) {}
+
+protected:
+    virtual void run() {
+        int16_t chunk[MAX_CHUNK_SAMPLES];
+        int16_t nextSample = 0;
+        int samplesWritten = 0;
+
+        while (samplesWritten < NUM_STRESS_SAMPLES) {
+            // qrand keeps its state per thread, unlike rand
+            int chunkSamples = (qrand() % MAX_CHUNK_SAMPLES) + 1;
+
+            if (_waitForRoom) {
+                while (_ringBuffer.getSampleCapacity() - _ringBuffer.samplesAvailable() < chunkSamples) {
+                    QThread::yieldCurrentThread();
+                }
+            }
+
+            for (int i = 0; i < chunkSamples; i++) {
+                chunk[i] = nextSample++;
+            }
+            samplesWritten += _ringBuffer.writeSamples(chunk, chunkSamples);
+        }
+    }
+
+private:
+    AudioRingBuffer& _ringBuffer;
+    bool _waitForRoom;
+};
+
+static bool readUntilWriterFinishes(AudioRingBuffer& ringBuffer, StressWriter& writer, bool expectEverySample) {
+    int16_t chunk[MAX_CHUNK_SAMPLES];
+    int16_t expectedSample = 0;
+    int samplesRead = 0;
+
+    writer.start();
+
+    while (true) {
+        bool writerFinished = writer.isFinished();
+        int chunkSamples = ringBuffer.readSamples(chunk, (qrand() % MAX_CHUNK_SAMPLES) + 1);
+
+        if (chunkSamples == 0) {
+            if (writerFinished) {
+                break;
+            }
+            QThread::yieldCurrentThread();
+            continue;
+        }
+
+        // samples skipped by an overflow can only be skipped between reads, never inside of one
+        if (!expectEverySample) {
+            expectedSample = chunk[0];
+        }
+        for (int i = 0; i < chunkSamples; i++) {
+            if (chunk[i] != expectedSample) {
+                qDebug("Stress read %d incorrect!  Expected: %d  Actual: %d", samplesRead + i, expectedSample, chunk[i]);
+                writer.wait();
+                return false;
+            }
+            expectedSample++;
+        }
+        samplesRead += chunkSamples;
+    }
+
+    if (expectEverySample && samplesRead < NUM_STRESS_SAMPLES) {
+        qDebug("Stress test read %d samples, expected %d", samplesRead, NUM_STRESS_SAMPLES);
+        return false;
+    }
+    return true;
+}
+
+bool AudioRingBufferStressTests::lossless() {
+    AudioRingBuffer ringBuffer(STRESS_FRAME_SAMPLES, false, STRESS_FRAME_CAPACITY);
+    StressWriter writer(ringBuffer, true);
+    if (!readUntilWriterFinishes(ringBuffer, writer, true)) {
+        qDebug() << "lossless stress test FAILED";
+        return false;
+    }
+    return true;
+}
+
+bool AudioRingBufferStressTests::overflowing() {
+    AudioRingBuffer ringBuffer(STRESS_FRAME_SAMPLES, false, STRESS_FRAME_CAPACITY);
+    StressWriter writer(ringBuffer, false);
+    if (!readUntilWriterFinishes(ringBuffer, writer, false)) {
+        qDebug() << "overflowing stress test FAILED";
+        return false;
+    }
+    return true;
+}
+
+void AudioRingBufferStressTests::runAllTests() {
+    if (!lossless()) {
+        return;
+    }
+    if (!overflowing()) {
+        return;
+    }
+
+    qDebug() << "PASSED";
+}
@@ -0,0 +1,27 @@
+//
+//  AudioRingBufferStressTests.h
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioRingBufferStressTests_h
+#define hifi_AudioRingBufferStressTests_h
+
+#include "AudioRingBuffer.h"
+
+namespace AudioRingBufferStressTests {
+
+    void runAllTests();
+
+    /// the writer never overflows, the reader has to see every sample exactly once and in order
+    bool lossless();
+
+    /// the writer overwrites old samples whenever it gets ahead, every read still has to come back in one piece
+    bool overflowing();
+};
+
+#endif // hifi_AudioRingBufferStressTests_h
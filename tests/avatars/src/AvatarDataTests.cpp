@@ -0,0 +1,168 @@
+//
+//  AvatarDataTests.cpp
+//  tests/avatars/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QDebug>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AvatarData.h>
+#include <NumericalConstants.h>
+
+#include "AvatarDataTests.h"
+
+const glm::vec3 KEYFRAME_POSITION(1.0f, 2.0f, 3.0f);
+const glm::vec3 DELTA_POSITION(1.5f, 2.0f, 3.0f);
+const float BODY_YAW = 45.0f;
+const float TARGET_SCALE = 1.5f;
+const float DELTA_AUDIO_LOUDNESS = 50.0f;
+const int NUM_JOINTS = 3;
+const int MOVED_JOINT = 1;
+
+// the worst error we accept from the two byte angles and ratios and the six byte quats
+const float ANGLE_TOLERANCE = 0.01f; // degrees
+const float SCALE_TOLERANCE = 0.001f;
+const float JOINT_MIN_DOT = 0.9999f;
+
+static glm::quat keyframeJointRotation(int index) {
+    return glm::angleAxis(0.1f * (float)(index + 1), glm::normalize(glm::vec3(1.0f, (float)index, 0.5f)));
+}
+
+static glm::quat deltaJointRotation() {
+    return glm::angleAxis(PI_OVER_TWO, glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+static bool sameRotation(const glm::quat& a, const glm::quat& b) {
+    return fabsf(glm::dot(a, b)) > JOINT_MIN_DOT;
+}
+
+/// serializes a keyframe of the sender, then moves it and serializes a delta against that keyframe
+static void makeKeyframeAndDelta(AvatarData& sender, QByteArray& keyframe, QByteArray& delta) {
+    sender.setPosition(KEYFRAME_POSITION);
+    sender.setBodyYaw(BODY_YAW);
+    sender.setTargetScale(TARGET_SCALE);
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        sender.setJointData(i, keyframeJointRotation(i));
+    }
+    keyframe = sender.toByteArray();
+
+    sender.setPosition(DELTA_POSITION);
+    sender.setAudioLoudness(DELTA_AUDIO_LOUDNESS);
+    sender.setJointData(MOVED_JOINT, deltaJointRotation());
+    delta = sender.toByteArray();
+}
+
+void AvatarDataTests::keyframeAndDeltaTest() {
+    AvatarData sender;
+    QByteArray keyframe, delta;
+    makeKeyframeAndDelta(sender, keyframe, delta);
+
+    if (sender.wasKeyframeSentLast() || sender.getSentKeyframe() != keyframe) {
+        qDebug() << "keyframeAndDeltaTest FAILED: the sender doesn't know the delta was taken against the keyframe";
+        return;
+    }
+    if (delta.size() >= keyframe.size()) {
+        qDebug() << "keyframeAndDeltaTest FAILED: delta of" << delta.size() << "bytes isn't smaller than keyframe of"
+            << keyframe.size() << "bytes";
+        return;
+    }
+
+    AvatarData receiver;
+    if (receiver.parseDataAtOffset(keyframe, 0) != keyframe.size()) {
+        qDebug() << "keyframeAndDeltaTest FAILED: keyframe wasn't parsed completely";
+        return;
+    }
+    if (receiver.getPosition() != KEYFRAME_POSITION || fabsf(receiver.getBodyYaw() - BODY_YAW) > ANGLE_TOLERANCE
+            || fabsf(receiver.getTargetScale() - TARGET_SCALE) > SCALE_TOLERANCE) {
+        qDebug() << "keyframeAndDeltaTest FAILED: keyframe fields didn't come back as they were sent";
+        return;
+    }
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        if (!sameRotation(receiver.getJointRotation(i), keyframeJointRotation(i))) {
+            qDebug() << "keyframeAndDeltaTest FAILED: keyframe joint" << i << "didn't come back as it was sent";
+            return;
+        }
+    }
+
+    if (receiver.parseDataAtOffset(delta, 0) != delta.size()) {
+        qDebug() << "keyframeAndDeltaTest FAILED: delta wasn't parsed completely";
+        return;
+    }
+    // the delta carries what moved, everything else still comes from the keyframe
+    if (receiver.getPosition() != DELTA_POSITION || receiver.getAudioLoudness() != DELTA_AUDIO_LOUDNESS
+            || fabsf(receiver.getBodyYaw() - BODY_YAW) > ANGLE_TOLERANCE
+            || fabsf(receiver.getTargetScale() - TARGET_SCALE) > SCALE_TOLERANCE) {
+        qDebug() << "keyframeAndDeltaTest FAILED: delta fields didn't come back as they were sent";
+        return;
+    }
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        glm::quat expected = (i == MOVED_JOINT) ? deltaJointRotation() : keyframeJointRotation(i);
+        if (!sameRotation(receiver.getJointRotation(i), expected)) {
+            qDebug() << "keyframeAndDeltaTest FAILED: joint" << i << "is wrong after the delta";
+            return;
+        }
+    }
+
+    qDebug() << "keyframeAndDeltaTest passed";
+}
+
+void AvatarDataTests::unknownKeyframeTest() {
+    AvatarData sender;
+    QByteArray keyframe, delta;
+    makeKeyframeAndDelta(sender, keyframe, delta);
+
+    // a receiver that never got the keyframe
+    AvatarData receiver;
+    if (receiver.parseDataAtOffset(delta, 0) != delta.size() || receiver.getPosition() == DELTA_POSITION) {
+        qDebug() << "unknownKeyframeTest FAILED: delta was applied without its keyframe";
+        return;
+    }
+
+    // a receiver holding a different keyframe than the one the delta was taken against
+    QByteArray otherDelta = delta;
+    otherDelta[0] = (char)(sender.getSentKeyframeID() + 1);
+    if (receiver.parseDataAtOffset(keyframe, 0) != keyframe.size()
+            || receiver.parseDataAtOffset(otherDelta, 0) != otherDelta.size()
+            || receiver.getPosition() != KEYFRAME_POSITION
+            || !sameRotation(receiver.getJointRotation(MOVED_JOINT), keyframeJointRotation(MOVED_JOINT))) {
+        qDebug() << "unknownKeyframeTest FAILED: delta was applied to the wrong keyframe";
+        return;
+    }
+
+    qDebug() << "unknownKeyframeTest passed";
+}
+
+void AvatarDataTests::truncatedDeltaTest() {
+    AvatarData sender;
+    QByteArray keyframe, delta;
+    makeKeyframeAndDelta(sender, keyframe, delta);
+
+    AvatarData receiver;
+    receiver.parseDataAtOffset(keyframe, 0);
+
+    // the joints come last, so losing the last byte leaves every field whole but the update incomplete
+    QByteArray truncated = delta.left(delta.size() - 1);
+    if (receiver.parseDataAtOffset(truncated, 0) != truncated.size()) {
+        qDebug() << "truncatedDeltaTest FAILED: a malformed update has to consume the rest of the packet";
+        return;
+    }
+    if (receiver.getPosition() != KEYFRAME_POSITION || receiver.getAudioLoudness() == DELTA_AUDIO_LOUDNESS
+            || !sameRotation(receiver.getJointRotation(MOVED_JOINT), keyframeJointRotation(MOVED_JOINT))) {
+        qDebug() << "truncatedDeltaTest FAILED: part of a truncated delta was applied";
+        return;
+    }
+
+    qDebug() << "truncatedDeltaTest passed";
+}
+
+void AvatarDataTests::runAllTests() {
+    keyframeAndDeltaTest();
+    unknownKeyframeTest();
+    truncatedDeltaTest();
+}
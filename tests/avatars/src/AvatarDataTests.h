@@ -0,0 +1,28 @@
+//
+//  AvatarDataTests.h
+//  tests/avatars/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarDataTests_h
+#define hifi_AvatarDataTests_h
+
+namespace AvatarDataTests {
+
+    /// a keyframe and then a delta against it parse back into the state they were taken from
+    void keyframeAndDeltaTest();
+
+    /// a delta taken against a keyframe the receiver doesn't hold changes nothing
+    void unknownKeyframeTest();
+
+    /// a delta cut short is rejected as a whole, none of its fields are applied
+    void truncatedDeltaTest();
+
+    void runAllTests();
+}
+
+#endif // hifi_AvatarDataTests_h
@@ -0,0 +1,19 @@
+//
+//  main.cpp
+//  tests/avatars/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarDataTests.h"
+#include <stdio.h>
+
+int main(int argc, char** argv) {
+    AvatarDataTests::runAllTests();
+    printf("tests complete, press enter to exit\n");
+    getchar();
+    return 0;
+}
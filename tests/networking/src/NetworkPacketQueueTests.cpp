@@ -0,0 +1,136 @@
+//
+//  NetworkPacketQueueTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cassert>
+
+#include "NetworkPacketQueueTests.h"
+
+static SharedNodePointer createNode() {
+    return SharedNodePointer(new Node(QUuid::createUuid(), NodeType::Agent, HifiSockAddr(), HifiSockAddr(), false, false));
+}
+
+static QByteArray packetWithNumber(char number) {
+    return QByteArray(8, number);
+}
+
+void NetworkPacketQueueTests::runAllTests() {
+    batchTest();
+    dropOldestTest();
+    backpressureTest();
+    growTest();
+}
+
+void NetworkPacketQueueTests::batchTest() {
+    NetworkPacketQueue queue(16);
+    SharedNodePointer first = createNode();
+    SharedNodePointer second = createNode();
+
+    for (char i = 0; i < 10; i++) {
+        queue.enqueue((i % 2) ? second : first, packetWithNumber(i));
+    }
+    assert(queue.size() == 10);
+    assert(queue.packetCountFrom(first->getUUID()) == 5);
+    assert(queue.packetCountFrom(second->getUUID()) == 5);
+
+    // batches come out oldest first and stop at the requested size
+    std::vector<NetworkPacket> batch;
+    assert(queue.dequeueBatch(batch, 4) == 4);
+    for (char i = 0; i < 4; i++) {
+        assert(batch[i].getByteArray() == packetWithNumber(i));
+    }
+    assert(queue.packetCountFrom(first->getUUID()) == 3);
+    assert(queue.packetCountFrom(second->getUUID()) == 3);
+
+    // wrap around the end of the ring
+    for (char i = 10; i < 20; i++) {
+        queue.enqueue(first, packetWithNumber(i));
+    }
+    assert(queue.dequeueBatch(batch) == 16);
+    for (char i = 0; i < 16; i++) {
+        assert(batch[i].getByteArray() == packetWithNumber(i + 4));
+    }
+    assert(queue.isEmpty());
+    assert(!queue.waitForPackets(0));
+
+    // nodes we've heard from stay known with nothing queued until they're removed
+    assert(queue.hasNode(first->getUUID()) && queue.packetCountFrom(first->getUUID()) == 0);
+    queue.removeNode(first->getUUID());
+    assert(!queue.hasNode(first->getUUID()));
+    assert(queue.getDroppedPacketCount() == 0);
+}
+
+void NetworkPacketQueueTests::dropOldestTest() {
+    NetworkPacketQueue queue(4, NetworkPacketQueue::DropOldest);
+    SharedNodePointer first = createNode();
+    SharedNodePointer second = createNode();
+
+    for (char i = 0; i < 4; i++) {
+        queue.enqueue(first, packetWithNumber(i));
+    }
+    assert(queue.enqueue(second, packetWithNumber(4)));
+    assert(queue.enqueue(second, packetWithNumber(5)));
+
+    assert(queue.size() == 4);
+    assert(queue.getDroppedPacketCount() == 2);
+    assert(queue.packetCountFrom(first->getUUID()) == 2);
+    assert(queue.packetCountFrom(second->getUUID()) == 2);
+
+    std::vector<NetworkPacket> batch;
+    assert(queue.dequeueBatch(batch) == 4);
+    assert(batch.front().getByteArray() == packetWithNumber(2));
+    assert(batch.back().getByteArray() == packetWithNumber(5));
+}
+
+void NetworkPacketQueueTests::backpressureTest() {
+    NetworkPacketQueue queue(2, NetworkPacketQueue::Backpressure);
+    SharedNodePointer node = createNode();
+
+    assert(queue.enqueue(node, packetWithNumber(0), false));
+    assert(queue.enqueue(node, packetWithNumber(1), false));
+
+    // a full queue refuses a producer that can't wait and keeps what it has
+    assert(!queue.enqueue(node, packetWithNumber(2), false));
+    assert(queue.getDroppedPacketCount() == 1);
+
+    // and once it's stopped it refuses the ones that could
+    queue.stop();
+    assert(!queue.enqueue(node, packetWithNumber(2)));
+
+    std::vector<NetworkPacket> batch;
+    assert(queue.dequeueBatch(batch) == 2);
+    assert(batch.front().getByteArray() == packetWithNumber(0));
+    assert(queue.enqueue(node, packetWithNumber(2)));
+    assert(queue.packetCountFrom(node->getUUID()) == 1);
+}
+
+void NetworkPacketQueueTests::growTest() {
+    NetworkPacketQueue queue(4, NetworkPacketQueue::Grow);
+    SharedNodePointer node = createNode();
+
+    // start the oldest packet partway into the ring so that growing has to unwrap it
+    std::vector<NetworkPacket> batch;
+    for (char i = 0; i < 3; i++) {
+        queue.enqueue(node, packetWithNumber(i));
+    }
+    assert(queue.dequeueBatch(batch, 3) == 3);
+
+    // a full queue takes packets from producers that can't wait, and keeps every one of them
+    for (char i = 0; i < 10; i++) {
+        assert(queue.enqueue(node, packetWithNumber(i), false));
+    }
+    assert(queue.getCapacity() == 16);
+    assert(queue.getDroppedPacketCount() == 0);
+    assert(queue.packetCountFrom(node->getUUID()) == 10);
+
+    assert(queue.dequeueBatch(batch) == 10);
+    for (char i = 0; i < 10; i++) {
+        assert(batch[i].getByteArray() == packetWithNumber(i));
+    }
+}
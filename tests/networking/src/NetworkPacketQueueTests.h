@@ -0,0 +1,26 @@
+//
+//  NetworkPacketQueueTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NetworkPacketQueueTests_h
+#define hifi_NetworkPacketQueueTests_h
+
+#include "NetworkPacketQueue.h"
+
+namespace NetworkPacketQueueTests {
+
+    void runAllTests();
+
+    void batchTest();
+    void dropOldestTest();
+    void backpressureTest();
+    void growTest();
+};
+
+#endif // hifi_NetworkPacketQueueTests_h
@@ -0,0 +1,101 @@
+//
+//  OutboundPacketTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cassert>
+#include <cstring>
+
+#include <QtCore/QUuid>
+
+#include "OutboundPacketTests.h"
+
+void OutboundPacketTests::runAllTests() {
+    headerTest();
+    payloadTest();
+    poolTest();
+}
+
+void OutboundPacketTests::headerTest() {
+    QUuid sessionUUID = QUuid::createUuid();
+
+    // a verified, sequence numbered type and an unverified one
+    PacketType types[] = { PacketTypeAvatarData, PacketTypeDomainList };
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        PacketType type = types[i];
+        OutboundPacket packet(type, sessionUUID);
+        QByteArray expectedHeader = byteArrayWithUUIDPopulatedHeader(type, sessionUUID);
+
+        assert(packet.getType() == type);
+        assert(packet.getSize() == numBytesForPacketHeaderGivenPacketType(type));
+        assert(packet.getDatagram() == expectedHeader);
+        assert(packetTypeForPacket(packet.getDatagram()) == type);
+        assert(uuidFromPacketHeader(packet.getDatagram()) == sessionUUID);
+    }
+}
+
+void OutboundPacketTests::payloadTest() {
+    OutboundPacket packet(PacketTypeMixedAudio, QUuid::createUuid());
+    int headerBytes = packet.getSize();
+
+    const char SEQUENCE[] = { 1, 2 };
+    packet.append(SEQUENCE, sizeof(SEQUENCE));
+
+    // write straight into the buffer
+    int bytesAvailable = packet.getBytesAvailable();
+    assert(bytesAvailable == MAX_PACKET_SIZE - headerBytes - (int)sizeof(SEQUENCE));
+    const char* bufferBefore = packet.getDatagram().constData();
+
+    memset(packet.getPayloadAt(), 7, bytesAvailable);
+    packet.advancePayload(bytesAvailable);
+
+    // filling the packet to the brim never moves it
+    assert(packet.getSize() == MAX_PACKET_SIZE);
+    assert(packet.getBytesAvailable() == 0);
+    assert(packet.getDatagram().constData() == bufferBefore);
+
+    const QByteArray& datagram = packet.getDatagram();
+    assert(datagram[headerBytes] == 1 && datagram[headerBytes + 1] == 2);
+    assert(datagram[headerBytes + 2] == 7 && datagram[MAX_PACKET_SIZE - 1] == 7);
+}
+
+void OutboundPacketTests::poolTest() {
+    const char* firstBuffer;
+    {
+        OutboundPacket packet(PacketTypeMixedAudio, QUuid::createUuid());
+        firstBuffer = packet.getDatagram().constData();
+    }
+
+    // the buffer went back to the pool and is the next one handed out
+    {
+        OutboundPacket packet(PacketTypeMixedAudio, QUuid::createUuid());
+        assert(packet.getDatagram().constData() == firstBuffer);
+        assert(packet.getDatagram().capacity() >= MAX_PACKET_SIZE);
+    }
+
+    // a buffer still shared when its packet goes away isn't pooled, the pool doesn't hand out shared buffers
+    QByteArray heldCopy;
+    const char* heldBuffer;
+    {
+        OutboundPacket packet(PacketTypeMixedAudio, QUuid::createUuid());
+        heldCopy = packet.getDatagram();
+        heldBuffer = heldCopy.constData();
+    }
+    {
+        OutboundPacket packet(PacketTypeMixedAudio, QUuid::createUuid());
+        assert(packet.getDatagram().constData() != heldBuffer);
+    }
+
+    // once the last holder gives it back it can be used again
+    PacketBufferPool::release(heldCopy);
+    assert(heldCopy.isEmpty());
+    {
+        OutboundPacket packet(PacketTypeMixedAudio, QUuid::createUuid());
+        assert(packet.getDatagram().constData() == heldBuffer);
+    }
+}
@@ -0,0 +1,25 @@
+//
+//  OutboundPacketTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OutboundPacketTests_h
+#define hifi_OutboundPacketTests_h
+
+#include "OutboundPacket.h"
+
+namespace OutboundPacketTests {
+
+    void runAllTests();
+
+    void headerTest();
+    void payloadTest();
+    void poolTest();
+};
+
+#endif // hifi_OutboundPacketTests_h
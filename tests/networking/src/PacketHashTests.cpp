@@ -0,0 +1,115 @@
+//
+//  PacketHashTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cassert>
+#include <cstring>
+
+#include <QtCore/QDebug>
+#include <QtCore/QUuid>
+
+#include <LimitedNodeList.h>
+#include <SharedUtil.h>
+#include <SipHash.h>
+
+#include "PacketHashTests.h"
+
+void PacketHashTests::runAllTests() {
+    sipHashTest();
+    stampAndVerifyTest();
+}
+
+void PacketHashTests::sipHashTest() {
+    // vectors from the SipHash-2-4-128 reference implementation, where the key is the bytes 0 to 15 and each message
+    // is the bytes counting up from 0. The lengths cover empty and partial tails, one full block, a block and a tail,
+    // two full blocks and the longest tail after several blocks.
+    const int MESSAGE_LENGTHS[] = { 0, 1, 7, 8, 15, 16, 63 };
+    const uchar EXPECTED_HASHES[][NUM_BYTES_SIPHASH_128] = {
+        { 0xa3, 0x81, 0x7f, 0x04, 0xba, 0x25, 0xa8, 0xe6, 0x6d, 0xf6, 0x72, 0x14, 0xc7, 0x55, 0x02, 0x93 },
+        { 0xda, 0x87, 0xc1, 0xd8, 0x6b, 0x99, 0xaf, 0x44, 0x34, 0x76, 0x59, 0x11, 0x9b, 0x22, 0xfc, 0x45 },
+        { 0xa1, 0xf1, 0xeb, 0xbe, 0xd8, 0xdb, 0xc1, 0x53, 0xc0, 0xb8, 0x4a, 0xa6, 0x1f, 0xf0, 0x82, 0x39 },
+        { 0x3b, 0x62, 0xa9, 0xba, 0x62, 0x58, 0xf5, 0x61, 0x0f, 0x83, 0xe2, 0x64, 0xf3, 0x14, 0x97, 0xb4 },
+        { 0x54, 0x93, 0xe9, 0x99, 0x33, 0xb0, 0xa8, 0x11, 0x7e, 0x08, 0xec, 0x0f, 0x97, 0xcf, 0xc3, 0xd9 },
+        { 0x6e, 0xe2, 0xa4, 0xca, 0x67, 0xb0, 0x54, 0xbb, 0xfd, 0x33, 0x15, 0xbf, 0x85, 0x23, 0x05, 0x77 },
+        { 0x51, 0x50, 0xd1, 0x77, 0x2f, 0x50, 0x83, 0x4a, 0x50, 0x3e, 0x06, 0x9a, 0x97, 0x3f, 0xbd, 0x7c }
+    };
+    const int NUM_VECTORS = sizeof(MESSAGE_LENGTHS) / sizeof(MESSAGE_LENGTHS[0]);
+    const int MAX_MESSAGE_LENGTH = 63;
+
+    uchar key[NUM_BYTES_SIPHASH_KEY];
+    for (int i = 0; i < NUM_BYTES_SIPHASH_KEY; i++) {
+        key[i] = i;
+    }
+    char message[MAX_MESSAGE_LENGTH];
+    for (int i = 0; i < MAX_MESSAGE_LENGTH; i++) {
+        message[i] = i;
+    }
+
+    for (int i = 0; i < NUM_VECTORS; i++) {
+        uchar hash[NUM_BYTES_SIPHASH_128];
+        sipHash128(message, MESSAGE_LENGTHS[i], key, hash);
+        assert(memcmp(hash, EXPECTED_HASHES[i], NUM_BYTES_SIPHASH_128) == 0);
+    }
+}
+
+void PacketHashTests::stampAndVerifyTest() {
+    QUuid connectionSecret = QUuid::createUuid();
+    QUuid otherSecret = QUuid::createUuid();
+
+    QByteArray packet = byteArrayWithUUIDPopulatedHeader(PacketTypeAvatarData, QUuid::createUuid());
+    for (int i = 0; i < 200; i++) {
+        packet.append((char)i);
+    }
+
+    // the MD5 path still produces what older nodes compute
+    replaceHashInPacket(packet, connectionSecret, PacketHashMD5);
+    assert(hashFromPacketHeader(packet) == hashForPacketAndConnectionUUID(packet, connectionSecret));
+    assert(packetHashMatches(packet, connectionSecret, PacketHashMD5));
+    assert(!packetHashMatches(packet, connectionSecret, PacketHashSipHash));
+
+    replaceHashInPacket(packet, connectionSecret, PacketHashSipHash);
+    assert(packetHashMatches(packet, connectionSecret, PacketHashSipHash));
+    assert(!packetHashMatches(packet, connectionSecret, PacketHashMD5));
+    assert(!packetHashMatches(packet, otherSecret, PacketHashSipHash));
+
+    // stamping the sequence number doesn't touch the payload the hash covers
+    replaceHashAndSequenceNumberInPacket(packet, connectionSecret, PacketHashSipHash, 42);
+    assert(sequenceNumberFromHeader(packet) == 42);
+    assert(packetHashMatches(packet, connectionSecret, PacketHashSipHash));
+
+    packet[packet.size() - 1] = packet[packet.size() - 1] + 1;
+    assert(!packetHashMatches(packet, connectionSecret, PacketHashSipHash));
+
+    // a packet too short to hold its own header never matches
+    QByteArray truncated = packet.left(numBytesForPacketHeader(packet) - 1);
+    assert(!packetHashMatches(truncated, connectionSecret, PacketHashSipHash));
+}
+
+void PacketHashTests::hashBenchmark() {
+    const int NUM_PACKETS = 100000;
+    const int PAYLOAD_SIZES[] = { 64, 512, MAX_PACKET_SIZE - MAX_PACKET_HEADER_BYTES };
+    const char* HASH_NAMES[] = { "MD5", "SipHash" };
+    QUuid connectionSecret = QUuid::createUuid();
+
+    for (size_t i = 0; i < sizeof(PAYLOAD_SIZES) / sizeof(PAYLOAD_SIZES[0]); i++) {
+        QByteArray packet = byteArrayWithUUIDPopulatedHeader(PacketTypeMixedAudio, QUuid::createUuid());
+        packet.append(QByteArray(PAYLOAD_SIZES[i], 'x'));
+
+        for (int hashType = PacketHashMD5; hashType <= PacketHashSipHash; hashType++) {
+            quint64 start = usecTimestampNow();
+            for (int j = 0; j < NUM_PACKETS; j++) {
+                replaceHashInPacket(packet, connectionSecret, (PacketHashType)hashType, PacketTypeMixedAudio);
+            }
+            float usecsPerPacket = (float)(usecTimestampNow() - start) / NUM_PACKETS;
+
+            qDebug() << HASH_NAMES[hashType] << "hash of a" << PAYLOAD_SIZES[i] << "byte payload took"
+                << usecsPerPacket << "usecs per packet";
+        }
+    }
+}
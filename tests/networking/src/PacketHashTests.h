@@ -0,0 +1,27 @@
+//
+//  PacketHashTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketHashTests_h
+#define hifi_PacketHashTests_h
+
+#include "PacketHeaders.h"
+
+namespace PacketHashTests {
+
+    void runAllTests();
+
+    void sipHashTest();
+    void stampAndVerifyTest();
+
+    // prints the per-packet cost of stamping an MD5 hash and a SipHash MAC, not part of runAllTests()
+    void hashBenchmark();
+};
+
+#endif // hifi_PacketHashTests_h
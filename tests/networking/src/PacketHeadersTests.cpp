@@ -0,0 +1,57 @@
+//
+//  PacketHeadersTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cassert>
+
+#include <QtCore/QUuid>
+
+#include "PacketHeadersTests.h"
+
+void PacketHeadersTests::runAllTests() {
+    packetTypeInfoTest();
+    unknownPacketTypeTest();
+}
+
+void PacketHeadersTests::packetTypeInfoTest() {
+    QUuid sessionUUID = QUuid::createUuid();
+
+    for (int i = 0; i < NUM_PACKET_TYPES; i++) {
+        PacketType type = (PacketType)i;
+        const PacketTypeInfo& info = infoForPacketType(type);
+
+        // the table entry sizes the header we actually write and read back
+        QByteArray header = byteArrayWithUUIDPopulatedHeader(type, sessionUUID);
+        assert(header.size() == info.numHeaderBytes);
+        assert(numBytesForPacketHeaderGivenPacketType(type) == info.numHeaderBytes);
+        assert(packetTypeForPacket(header) == type);
+        assert(header[numBytesForArithmeticCodedPacketType(type)] == info.version);
+    }
+
+    // an entry out of order would carry its neighbour's name
+    assert(nameForPacketType(PacketTypeAvatarData) == "PacketTypeAvatarData");
+    assert(nameForPacketType(PacketTypeNoisyMute) == "PacketTypeNoisyMute");
+    assert(nameForPacketType(PacketTypeParticleEntitiesFix) == "PacketTypeParticleEntitiesFix");
+    assert(isSequenceNumberedPacketType(PacketTypeAvatarData));
+    assert(isVerifiedPacketType(PacketTypeMixedAudio));
+    assert(!isVerifiedPacketType(PacketTypeDomainList));
+    assert(!isVerifiedPacketType(PacketTypeUnverifiedPing));
+    assert(versionForPacketType(PacketTypeEntityData) == VERSION_NO_ENTITY_ID_SWAP);
+}
+
+void PacketHeadersTests::unknownPacketTypeTest() {
+    // a type byte from a newer node, or a garbled one, reads as a verified type without a sequence number
+    PacketType futureType = (PacketType)(NUM_PACKET_TYPES + 10);
+    assert(isVerifiedPacketType(futureType));
+    assert(!isSequenceNumberedPacketType(futureType));
+    assert(versionForPacketType(futureType) == 0);
+    assert(numBytesForPacketHeaderGivenPacketType(futureType)
+           == numBytesForArithmeticCodedPacketType(futureType) + NUM_STATIC_HEADER_BYTES + NUM_BYTES_MD5_HASH);
+    assert(nameForPacketType(futureType).startsWith("Type: "));
+}
@@ -0,0 +1,24 @@
+//
+//  PacketHeadersTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketHeadersTests_h
+#define hifi_PacketHeadersTests_h
+
+#include "PacketHeaders.h"
+
+namespace PacketHeadersTests {
+
+    void runAllTests();
+
+    void packetTypeInfoTest();
+    void unknownPacketTypeTest();
+};
+
+#endif // hifi_PacketHeadersTests_h
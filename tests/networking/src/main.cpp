@@ -8,11 +8,25 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include "NetworkPacketQueueTests.h"
+#include "OutboundPacketTests.h"
+#include "PacketHashTests.h"
+#include "PacketHeadersTests.h"
 #include "SequenceNumberStatsTests.h"
+#include "SharedUtil.h"
 #include <stdio.h>
 
-int main(int argc, char** argv) {
+int main(int argc, const char* argv[]) {
     SequenceNumberStatsTests::runAllTests();
+    OutboundPacketTests::runAllTests();
+    PacketHashTests::runAllTests();
+    PacketHeadersTests::runAllTests();
+    NetworkPacketQueueTests::runAllTests();
+
+    const char* BENCHMARK = "--benchmark";
+    if (cmdOptionExists(argc, argv, BENCHMARK)) {
+        PacketHashTests::hashBenchmark();
+    }
     printf("tests passed! press enter to exit");
     getchar();
     return 0;
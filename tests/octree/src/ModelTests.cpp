@@ -13,12 +13,14 @@
 //
 
 #include <QDebug>
+#include <QScopedPointer>
 
 #include <EntityItem.h>
 #include <EntityTree.h>
 #include <EntityTreeElement.h>
 #include <Octree.h>
 #include <OctreeConstants.h>
+#include <OctreeVersionPublisher.h>
 #include <PropertyFlags.h>
 #include <SharedUtil.h>
 
@@ -507,7 +509,248 @@ void EntityTests::entityTreeTests(bool verbose) {
 }
 
 
+void EntityTests::entityJournalTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "EntityTests::entityJournalTests()";
+
+    float oneMeter = 1.0f;
+    glm::vec3 firstPosition(oneMeter, oneMeter, oneMeter);
+    glm::vec3 movedPosition(2.0f * oneMeter, oneMeter, 3.0f * oneMeter);
+
+    EntityTree tree;
+    int journalID = tree.startChangeJournal();
+
+    EntityItemID keptID(QUuid::createUuid());
+    EntityItemID deletedID(QUuid::createUuid());
+    EntityItemID tornID(QUuid::createUuid());
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setPosition(firstPosition);
+
+    // two intervals worth of journal: two entities added, then one moved and the other deleted
+    QByteArray journal;
+    tree.addEntity(keptID, properties);
+    tree.addEntity(deletedID, properties);
+    QScopedPointer<OctreeSnapshot> changes(tree.takeChangesSnapshot(journalID));
+    changes->writeToJournal(journal);
+
+    properties.setPosition(movedPosition);
+    tree.updateEntity(keptID, properties);
+    tree.deleteEntity(deletedID, true, true);
+    changes.reset(tree.takeChangesSnapshot(journalID));
+    changes->writeToJournal(journal);
+
+    {
+        testsTaken++;
+        QString testName = "replay journaled edits and delete into a fresh tree";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        EntityTree replayedTree;
+        int bytesReplayed = replayedTree.replayJournal(journal);
+        const EntityItem* keptEntity = replayedTree.findEntityByEntityItemID(keptID);
+        const EntityItem* deletedEntity = replayedTree.findEntityByEntityItemID(deletedID);
+
+        if (verbose) {
+            qDebug() << "bytesReplayed=" << bytesReplayed << "journal.size()=" << journal.size();
+            qDebug() << "keptEntity=" << keptEntity << "deletedEntity=" << deletedEntity;
+        }
+
+        bool passed = bytesReplayed == journal.size() && keptEntity && !deletedEntity
+            && keptEntity->getPosition() == movedPosition;
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "drop a torn trailing journal record";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        // a third interval whose record was cut short when the server stopped
+        QByteArray tornJournal = journal;
+        tree.addEntity(tornID, properties);
+        changes.reset(tree.takeChangesSnapshot(journalID));
+        changes->writeToJournal(tornJournal);
+        tornJournal.chop((tornJournal.size() - journal.size()) / 2);
+
+        EntityTree replayedTree;
+        int bytesReplayed = replayedTree.replayJournal(tornJournal);
+        const EntityItem* keptEntity = replayedTree.findEntityByEntityItemID(keptID);
+        const EntityItem* tornEntity = replayedTree.findEntityByEntityItemID(tornID);
+
+        if (verbose) {
+            qDebug() << "bytesReplayed=" << bytesReplayed << "complete records=" << journal.size();
+            qDebug() << "keptEntity=" << keptEntity << "tornEntity=" << tornEntity;
+        }
+
+        bool passed = bytesReplayed == journal.size() && keptEntity && !tornEntity;
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+void EntityTests::entityVersionTests(bool verbose) {
+    int testsTaken = 0;
+    int testsPassed = 0;
+    int testsFailed = 0;
+
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+
+    qDebug() << "EntityTests::entityVersionTests()";
+
+    float oneMeter = 1.0f;
+    glm::vec3 firstPosition(oneMeter, oneMeter, oneMeter);
+    glm::vec3 movedPosition(2.0f * oneMeter, oneMeter, 3.0f * oneMeter);
+
+    EntityTree tree;
+    QVector<Octree*> copies;
+    copies << new EntityTree() << new EntityTree();
+    OctreeVersionPublisher publisher(&tree, copies);
+
+    EntityItemID movedID(QUuid::createUuid());
+    EntityItemID addedID(QUuid::createUuid());
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setPosition(firstPosition);
+    tree.addEntity(movedID, properties);
+
+    bool published = publisher.publish();
+    OctreeVersion* firstVersion = publisher.acquireLatest();
+
+    {
+        testsTaken++;
+        QString testName = "publish the tree into a copy";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        EntityTree* firstTree = firstVersion ? static_cast<EntityTree*>(firstVersion->getTree()) : NULL;
+        const EntityItem* movedEntity = firstTree ? firstTree->findEntityByEntityItemID(movedID) : NULL;
+
+        bool passed = published && firstVersion && movedEntity && movedEntity->getPosition() == firstPosition;
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    properties.setPosition(movedPosition);
+    tree.updateEntity(movedID, properties);
+    published = publisher.publish();
+    OctreeVersion* secondVersion = publisher.acquireLatest();
+
+    {
+        testsTaken++;
+        QString testName = "a held version doesn't change when the next one is published";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        EntityTree* firstTree = static_cast<EntityTree*>(firstVersion->getTree());
+        EntityTree* secondTree = static_cast<EntityTree*>(secondVersion->getTree());
+        const EntityItem* heldEntity = firstTree->findEntityByEntityItemID(movedID);
+        const EntityItem* latestEntity = secondTree->findEntityByEntityItemID(movedID);
+
+        if (verbose) {
+            qDebug() << "firstVersion=" << firstVersion->getNumber() << "secondVersion=" << secondVersion->getNumber();
+        }
+
+        bool passed = published && secondVersion != firstVersion && secondVersion->getNumber() > firstVersion->getNumber()
+            && heldEntity && heldEntity->getPosition() == firstPosition
+            && latestEntity && latestEntity->getPosition() == movedPosition
+            && !publisher.isOutdated(firstVersion); // it's only just been replaced
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "publishing waits while every copy is held";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        tree.addEntity(addedID, properties);
+        published = publisher.publish();
+
+        bool passed = !published && publisher.getBusySkipCount() == 1
+            && publisher.getLatestVersionNumber() == secondVersion->getNumber();
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+    }
+
+    {
+        testsTaken++;
+        QString testName = "waiting changes are published once a copy is released";
+        if (verbose) {
+            qDebug() << "Test" << testsTaken <<":" << qPrintable(testName);
+        }
+
+        publisher.release(firstVersion);
+        published = publisher.publish();
+        OctreeVersion* thirdVersion = publisher.acquireLatest();
+        EntityTree* thirdTree = static_cast<EntityTree*>(thirdVersion->getTree());
+        const EntityItem* movedEntity = thirdTree->findEntityByEntityItemID(movedID);
+        const EntityItem* addedEntity = thirdTree->findEntityByEntityItemID(addedID);
+
+        bool passed = published && thirdVersion == firstVersion && publisher.getPendingChangesSize() > 0
+            && movedEntity && movedEntity->getPosition() == movedPosition && addedEntity;
+        if (passed) {
+            testsPassed++;
+        } else {
+            testsFailed++;
+            qDebug() << "FAILED - Test" << testsTaken <<":" << qPrintable(testName);
+        }
+        publisher.release(thirdVersion);
+    }
+    publisher.release(secondVersion);
+
+    qDebug() << "   tests passed:" << testsPassed << "out of" << testsTaken;
+    if (verbose) {
+        qDebug() << "******************************************************************************************";
+    }
+}
+
+
 void EntityTests::runAllTests(bool verbose) {
     entityTreeTests(verbose);
+    entityJournalTests(verbose);
+    entityVersionTests(verbose);
 }
 
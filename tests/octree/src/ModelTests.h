@@ -14,6 +14,8 @@
 
 namespace EntityTests {
     void entityTreeTests(bool verbose = false);
+    void entityJournalTests(bool verbose = false);
+    void entityVersionTests(bool verbose = false);
     void runAllTests(bool verbose = false);
 }
 
@@ -179,6 +179,60 @@ void ShapeManagerTests::addManyShapes() {
     }
 }
 
+void ShapeManagerTests::testUnreferencedShapeCache() {
+    ShapeManager shapeManager;
+    ShapeInfo info;
+
+    // make more shapes than the manager will keep around once they're released
+    int numShapes = 200;
+    QVector<btCollisionShape*> shapes;
+    for (int i = 0; i < numShapes; ++i) {
+        info.setSphere(1.0f + (float)i);
+        shapes.push_back(shapeManager.getShape(info));
+    }
+    if (shapeManager.getNumMisses() != (quint64)numShapes || shapeManager.getNumHits() != 0) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected " << numShapes << " misses and zero hits"
+            << " but found " << shapeManager.getNumMisses() << " misses and " << shapeManager.getNumHits() << " hits"
+            << std::endl;
+    }
+
+    for (int i = 0; i < numShapes; ++i) {
+        shapeManager.releaseShape(shapes[i]);
+    }
+
+    // only the most recently released shapes are kept
+    int numKept = shapeManager.getNumShapes();
+    if (numKept == 0 || numKept >= numShapes) {
+        std::cout << __FILE__ << ":" << __LINE__
+            << " ERROR: expected some but not all released shapes to be kept, found " << numKept << std::endl;
+    }
+    if (shapeManager.getNumUnreferencedShapes() != numKept) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected " << numKept
+            << " unreferenced shapes but found " << shapeManager.getNumUnreferencedShapes() << std::endl;
+    }
+
+    // asking for the last released shape again should find it without building a new one
+    info.setSphere(1.0f + (float)(numShapes - 1));
+    btCollisionShape* shape = shapeManager.getShape(info);
+    if (shape != shapes[numShapes - 1] || shapeManager.getNumHits() != 1) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected to reuse the last released shape" << std::endl;
+    }
+    if (shapeManager.getNumUnreferencedShapes() != numKept - 1) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected a reused shape to no longer be garbage" << std::endl;
+    }
+
+    // an explicit collection deletes every unreferenced shape but leaves the referenced one alone
+    shapeManager.collectGarbage();
+    if (shapeManager.getNumShapes() != 1 || shapeManager.getNumUnreferencedShapes() != 0) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected one shape after garbage collection but found "
+            << shapeManager.getNumShapes() << std::endl;
+    }
+    if (shapeManager.getNumReferences(info) != 1) {
+        std::cout << __FILE__ << ":" << __LINE__ << " ERROR: expected the reused shape to survive garbage collection"
+            << std::endl;
+    }
+}
+
 void ShapeManagerTests::addBoxShape() {
     ShapeInfo info;
     glm::vec3 halfExtents(1.23f, 4.56f, 7.89f);
@@ -252,6 +306,7 @@ void ShapeManagerTests::addCapsuleShape() {
 void ShapeManagerTests::runAllTests() {
     testShapeAccounting();
     addManyShapes();
+    testUnreferencedShapeCache();
     addBoxShape();
     addSphereShape();
     addCylinderShape();
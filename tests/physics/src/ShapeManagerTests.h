@@ -15,6 +15,7 @@
 namespace ShapeManagerTests {
     void testShapeAccounting();
     void addManyShapes();
+    void testUnreferencedShapeCache();
     void addBoxShape();
     void addSphereShape();
     void addCylinderShape();
@@ -0,0 +1,74 @@
+//
+//  GLMHelpersTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "GLMHelpersTests.h"
+
+#include "GLMHelpers.h"
+#include "SharedUtil.h"
+
+// the worst error we accept in any component of a quat sent as six bytes
+const float SIX_BYTE_QUAT_TOLERANCE = 1.0e-4f;
+
+static glm::quat randomQuat() {
+    glm::quat quat(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f),
+                   randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f));
+    return glm::normalize(quat);
+}
+
+void GLMHelpersTests::sixByteQuatTest() {
+    const int NUM_QUATS = 10000;
+
+    QVector<glm::quat> quats;
+    quats.append(glm::quat());
+    quats.append(glm::quat(-1.0f, 0.0f, 0.0f, 0.0f));
+    quats.append(glm::quat(0.0f, 0.0f, 0.0f, 1.0f));
+    quats.append(glm::normalize(glm::quat(0.5f, -0.5f, 0.5f, -0.5f)));
+    for (int i = 0; i < NUM_QUATS; i++) {
+        quats.append(randomQuat());
+    }
+
+    int numFailures = 0;
+    foreach (const glm::quat& quat, quats) {
+        unsigned char buffer[SMALLEST_THREE_QUAT_BYTES];
+        if (packOrientationQuatToSixBytes(buffer, quat) != SMALLEST_THREE_QUAT_BYTES) {
+            numFailures++;
+            continue;
+        }
+
+        glm::quat unpacked;
+        if (unpackOrientationQuatFromSixBytes(buffer, unpacked) != SMALLEST_THREE_QUAT_BYTES) {
+            numFailures++;
+            continue;
+        }
+
+        // q and -q are the same rotation, so compare against whichever the unpacked quat is closest to
+        glm::quat expected = (glm::dot(quat, unpacked) < 0.0f) ? -quat : quat;
+        if (fabsf(expected.x - unpacked.x) > SIX_BYTE_QUAT_TOLERANCE
+                || fabsf(expected.y - unpacked.y) > SIX_BYTE_QUAT_TOLERANCE
+                || fabsf(expected.z - unpacked.z) > SIX_BYTE_QUAT_TOLERANCE
+                || fabsf(expected.w - unpacked.w) > SIX_BYTE_QUAT_TOLERANCE) {
+            if (numFailures == 0) {
+                qDebug() << "sixByteQuatTest: packed" << quat.x << quat.y << quat.z << quat.w
+                    << "came back as" << unpacked.x << unpacked.y << unpacked.z << unpacked.w;
+            }
+            numFailures++;
+        }
+    }
+
+    if (numFailures == 0) {
+        qDebug() << "sixByteQuatTest passed";
+    } else {
+        qDebug() << "sixByteQuatTest FAILED for" << numFailures << "of" << quats.size() << "quats";
+    }
+}
+
+void GLMHelpersTests::runAllTests() {
+    sixByteQuatTest();
+}